@@ -0,0 +1,56 @@
+#pragma once
+
+#include <hex/providers/provider.hpp>
+
+#include <hex/helpers/file.hpp>
+
+#include <filesystem>
+
+namespace hex::cli {
+
+    /* Read-only view of a single input file. Every worker creates its own ones so they never get shared between threads */
+    class InputProvider : public prv::Provider {
+    public:
+        explicit InputProvider(const std::string &path) : Provider(), m_path(path), m_file(path, File::Mode::Read) {
+            if (this->m_file.isValid())
+                this->m_fileSize = this->m_file.getSize();
+        }
+        ~InputProvider() override = default;
+
+        [[nodiscard]] bool isAvailable() const override { return this->m_file.isValid(); }
+        [[nodiscard]] bool isReadable() const override { return this->m_file.isValid(); }
+        [[nodiscard]] bool isWritable() const override { return false; }
+        [[nodiscard]] bool isResizable() const override { return false; }
+        [[nodiscard]] bool isSavable() const override { return false; }
+
+        [[nodiscard]] std::string getName() const override {
+            return std::filesystem::path(this->m_path).filename().string();
+        }
+
+        [[nodiscard]] std::vector<std::pair<std::string, std::string>> getDataInformation() const override {
+            return { };
+        }
+
+        void readRaw(u64 offset, void *buffer, size_t size) override {
+            offset -= this->getBaseAddress();
+
+            if ((offset + size) > this->getActualSize() || buffer == nullptr || size == 0)
+                return;
+
+            this->m_file.seek(offset);
+            this->m_file.readBuffer(static_cast<u8*>(buffer), size);
+        }
+
+        void writeRaw(u64 offset, const void *buffer, size_t size) override { }
+
+        [[nodiscard]] size_t getActualSize() const override {
+            return this->m_fileSize;
+        }
+
+    private:
+        std::string m_path;
+        File m_file;
+        size_t m_fileSize = 0;
+    };
+
+}
@@ -0,0 +1,385 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <hex/helpers/file.hpp>
+#include <hex/helpers/fmt.hpp>
+#include <hex/helpers/logger.hpp>
+#include <hex/pattern_language/pattern_language.hpp>
+#include <hex/pattern_language/pattern_data.hpp>
+#include <hex/pattern_language/pattern_exporter.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include "input_provider.hpp"
+
+namespace hex::plugin::builtin { void registerPatternLanguageFunctions(); }
+
+using namespace hex;
+using namespace hex::cli;
+
+namespace {
+
+    constexpr static int ExitEvaluationFailed = 1;
+    constexpr static int ExitInvalidUsage = 2;
+
+    enum class OutputFormat {
+        JSON,
+        CSV
+    };
+
+    struct Options {
+        std::string patternPath;
+        std::vector<std::string> inputPaths;
+        std::optional<std::string> outputPath;
+        OutputFormat format = OutputFormat::JSON;
+        size_t threadCount = 0;
+        std::optional<pl::PatternExporter::Format> exportFormat;
+        std::optional<std::string> exportDirectory;
+    };
+
+    struct PatternSummary {
+        std::string name;
+        std::string typeName;
+        u64 offset;
+        size_t size;
+    };
+
+    struct EvaluationResult {
+        std::string path;
+        bool success;
+        std::optional<std::pair<u32, std::string>> error;
+        std::vector<std::pair<pl::LogConsole::Level, std::string>> log;
+        std::vector<PatternSummary> patterns;
+    };
+
+    void printUsage() {
+        hex::log::info("Usage: pattern_runner [options] <pattern file> <input files...>");
+        hex::log::info("  -f, --format <json|csv>  Format the results are written in. Defaults to json");
+        hex::log::info("  -o, --output <path>      File to write the results to instead of stdout");
+        hex::log::info("  -j, --threads <count>    Number of files evaluated at the same time. Defaults to the number of cores");
+        hex::log::info("  -e, --export <json|csv|binary>");
+        hex::log::info("                           Also export the values of all patterns to <input file>.json, .csv or .bin");
+        hex::log::info("  --export-dir <path>      Directory exported files are placed in instead of next to their input file");
+    }
+
+    std::optional<Options> parseArguments(int argc, char **argv) {
+        Options options;
+        std::vector<std::string> positional;
+
+        for (int i = 1; i < argc; i++) {
+            std::string argument = argv[i];
+
+            auto nextValue = [&]() -> std::optional<std::string> {
+                if (i + 1 >= argc) {
+                    hex::log::fatal("Missing value for option {}", argument);
+                    return std::nullopt;
+                }
+
+                return argv[++i];
+            };
+
+            if (argument == "-f" || argument == "--format") {
+                auto value = nextValue();
+                if (!value.has_value())
+                    return std::nullopt;
+
+                if (*value == "json")
+                    options.format = OutputFormat::JSON;
+                else if (*value == "csv")
+                    options.format = OutputFormat::CSV;
+                else {
+                    hex::log::fatal("Unknown output format {}", *value);
+                    return std::nullopt;
+                }
+            } else if (argument == "-o" || argument == "--output") {
+                options.outputPath = nextValue();
+                if (!options.outputPath.has_value())
+                    return std::nullopt;
+            } else if (argument == "-j" || argument == "--threads") {
+                auto value = nextValue();
+                if (!value.has_value())
+                    return std::nullopt;
+
+                options.threadCount = std::strtoull(value->c_str(), nullptr, 0);
+                if (options.threadCount == 0) {
+                    hex::log::fatal("Invalid thread count {}", *value);
+                    return std::nullopt;
+                }
+            } else if (argument == "-e" || argument == "--export") {
+                auto value = nextValue();
+                if (!value.has_value())
+                    return std::nullopt;
+
+                if (*value == "json")
+                    options.exportFormat = pl::PatternExporter::Format::JSON;
+                else if (*value == "csv")
+                    options.exportFormat = pl::PatternExporter::Format::CSV;
+                else if (*value == "binary")
+                    options.exportFormat = pl::PatternExporter::Format::Binary;
+                else {
+                    hex::log::fatal("Unknown export format {}", *value);
+                    return std::nullopt;
+                }
+            } else if (argument == "--export-dir") {
+                options.exportDirectory = nextValue();
+                if (!options.exportDirectory.has_value())
+                    return std::nullopt;
+            } else if (argument.starts_with("-") && argument.size() > 1) {
+                hex::log::fatal("Unknown option {}", argument);
+                return std::nullopt;
+            } else {
+                positional.push_back(std::move(argument));
+            }
+        }
+
+        if (positional.size() < 2) {
+            hex::log::fatal("A pattern file and at least one input file are required");
+            return std::nullopt;
+        }
+
+        if (options.exportDirectory.has_value() && !options.exportFormat.has_value()) {
+            hex::log::fatal("--export-dir requires an export format");
+            return std::nullopt;
+        }
+
+        options.patternPath = positional.front();
+        options.inputPaths.assign(positional.begin() + 1, positional.end());
+
+        return options;
+    }
+
+    std::string getExportPath(const Options &options, const std::string &inputPath) {
+        std::filesystem::path path = inputPath;
+        if (options.exportDirectory.has_value())
+            path = std::filesystem::path(*options.exportDirectory) / path.filename();
+
+        return hex::format("{}.{}", path.string(), pl::PatternExporter::getFileExtension(*options.exportFormat));
+    }
+
+    EvaluationResult evaluate(pl::PatternLanguage &runtime, const Options &options, const std::string &sourceCode, const std::string &path) {
+        EvaluationResult result = { path, false, std::nullopt, { }, { } };
+
+        // Opening a file that doesn't exist would create it
+        if (!std::filesystem::is_regular_file(path)) {
+            result.error = { 0, "input file does not exist" };
+            return result;
+        }
+
+        InputProvider provider(path);
+        if (!provider.isReadable()) {
+            result.error = { 0, "failed to open input file" };
+            return result;
+        }
+
+        auto patterns = runtime.executeString(&provider, sourceCode);
+        result.log = runtime.getConsoleLog();
+
+        if (!patterns.has_value()) {
+            result.error = runtime.getError();
+
+            // Errors that didn't come with a line number only end up in the console
+            if (!result.error.has_value() || result.error->second.empty()) {
+                auto lastError = std::find_if(result.log.rbegin(), result.log.rend(), [](const auto &entry) {
+                    return entry.first == pl::LogConsole::Level::Error;
+                });
+
+                result.error = { 0, lastError != result.log.rend() ? lastError->second : "evaluation failed" };
+            }
+
+            return result;
+        }
+
+        result.success = true;
+
+        // Every worker has its own provider so the pattern's base address can simply be applied to it
+        if (auto baseAddress = runtime.getBaseAddress(); baseAddress.has_value())
+            provider.setBaseAddress(*baseAddress);
+
+        // Patterns have to be exported before they're gone, lazy arrays still need the runtime to decode their entries
+        if (options.exportFormat.has_value()) {
+            auto exportPath = getExportPath(options, path);
+
+            pl::PatternExporter exporter(&provider, *options.exportFormat);
+            if (!exporter.exportToFile(*patterns, exportPath)) {
+                result.success = false;
+                result.error = { 0, hex::format("failed to export patterns to {}", exportPath) };
+            }
+        }
+
+        for (auto &pattern : *patterns) {
+            if (!pattern->isHidden())
+                result.patterns.push_back({ pattern->getVariableName(), pattern->getTypeName(), pattern->getOffset(), pattern->getSize() });
+
+            delete pattern;
+        }
+
+        return result;
+    }
+
+    std::string toJSON(const EvaluationResult &result) {
+        nlohmann::json json = {
+            { "file",       result.path },
+            { "success",    result.success },
+            { "error",      nullptr },
+            { "log",        nlohmann::json::array() },
+            { "patterns",   nlohmann::json::array() }
+        };
+
+        if (result.error.has_value())
+            json["error"] = { { "line", result.error->first }, { "message", result.error->second } };
+
+        for (const auto &[level, message] : result.log)
+            json["log"].push_back({ { "level", static_cast<u32>(level) }, { "message", message } });
+
+        for (const auto &pattern : result.patterns)
+            json["patterns"].push_back({ { "name", pattern.name }, { "type", pattern.typeName }, { "offset", pattern.offset }, { "size", pattern.size } });
+
+        return json.dump();
+    }
+
+    std::string escapeCSV(const std::string &value) {
+        if (value.find_first_of(",\"\r\n") == std::string::npos)
+            return value;
+
+        std::string result = "\"";
+        for (char c : value) {
+            if (c == '"')
+                result += '"';
+            result += c;
+        }
+        result += '"';
+
+        return result;
+    }
+
+    std::string toCSV(const EvaluationResult &result) {
+        const auto file = escapeCSV(result.path);
+
+        if (!result.success) {
+            auto message = result.error->first != 0 ? hex::format("{}: {}", result.error->first, result.error->second) : result.error->second;
+            return hex::format("{},error,,,,,{}\n", file, escapeCSV(message));
+        }
+
+        // Files that were evaluated successfully still get a row, even if they didn't produce any patterns
+        if (result.patterns.empty())
+            return hex::format("{},ok,,,,,\n", file);
+
+        std::string rows;
+        for (const auto &pattern : result.patterns)
+            rows += hex::format("{},ok,{},{},0x{:X},{},\n", file, escapeCSV(pattern.name), escapeCSV(pattern.typeName), pattern.offset, pattern.size);
+
+        return rows;
+    }
+
+    int run(const Options &options) {
+        if (!std::filesystem::is_regular_file(options.patternPath)) {
+            hex::log::fatal("Pattern file {} does not exist", options.patternPath);
+            return ExitInvalidUsage;
+        }
+
+        File patternFile(options.patternPath, File::Mode::Read);
+        if (!patternFile.isValid()) {
+            hex::log::fatal("Failed to open pattern file {}", options.patternPath);
+            return ExitInvalidUsage;
+        }
+
+        const auto sourceCode = patternFile.readString();
+
+        std::optional<File> outputFile;
+        std::FILE *output = stdout;
+        if (options.outputPath.has_value()) {
+            outputFile.emplace(*options.outputPath, File::Mode::Create);
+            if (!outputFile->isValid()) {
+                hex::log::fatal("Failed to create output file {}", *options.outputPath);
+                return ExitInvalidUsage;
+            }
+
+            output = outputFile->getHandle();
+        }
+
+        const auto fileCount = options.inputPaths.size();
+
+        // Results are written in the order the files were passed in. Each one is dropped as soon as it's been written
+        // so only the ones that got finished ahead of an earlier file are held in memory
+        std::vector<std::optional<std::string>> outputs(fileCount);
+        std::mutex outputMutex;
+        std::condition_variable outputReady;
+
+        std::atomic<size_t> nextFile = 0;
+        std::atomic<bool> failed = false;
+        auto worker = [&] {
+            // Every thread gets its own runtime, they don't share any state while evaluating
+            pl::PatternLanguage runtime;
+
+            for (size_t i = nextFile++; i < fileCount; i = nextFile++) {
+                auto result = evaluate(runtime, options, sourceCode, options.inputPaths[i]);
+                if (!result.success)
+                    failed = true;
+
+                auto text = options.format == OutputFormat::JSON ? toJSON(result) : toCSV(result);
+
+                {
+                    std::scoped_lock lock(outputMutex);
+                    outputs[i] = std::move(text);
+                }
+                outputReady.notify_one();
+            }
+        };
+
+        const size_t threadCount = std::clamp<size_t>(options.threadCount != 0 ? options.threadCount : std::thread::hardware_concurrency(), 1, fileCount);
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < threadCount; i++)
+            threads.emplace_back(worker);
+
+        if (options.format == OutputFormat::JSON)
+            fmt::print(output, "[\n");
+        else
+            fmt::print(output, "file,status,name,type,offset,size,message\n");
+
+        for (size_t i = 0; i < fileCount; i++) {
+            std::string text;
+            {
+                std::unique_lock lock(outputMutex);
+                outputReady.wait(lock, [&] { return outputs[i].has_value(); });
+
+                text = std::move(*outputs[i]);
+                outputs[i].reset();
+            }
+
+            if (options.format == OutputFormat::JSON)
+                fmt::print(output, "    {}{}\n", text, i + 1 < fileCount ? "," : "");
+            else
+                fmt::print(output, "{}", text);
+        }
+
+        if (options.format == OutputFormat::JSON)
+            fmt::print(output, "]\n");
+
+        for (auto &thread : threads)
+            thread.join();
+
+        return failed ? ExitEvaluationFailed : EXIT_SUCCESS;
+    }
+
+}
+
+int main(int argc, char **argv) {
+    auto options = parseArguments(argc, argv);
+    if (!options.has_value()) {
+        printUsage();
+        return ExitInvalidUsage;
+    }
+
+    hex::plugin::builtin::registerPatternLanguageFunctions();
+
+    return run(*options);
+}
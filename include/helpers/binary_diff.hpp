@@ -0,0 +1,108 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <vector>
+
+namespace hex {
+
+    namespace prv { class Provider; }
+
+    enum class DiffType : u8 {
+        Match,
+        Change,
+        Insertion,
+        Deletion
+    };
+
+    /* Sequential reader that keeps a window of the provider's data buffered */
+    class ProviderReader {
+    public:
+        explicit ProviderReader(prv::Provider *provider);
+
+        [[nodiscard]] u64 getSize() const { return this->m_size; }
+
+        u8 at(u64 offset) {
+            if (offset < this->m_bufferStart || offset >= this->m_bufferStart + this->m_buffer.size())
+                this->fill(offset - std::min<u64>(offset, BufferSize / 4));
+
+            return this->m_buffer[offset - this->m_bufferStart];
+        }
+
+        /* Returned pointer stays valid until the next call to at() or read() */
+        const u8* read(u64 offset, size_t size) {
+            if (offset < this->m_bufferStart || offset + size > this->m_bufferStart + this->m_buffer.size())
+                this->fill(offset);
+
+            return this->m_buffer.data() + (offset - this->m_bufferStart);
+        }
+
+        constexpr static size_t BufferSize = 0x10'0000;
+
+    private:
+        void fill(u64 offset);
+
+        prv::Provider *m_provider;
+        u64 m_size;
+
+        std::vector<u8> m_buffer;
+        u64 m_bufferStart = 0;
+    };
+
+    /* Hash table of all equally sized blocks of a provider that's used to find their data again somewhere else. */
+    /* Block hashes are polynomial hashes so they can be rolled over the other data byte by byte                  */
+    class BlockIndex {
+    public:
+        BlockIndex(prv::Provider *provider, const std::atomic<bool> &cancelled);
+
+        [[nodiscard]] size_t getBlockSize() const { return this->m_blockSize; }
+
+        /* Returns the offset of the first block with the given hash */
+        [[nodiscard]] std::optional<u64> find(u64 hash) const;
+
+        [[nodiscard]] u64 hash(const u8 *data) const;
+        [[nodiscard]] u64 roll(u64 hash, u8 removedByte, u8 addedByte) const;
+
+    private:
+        void insert(u64 hash, u32 blockIndex);
+
+        struct Slot {
+            u32 tag;
+            u32 blockIndex;
+        };
+
+        size_t m_blockSize;
+        u64 m_multiplierPower = 1;
+
+        std::vector<Slot> m_slots;
+        u64 m_mask = 0;
+    };
+
+    /* Returns the index of the first byte that differs between both buffers or size if they're equal */
+    size_t findMismatch(const u8 *dataA, const u8 *dataB, size_t size);
+
+    /* A single entry of an edit script that turns the data of provider A into the one of provider B */
+    /* Matches and changes cover bytes of both providers, insertions only exist in B and deletions only in A */
+    struct DiffEdit {
+        DiffType type;
+        u64 offsetA, sizeA;
+        u64 offsetB, sizeB;
+    };
+
+    using EditScript = std::vector<DiffEdit>;
+
+    /* Overview of an edit script. Positions are aligned ones, meaning a change covers max(sizeA, sizeB) positions */
+    struct DifferenceMap {
+        std::vector<size_t> differences;    // Indices of all edits in the script that aren't matches
+        std::vector<float> density;         // Fraction of differing positions in each of the equally sized blocks
+
+        u64 changedBytes = 0, insertedBytes = 0, deletedBytes = 0;
+    };
+
+    std::optional<EditScript> generateEditScript(prv::Provider *providerA, prv::Provider *providerB, const std::atomic<bool> &cancelled, std::atomic<float> &progress);
+    DifferenceMap generateDifferenceMap(const EditScript &script, size_t blockCount);
+
+}
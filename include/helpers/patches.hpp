@@ -2,16 +2,26 @@
 
 #include <hex.hpp>
 
+#include <atomic>
 #include <map>
 #include <vector>
 
 namespace hex {
 
+    namespace prv { class Provider; }
+
     using Patches = std::map<u64, u8>;
 
     std::vector<u8> generateIPSPatch(const Patches &patches);
     std::vector<u8> generateIPS32Patch(const Patches &patches);
 
+    /* Delta patches either describe the given patches, relative to the start of the provider's data, or turn the */
+    /* data of source into the one of target. Both can be cancelled, nothing gets returned in that case            */
+    std::vector<u8> generateBPSPatch(prv::Provider *provider, const Patches &patches, const std::atomic<bool> &cancelled);
+    std::vector<u8> generateBPSPatch(prv::Provider *source, prv::Provider *target, const std::atomic<bool> &cancelled);
+    std::vector<u8> generateVCDIFFPatch(prv::Provider *provider, const Patches &patches, const std::atomic<bool> &cancelled);
+    std::vector<u8> generateVCDIFFPatch(prv::Provider *source, prv::Provider *target, const std::atomic<bool> &cancelled);
+
     Patches loadIPSPatch(const std::vector<u8> &ipsPatch);
     Patches loadIPS32Patch(const std::vector<u8> &ipsPatch);
 }
\ No newline at end of file
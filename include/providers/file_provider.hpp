@@ -31,6 +31,8 @@ namespace hex::prv {
         void write(u64 offset, const void *buffer, size_t size) override;
         void resize(ssize_t newSize) override;
 
+        void readUnpaged(u64 offset, void *buffer, size_t size, bool withPatches) override;
+
         void readRaw(u64 offset, void *buffer, size_t size) override;
         void writeRaw(u64 offset, const void *buffer, size_t size) override;
         size_t getActualSize() const override;
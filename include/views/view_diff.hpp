@@ -5,8 +5,14 @@
 #include <imgui.h>
 #include <hex/views/view.hpp>
 
+#include "helpers/binary_diff.hpp"
+
 #include <array>
+#include <atomic>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace hex {
@@ -19,12 +25,41 @@ namespace hex {
         ~ViewDiff() override;
 
         void drawContent() override;
+        void drawAlwaysVisible() override;
         void drawMenu() override;
+        bool handleShortcut(bool keys[512], bool ctrl, bool shift, bool alt) override;
 
     private:
         void drawDiffLine(const std::array<int, 2> &providerIds, u64 row) const;
+        void drawMinimap(const ImVec2 &size);
+        void startDiff();
+        void setEditScript(EditScript &&editScript);
+        void jumpToDifference(bool forward);
+        void exportPatch(bool vcdiff);
+        void stopWorkers();
 
         int m_providerA = -1, m_providerB = -1;
+        std::array<int, 2> m_diffedProviders = { -1, -1 };
+        bool m_shouldRediff = false;
+
+        std::thread m_diffThread;
+        std::atomic<bool> m_diffRunning = false, m_diffCancelled = false;
+        std::atomic<float> m_diffProgress = 0.0F;
+
+        std::thread m_exportThread;
+        std::atomic<bool> m_exportRunning = false, m_exportCancelled = false, m_exportFailed = false;
+
+        std::mutex m_diffResultMutex;
+        std::optional<EditScript> m_diffResult;
+
+        EditScript m_editScript;
+        std::vector<u64> m_alignedOffsets;
+        u64 m_alignedSize = 0;
+
+        DifferenceMap m_differenceMap;
+        std::optional<size_t> m_currDifference;
+        std::optional<u64> m_scrollToRow;
+        u64 m_visibleRowStart = 0, m_visibleRowEnd = 0;
 
         bool m_greyedOutZeros = true;
         bool m_upperCaseHex = true;
@@ -21,8 +21,9 @@ namespace hex {
         int m_currHashFunction = 0;
         u64 m_hashRegion[2] = { 0 };
         bool m_shouldMatchSelection = false;
+        int m_compareProvider = -1;
 
-        static constexpr const char* HashFunctionNames[] = { "CRC16", "CRC32", "MD5", "SHA-1", "SHA-224", "SHA-256", "SHA-384", "SHA-512" };
+        static constexpr const char* HashFunctionNames[] = { "CRC16", "CRC32", "MD5", "SHA-1", "SHA-224", "SHA-256", "SHA-384", "SHA-512", "XXH3-64", "XXH3-128", "BLAKE3", "ssdeep" };
     };
 
 }
\ No newline at end of file
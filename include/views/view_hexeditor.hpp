@@ -5,14 +5,17 @@
 
 #include <imgui_memory_editor.h>
 
+#include <atomic>
 #include <list>
 #include <tuple>
 #include <random>
+#include <thread>
 #include <vector>
 
 namespace hex {
 
     namespace prv { class Provider; }
+    namespace pl { struct HighlightedRange; }
 
     using SearchFunction = std::vector<std::pair<u64, u64>> (*)(prv::Provider* &provider, std::string string);
 
@@ -29,7 +32,9 @@ namespace hex {
     private:
         MemoryEditor m_memoryEditor;
 
-        std::map<u64, u32> m_highlightedBytes;
+        /* Sorted, non-overlapping ranges highlighted by the current patterns */
+        std::vector<pl::HighlightedRange> m_highlightedRanges;
+        size_t m_lastHighlightedRange = 0;
 
         std::vector<char> m_searchStringBuffer;
         std::vector<char> m_searchHexBuffer;
@@ -47,6 +52,10 @@ namespace hex {
 
         std::vector<u8> m_dataToSave;
 
+        std::thread m_patchExportThread;
+        prv::Provider *m_patchExportProvider = nullptr;
+        std::atomic<bool> m_patchExportRunning = false, m_patchExportCancelled = false, m_patchExportFailed = false;
+
         std::string m_loaderScriptScriptPath;
         std::string m_loaderScriptFilePath;
 
@@ -57,8 +66,14 @@ namespace hex {
         void drawGotoPopup();
         void drawEditPopup();
 
+        void updateHighlightedRanges();
+        std::optional<u32> getHighlightColor(u64 address);
+
         bool createFile(const std::string &path);
         void openFile(const std::string &path);
+        void exportPatch(bool vcdiff);
+        void stopPatchExport();
+
         bool saveToFile(const std::string &path, const std::vector<u8>& data);
         bool loadFromFile(const std::string &path, std::vector<u8>& data);
 
@@ -4,7 +4,14 @@
 
 #include <imgui.h>
 #include <hex/views/view.hpp>
+#include <hex/pattern_language/pattern_data.hpp>
+#include <hex/pattern_language/pattern_exporter.hpp>
 
+#include <atomic>
+#include <optional>
+#include <set>
+#include <thread>
+#include <utility>
 #include <vector>
 #include <tuple>
 #include <cstdio>
@@ -20,10 +27,63 @@ namespace hex {
         ~ViewPatternData() override;
 
         void drawContent() override;
+        void drawAlwaysVisible() override;
         void drawMenu() override;
 
     private:
+        /* Range of m_childRows holding the rows directly below a row. Sorted ones are ordered by offset without overlapping */
+        struct Children {
+            u64 first = 0, count = 0;
+            bool sorted = false;
+        };
+
+        /* Either a single pattern or a run of consecutive array entries that aren't expanded. Expanded entries keep their */
+        /* index in firstEntry                                                                                             */
+        struct Row {
+            pl::PatternData *pattern;
+            u64 id;
+            u32 depth;
+            u64 firstEntry, entryCount;
+            u64 firstRow;
+            u64 subtreeEnd;
+            Children children = { };
+
+            [[nodiscard]] u64 getRowCount() const { return this->entryCount == 0 ? 1 : this->entryCount; }
+        };
+
+        bool beginPatternDataTable(prv::Provider* &provider, const std::vector<pl::PatternData*> &patterns);
+
+        void buildRows();
+        void addRows(pl::PatternData *pattern, u64 id, u32 depth, std::vector<u64> &siblings);
+        void addChildRows(pl::PatternData *pattern, u64 id, u32 depth, std::vector<u64> &children);
+        void addEntryRows(pl::PatternData *array, u64 id, u32 depth, u64 firstEntry, u64 entryCount, std::vector<u64> &siblings);
+        Children storeChildren(pl::PatternData *parent, const std::vector<u64> &children);
+
+        void drawRow(prv::Provider *provider, const Row &row, u64 rowOffset);
+        [[nodiscard]] std::optional<u64> findRow(u64 offset) const;
+
+        void exportPatternData(pl::PatternExporter::Format format, const std::vector<nfdfilteritem_t> &validExtensions);
+        void stopExport();
+
         std::vector<pl::PatternData*> m_sortedPatternData;
+        pl::PatternData::SortState m_sortState;
+
+        std::vector<Row> m_rows;
+        std::vector<u64> m_childRows;
+        Children m_topLevelRows;
+        u64 m_rowCount = 0;
+        bool m_rowsDirty = true;
+
+        std::set<u64> m_expandedPatterns;
+        std::set<std::pair<u64, u64>> m_expandedEntries;
+        ImGuiStorage m_rowStorage;
+
+        std::optional<u64> m_jumpOffset;
+
+        /* The export thread works on its own copy of the patterns as they get deleted whenever the pattern is evaluated again */
+        std::thread m_exportThread;
+        prv::Provider *m_exportProvider = nullptr;
+        std::atomic<bool> m_exportRunning = false, m_exportCancelled = false, m_exportFailed = false;
     };
 
-}
\ No newline at end of file
+}
@@ -5,8 +5,12 @@
 #include <hex/pattern_language/log_console.hpp>
 #include <hex/providers/provider.hpp>
 
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
 #include <filesystem>
+#include <mutex>
+#include <optional>
 #include <string_view>
 #include <thread>
 #include <vector>
@@ -25,6 +29,20 @@ namespace hex {
         void drawContent() override;
 
     private:
+        /* Outcome of evaluating the pattern on one of the open providers while running it on all of them. The runtime is */
+        /* set while a worker is evaluating the pattern on the provider                                                   */
+        struct ProviderResult {
+            prv::Provider *provider;
+            u64 providerId;
+            std::string name;
+            pl::PatternLanguage *runtime = nullptr;
+            bool done = false;
+            bool success = false;
+            u64 patternCount = 0;
+            std::optional<std::pair<u32, std::string>> error;
+            std::optional<std::string> warning;
+        };
+
         pl::PatternLanguage *m_patternLanguageRuntime;
         std::vector<std::string> m_possiblePatternFiles;
         int m_selectedPatternFile = 0;
@@ -35,9 +53,21 @@ namespace hex {
         TextEditor m_textEditor;
         std::vector<std::pair<pl::LogConsole::Level, std::string>> m_console;
 
+        std::thread m_runOnAllProvidersThread;
+        std::vector<ProviderResult> m_providerResults;
+        std::mutex m_providerResultsMutex;
+        std::condition_variable m_providerResultsChanged;
+        std::atomic<bool> m_runningOnAllProviders = false;
+        std::atomic<bool> m_abortRunOnAllProviders = false;
+        bool m_providerResultsOpen = false;
+
         void loadPatternFile(const std::string &path);
         void clearPatternData();
         void parsePattern(char *buffer);
+
+        void runOnAllProviders(const std::string &code);
+        void abortProviderRuns();
+        void drawProviderResults();
     };
 
 }
\ No newline at end of file
@@ -97,7 +97,7 @@ namespace hex::plugin::builtin {
 
             /* base_address() */
             ContentRegistry::PatternLanguageFunctions::add(nsStdMem, "base_address", ContentRegistry::PatternLanguageFunctions::NoParameters, [](Evaluator *ctx, auto params) -> std::optional<Token::Literal> {
-                return u128(ctx->getProvider()->getBaseAddress());
+                return u128(ctx->getDataBaseAddress());
             });
 
             /* size() */
@@ -122,7 +122,7 @@ namespace hex::plugin::builtin {
                 std::vector<u8> bytes(sequence.size(), 0x00);
                 u32 occurrences = 0;
                 for (u64 offset = 0; offset < ctx->getProvider()->getSize() - sequence.size(); offset++) {
-                    ctx->getProvider()->read(offset, bytes.data(), bytes.size());
+                    ctx->readData(offset, bytes.data(), bytes.size());
 
                     if (bytes == sequence) {
                         if (occurrences < occurrenceIndex) {
@@ -146,7 +146,7 @@ namespace hex::plugin::builtin {
                     LogConsole::abortEvaluation("read size out of range");
 
                 u128 result = 0;
-                ctx->getProvider()->read(address, &result, size);
+                ctx->readData(address, &result, size);
 
                 return result;
             });
@@ -160,7 +160,7 @@ namespace hex::plugin::builtin {
                     LogConsole::abortEvaluation("read size out of range");
 
                 s128 value;
-                ctx->getProvider()->read(address, &value, size);
+                ctx->readData(address, &value, size);
                 return hex::signExtend(size * 8, value);
             });
 
@@ -170,7 +170,7 @@ namespace hex::plugin::builtin {
                 auto size = Token::literalToUnsigned(params[1]);
 
                 std::string result(size, '\x00');
-                ctx->getProvider()->read(address, result.data(), size);
+                ctx->readData(address, result.data(), size);
 
                 return result;
             });
@@ -142,6 +142,8 @@ namespace hex::plugin::builtin {
                     { "hex.view.hashes.iv", "Startwert" },
                     { "hex.view.hashes.poly", "Polynomial" },
                     { "hex.view.hashes.result", "Resultat" },
+                    { "hex.view.hashes.compare", "Vergleichen mit" },
+                    { "hex.view.hashes.similarity", "Ähnlichkeit" },
 
                 { "hex.view.help.name", "Hilfe" },
                     { "hex.view.help.about.name", "Über ImHex" },
@@ -195,6 +197,8 @@ namespace hex::plugin::builtin {
                         { "hex.view.hexeditor.menu.file.export.title", "Datei exportieren" },
                         { "hex.view.hexeditor.menu.file.export.ips", "IPS Patch" },
                         { "hex.view.hexeditor.menu.file.export.ips32", "IPS32 Patch" },
+                        { "hex.view.hexeditor.menu.file.export.bps", "BPS Patch" },
+                        { "hex.view.hexeditor.menu.file.export.vcdiff", "VCDIFF Patch" },
                     { "hex.view.hexeditor.menu.file.search", "Suchen" },
                         { "hex.view.hexeditor.search.string", "String" },
                         { "hex.view.hexeditor.search.hex", "Hex" },
@@ -209,6 +213,7 @@ namespace hex::plugin::builtin {
                     { "hex.view.hexeditor.error.read_only", "Schreibzugriff konnte nicht erlangt werden. Datei wurde im Lesemodus geöffnet." },
                     { "hex.view.hexeditor.error.open", "Öffnen der Datei fehlgeschlagen!" },
                     { "hex.view.hexeditor.error.create", "Erstellen der neuen Datei fehlgeschlagen!" },
+                    { "hex.view.hexeditor.error.export_patch", "Exportieren des Patches fehlgeschlagen!" },
                     { "hex.view.hexeditor.menu.edit.undo", "Rückgängig" },
                     { "hex.view.hexeditor.menu.edit.redo", "Wiederholen" },
                     { "hex.view.hexeditor.menu.edit.copy", "Kopieren" },
@@ -261,6 +266,16 @@ namespace hex::plugin::builtin {
                 { "hex.view.pattern.open_pattern", "Pattern öffnen" },
                 { "hex.view.pattern.evaluating", "Evaluieren..." },
                 { "hex.view.pattern.auto", "Auto evaluieren" },
+                { "hex.view.pattern.abort", "Abbrechen" },
+                { "hex.view.pattern.all_providers.run", "Auf allen offenen Dateien ausführen" },
+                { "hex.view.pattern.all_providers.name", "Resultate aller offenen Dateien" },
+                { "hex.view.pattern.all_providers.file", "Datei" },
+                { "hex.view.pattern.all_providers.result", "Resultat" },
+                { "hex.view.pattern.all_providers.patterns", "Patterns" },
+                { "hex.view.pattern.all_providers.message", "Nachricht" },
+                { "hex.view.pattern.all_providers.pending", "Ausstehend" },
+                { "hex.view.pattern.all_providers.success", "OK" },
+                { "hex.view.pattern.all_providers.error", "Fehler" },
 
                 { "hex.view.pattern_data.name", "Pattern Daten" },
                     { "hex.view.pattern_data.name", "Name" },
@@ -269,6 +284,12 @@ namespace hex::plugin::builtin {
                     { "hex.view.pattern_data.size", "Grösse" },
                     { "hex.view.pattern_data.type", "Typ" },
                     { "hex.view.pattern_data.value", "Wert" },
+                    { "hex.view.pattern_data.menu.file.export", "Exportieren..." },
+                    { "hex.view.pattern_data.menu.file.export.title", "Patterns exportieren" },
+                    { "hex.view.pattern_data.menu.file.export.json", "JSON" },
+                    { "hex.view.pattern_data.menu.file.export.csv", "CSV" },
+                    { "hex.view.pattern_data.menu.file.export.binary", "Binär" },
+                    { "hex.view.pattern_data.error.export", "Exportieren der Patterns fehlgeschlagen!" },
 
                 { "hex.view.settings.name", "Einstellungen" },
 
@@ -318,6 +339,12 @@ namespace hex::plugin::builtin {
                     { "hex.view.store.tab.constants", "Konstanten" },
                     { "hex.view.store.loading", "Store inhalt wird geladen..." },
                 { "hex.view.diff.name", "Diffing" },
+                    { "hex.view.diff.diffing", "Vergleiche... {:.0f}%" },
+                    { "hex.view.diff.difference", "Unterschied {} / {}" },
+                    { "hex.view.diff.no_differences", "Keine Unterschiede" },
+                    { "hex.view.diff.summary", "{} geänderte, {} eingefügte, {} gelöschte Bytes" },
+                    { "hex.view.diff.export", "Patch exportieren..." },
+                    { "hex.view.diff.exporting", "Exportiere Patch..." },
 
             /* Builtin plugin features */
 
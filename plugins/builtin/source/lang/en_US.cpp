@@ -142,6 +142,8 @@ namespace hex::plugin::builtin {
                     { "hex.view.hashes.iv", "Initial value" },
                     { "hex.view.hashes.poly", "Polynomial" },
                     { "hex.view.hashes.result", "Result" },
+                    { "hex.view.hashes.compare", "Compare with" },
+                    { "hex.view.hashes.similarity", "Similarity" },
 
                 { "hex.view.help.name", "Help" },
                     { "hex.view.help.about.name", "About" },
@@ -195,6 +197,8 @@ namespace hex::plugin::builtin {
                         { "hex.view.hexeditor.menu.file.export.title", "Export File" },
                         { "hex.view.hexeditor.menu.file.export.ips", "IPS Patch" },
                         { "hex.view.hexeditor.menu.file.export.ips32", "IPS32 Patch" },
+                        { "hex.view.hexeditor.menu.file.export.bps", "BPS Patch" },
+                        { "hex.view.hexeditor.menu.file.export.vcdiff", "VCDIFF Patch" },
                     { "hex.view.hexeditor.menu.file.search", "Search" },
                         { "hex.view.hexeditor.search.string", "String" },
                         { "hex.view.hexeditor.search.hex", "Hex" },
@@ -209,6 +213,7 @@ namespace hex::plugin::builtin {
                     { "hex.view.hexeditor.error.read_only", "Couldn't get write access. File opened in read-only mode." },
                     { "hex.view.hexeditor.error.open", "Failed to open file!" },
                     { "hex.view.hexeditor.error.create", "Failed to create new file!" },
+                    { "hex.view.hexeditor.error.export_patch", "Failed to export patch!" },
                     { "hex.view.hexeditor.menu.edit.undo", "Undo" },
                     { "hex.view.hexeditor.menu.edit.redo", "Redo" },
                     { "hex.view.hexeditor.menu.edit.copy", "Copy" },
@@ -261,6 +266,16 @@ namespace hex::plugin::builtin {
                 { "hex.view.pattern.open_pattern", "Open pattern" },
                 { "hex.view.pattern.evaluating", "Evaluating..." },
                 { "hex.view.pattern.auto", "Auto evaluate" },
+                { "hex.view.pattern.abort", "Abort" },
+                { "hex.view.pattern.all_providers.run", "Run on all open files" },
+                { "hex.view.pattern.all_providers.name", "Results on all open files" },
+                { "hex.view.pattern.all_providers.file", "File" },
+                { "hex.view.pattern.all_providers.result", "Result" },
+                { "hex.view.pattern.all_providers.patterns", "Patterns" },
+                { "hex.view.pattern.all_providers.message", "Message" },
+                { "hex.view.pattern.all_providers.pending", "Pending" },
+                { "hex.view.pattern.all_providers.success", "OK" },
+                { "hex.view.pattern.all_providers.error", "Error" },
 
                 { "hex.view.pattern_data.name", "Pattern Data" },
                     { "hex.view.pattern_data.name", "Name" },
@@ -269,6 +284,12 @@ namespace hex::plugin::builtin {
                     { "hex.view.pattern_data.size", "Size" },
                     { "hex.view.pattern_data.type", "Type" },
                     { "hex.view.pattern_data.value", "Value" },
+                    { "hex.view.pattern_data.menu.file.export", "Export..." },
+                    { "hex.view.pattern_data.menu.file.export.title", "Export patterns" },
+                    { "hex.view.pattern_data.menu.file.export.json", "JSON" },
+                    { "hex.view.pattern_data.menu.file.export.csv", "CSV" },
+                    { "hex.view.pattern_data.menu.file.export.binary", "Binary" },
+                    { "hex.view.pattern_data.error.export", "Failed to export patterns!" },
 
                 { "hex.view.settings.name", "Settings" },
 
@@ -318,6 +339,12 @@ namespace hex::plugin::builtin {
                     { "hex.view.store.tab.constants", "Constants" },
                     { "hex.view.store.loading", "Loading store content..." },
                 { "hex.view.diff.name", "Diffing" },
+                    { "hex.view.diff.diffing", "Diffing... {:.0f}%" },
+                    { "hex.view.diff.difference", "Difference {} / {}" },
+                    { "hex.view.diff.no_differences", "No differences" },
+                    { "hex.view.diff.summary", "{} changed, {} inserted, {} deleted bytes" },
+                    { "hex.view.diff.export", "Export patch..." },
+                    { "hex.view.diff.exporting", "Exporting patch..." },
 
 
             /* Builtin plugin features */
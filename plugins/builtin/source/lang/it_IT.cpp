@@ -142,6 +142,8 @@ namespace hex::plugin::builtin {
                     { "hex.view.hashes.iv", "Valore Iniziale" },
                     { "hex.view.hashes.poly", "Polinomio" },
                     { "hex.view.hashes.result", "Risultato" },
+                    //{ "hex.view.hashes.compare", "Compare with" },
+                    //{ "hex.view.hashes.similarity", "Similarity" },
 
                 { "hex.view.help.name", "Aiuto" },
                     { "hex.view.help.about.name", "Riguardo ImHex" },
@@ -195,6 +197,8 @@ namespace hex::plugin::builtin {
                         { "hex.view.hexeditor.menu.file.export.title", "Esporta File" },
                         { "hex.view.hexeditor.menu.file.export.ips", "IPS Patch" },
                         { "hex.view.hexeditor.menu.file.export.ips32", "IPS32 Patch" },
+                        { "hex.view.hexeditor.menu.file.export.bps", "BPS Patch" },
+                        { "hex.view.hexeditor.menu.file.export.vcdiff", "VCDIFF Patch" },
                     { "hex.view.hexeditor.menu.file.search", "Cerca" },
                         { "hex.view.hexeditor.search.string", "Stringa" },
                         { "hex.view.hexeditor.search.hex", "Hex" },
@@ -209,6 +213,7 @@ namespace hex::plugin::builtin {
                     { "hex.view.hexeditor.error.read_only", "Impossibile scrivere sul File. File aperto solo in modalità lettura" },
                     { "hex.view.hexeditor.error.open", "Impossibile aprire il File!" },
                     { "hex.view.hexeditor.error.create", "Impossibile creare il nuovo File!" },
+                    { "hex.view.hexeditor.error.export_patch", "Impossibile esportare la patch!" },
                     { "hex.view.hexeditor.menu.edit.undo", "Annulla" },
                     { "hex.view.hexeditor.menu.edit.redo", "Ripeti" },
                     { "hex.view.hexeditor.menu.edit.copy", "Copia" },
@@ -261,6 +266,16 @@ namespace hex::plugin::builtin {
                 { "hex.view.pattern.open_pattern", "Apri pattern" },
                 { "hex.view.pattern.evaluating", "Valutazione..." },
                 { "hex.view.pattern.auto", "Auto valutazione" },
+                { "hex.view.pattern.abort", "Interrompi" },
+                { "hex.view.pattern.all_providers.run", "Esegui su tutti i file aperti" },
+                { "hex.view.pattern.all_providers.name", "Risultati su tutti i file aperti" },
+                { "hex.view.pattern.all_providers.file", "File" },
+                { "hex.view.pattern.all_providers.result", "Risultato" },
+                { "hex.view.pattern.all_providers.patterns", "Pattern" },
+                { "hex.view.pattern.all_providers.message", "Messaggio" },
+                { "hex.view.pattern.all_providers.pending", "In attesa" },
+                { "hex.view.pattern.all_providers.success", "OK" },
+                { "hex.view.pattern.all_providers.error", "Errore" },
 
                 { "hex.view.pattern_data.name", "Dati dei Pattern" },
                     { "hex.view.pattern_data.name", "Nome" },
@@ -269,6 +284,12 @@ namespace hex::plugin::builtin {
                     { "hex.view.pattern_data.size", "Dimensione" },
                     { "hex.view.pattern_data.type", "Tipo" },
                     { "hex.view.pattern_data.value", "Valore" },
+                    { "hex.view.pattern_data.menu.file.export", "Esporta..." },
+                    { "hex.view.pattern_data.menu.file.export.title", "Esporta i pattern" },
+                    { "hex.view.pattern_data.menu.file.export.json", "JSON" },
+                    { "hex.view.pattern_data.menu.file.export.csv", "CSV" },
+                    { "hex.view.pattern_data.menu.file.export.binary", "Binario" },
+                    { "hex.view.pattern_data.error.export", "Impossibile esportare i pattern!" },
 
                 { "hex.view.settings.name", "Impostazioni" },
 
@@ -317,6 +338,12 @@ namespace hex::plugin::builtin {
                     { "hex.view.store.tab.constants", "Costanti" },
                     { "hex.view.store.loading", "Caricamento del content store..." },
                 //{ "hex.view.diff.name", "Diffing" },
+                    //{ "hex.view.diff.diffing", "Diffing... {:.0f}%" },
+                    //{ "hex.view.diff.difference", "Difference {} / {}" },
+                    //{ "hex.view.diff.no_differences", "No differences" },
+                    //{ "hex.view.diff.summary", "{} changed, {} inserted, {} deleted bytes" },
+                    //{ "hex.view.diff.export", "Export patch..." },
+                    //{ "hex.view.diff.exporting", "Exporting patch..." },
 
             /* Builtin plugin features */
 
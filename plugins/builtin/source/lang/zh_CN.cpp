@@ -142,6 +142,8 @@ namespace hex::plugin::builtin {
                     { "hex.view.hashes.iv", "初始值" },
                     { "hex.view.hashes.poly", "多项式" },
                     { "hex.view.hashes.result", "结果" },
+                    //{ "hex.view.hashes.compare", "Compare with" },
+                    //{ "hex.view.hashes.similarity", "Similarity" },
 
                 { "hex.view.help.name", "帮助" },
                     { "hex.view.help.about.name", "关于" },
@@ -195,6 +197,8 @@ namespace hex::plugin::builtin {
                         { "hex.view.hexeditor.menu.file.export.title", "导出文件" },
                         { "hex.view.hexeditor.menu.file.export.ips", "IPS补丁" },
                         { "hex.view.hexeditor.menu.file.export.ips32", "IPS32补丁" },
+                        { "hex.view.hexeditor.menu.file.export.bps", "BPS补丁" },
+                        { "hex.view.hexeditor.menu.file.export.vcdiff", "VCDIFF补丁" },
                     { "hex.view.hexeditor.menu.file.search", "搜索" },
                         { "hex.view.hexeditor.search.string", "字符串" },
                         { "hex.view.hexeditor.search.hex", "Hex" },
@@ -209,6 +213,7 @@ namespace hex::plugin::builtin {
                     { "hex.view.hexeditor.error.read_only", "无法获得写权限，文件以只读方式打开。" },
                     { "hex.view.hexeditor.error.open", "打开文件失败！" },
                     { "hex.view.hexeditor.error.create", "创建新文件失败！" },
+                    { "hex.view.hexeditor.error.export_patch", "导出补丁失败！" },
                     { "hex.view.hexeditor.menu.edit.undo", "撤销" },
                     { "hex.view.hexeditor.menu.edit.redo", "重做" },
                     { "hex.view.hexeditor.menu.edit.copy", "复制" },
@@ -261,6 +266,16 @@ namespace hex::plugin::builtin {
                 { "hex.view.pattern.open_pattern", "打开模式" },
                 { "hex.view.pattern.evaluating", "计算中..." },
                 { "hex.view.pattern.auto", "自动计算" },
+                { "hex.view.pattern.abort", "中止" },
+                { "hex.view.pattern.all_providers.run", "在所有打开的文件上运行" },
+                { "hex.view.pattern.all_providers.name", "所有打开文件的结果" },
+                { "hex.view.pattern.all_providers.file", "文件" },
+                { "hex.view.pattern.all_providers.result", "结果" },
+                { "hex.view.pattern.all_providers.patterns", "模式" },
+                { "hex.view.pattern.all_providers.message", "消息" },
+                { "hex.view.pattern.all_providers.pending", "等待中" },
+                { "hex.view.pattern.all_providers.success", "成功" },
+                { "hex.view.pattern.all_providers.error", "错误" },
 
                 { "hex.view.pattern_data.name", "模式数据" },
                     { "hex.view.pattern_data.name", "名称" },
@@ -269,6 +284,12 @@ namespace hex::plugin::builtin {
                     { "hex.view.pattern_data.size", "大小" },
                     { "hex.view.pattern_data.type", "类型" },
                     { "hex.view.pattern_data.value", "值" },
+                    { "hex.view.pattern_data.menu.file.export", "导出..." },
+                    { "hex.view.pattern_data.menu.file.export.title", "导出模式" },
+                    { "hex.view.pattern_data.menu.file.export.json", "JSON" },
+                    { "hex.view.pattern_data.menu.file.export.csv", "CSV" },
+                    { "hex.view.pattern_data.menu.file.export.binary", "二进制" },
+                    { "hex.view.pattern_data.error.export", "导出模式失败！" },
 
                 { "hex.view.settings.name", "设置" },
 
@@ -318,6 +339,12 @@ namespace hex::plugin::builtin {
                     { "hex.view.store.tab.constants", "常量" },
                     { "hex.view.store.loading", "正在加载仓库内容..." },
                 //{ "hex.view.diff.name", "Diffing" },
+                    //{ "hex.view.diff.diffing", "Diffing... {:.0f}%" },
+                    //{ "hex.view.diff.difference", "Difference {} / {}" },
+                    //{ "hex.view.diff.no_differences", "No differences" },
+                    //{ "hex.view.diff.summary", "{} changed, {} inserted, {} deleted bytes" },
+                    //{ "hex.view.diff.export", "Export patch..." },
+                    //{ "hex.view.diff.exporting", "Exporting patch..." },
 
             /* Builtin plugin features */
 
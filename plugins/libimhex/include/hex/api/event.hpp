@@ -98,6 +98,7 @@ namespace hex {
     /* Default Events */
     EVENT_DEF(EventFileLoaded, std::string);
     EVENT_DEF(EventFileUnloaded);
+    EVENT_DEF(EventProviderDeleted, prv::Provider*);
     EVENT_DEF(EventDataChanged);
     EVENT_DEF(EventPatternChanged);
     EVENT_DEF(EventWindowClosing, GLFWwindow*);
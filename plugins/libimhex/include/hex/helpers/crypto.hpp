@@ -31,6 +31,19 @@ namespace hex::crypt {
     std::array<u8, 48> sha384(const std::vector<u8> &data);
     std::array<u8, 64> sha512(const std::vector<u8> &data);
 
+    u64 xxh3_64(prv::Provider* &data, u64 offset, size_t size);
+    std::array<u8, 16> xxh3_128(prv::Provider* &data, u64 offset, size_t size);
+    std::array<u8, 32> blake3(prv::Provider* &data, u64 offset, size_t size);
+
+    u64 xxh3_64(const std::vector<u8> &data);
+    std::array<u8, 16> xxh3_128(const std::vector<u8> &data);
+    std::array<u8, 32> blake3(const std::vector<u8> &data);
+
+    std::string ssdeep(prv::Provider* &data, u64 offset, size_t size);
+    std::string ssdeep(prv::Provider* &data);
+    std::string ssdeep(const std::vector<u8> &data);
+    std::optional<u8> ssdeepCompare(const std::string &lhs, const std::string &rhs);
+
     std::vector<u8> decode64(const std::vector<u8> &input);
     std::vector<u8> encode64(const std::vector<u8> &input);
     std::vector<u8> decode16(const std::string &input);
@@ -39,14 +39,15 @@ namespace hex {
         std::vector<u8> readBytes(size_t numBytes = 0);
         std::string readString(size_t numBytes = 0);
 
-        void write(const u8 *buffer, size_t size);
-        void write(const std::vector<u8> &bytes);
-        void write(const std::string &string);
+        /* Writing and flushing return whether everything made it into the file */
+        bool write(const u8 *buffer, size_t size);
+        bool write(const std::vector<u8> &bytes);
+        bool write(const std::string &string);
 
         [[nodiscard]] size_t getSize() const;
         void setSize(u64 size);
 
-        void flush();
+        bool flush();
         void remove();
 
         auto getHandle() { return this->m_file; }
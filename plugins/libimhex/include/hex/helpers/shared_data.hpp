@@ -64,7 +64,8 @@ namespace hex {
         static std::vector<View*> views;
         static std::vector<ContentRegistry::Tools::Entry> toolsEntries;
         static std::vector<ContentRegistry::DataInspector::Entry> dataInspectorEntries;
-        static u32 patternPaletteOffset;
+        // Every thread evaluating patterns hands out its own colors
+        static thread_local u32 patternPaletteOffset;
         static std::string popupMessage;
         static std::list<ImHexApi::Bookmarks::Entry> bookmarkEntries;
         static std::vector<pl::PatternData*> patternData;
@@ -4,6 +4,7 @@
 
 #include <hex/helpers/concepts.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <cctype>
@@ -12,6 +13,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
@@ -62,6 +64,47 @@ namespace hex {
         return (value ^ mask) - mask;
     }
 
+    constexpr inline void hashCombine(u64 &seed, u64 value) {
+        seed ^= value + 0x9E37'79B9'7F4A'7C15 + (seed << 6) + (seed >> 2);
+    }
+
+    /* Sorts evenly sized chunks of the range on all available threads and merges them afterwards. Small ranges are sorted right away */
+    template<std::random_access_iterator Iter, typename Compare>
+    void parallelSort(Iter begin, Iter end, Compare compare) {
+        constexpr static size_t MinChunkSize = 0x4000;
+
+        const size_t size = std::distance(begin, end);
+        const size_t chunkCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, std::max<size_t>(size / MinChunkSize, 1));
+        if (chunkCount == 1) {
+            std::sort(begin, end, compare);
+            return;
+        }
+
+        std::vector<Iter> bounds;
+        for (size_t i = 0; i <= chunkCount; i++)
+            bounds.push_back(begin + (size * i) / chunkCount);
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < chunkCount; i++)
+            threads.emplace_back([&, i] { std::sort(bounds[i], bounds[i + 1], compare); });
+
+        std::sort(bounds[0], bounds[1], compare);
+
+        for (auto &thread : threads)
+            thread.join();
+
+        // Neighbouring chunks are merged pairwise until only a single one is left
+        for (size_t step = 1; step < chunkCount; step *= 2) {
+            threads.clear();
+
+            for (size_t i = 0; i + step < chunkCount; i += step * 2)
+                threads.emplace_back([&, i, step] { std::inplace_merge(bounds[i], bounds[i + step], bounds[std::min(i + step * 2, chunkCount)], compare); });
+
+            for (auto &thread : threads)
+                thread.join();
+        }
+    }
+
     template<class... Ts> struct overloaded : Ts... { using Ts::operator()...; };
     template<class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
 
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <cstddef>
+
+namespace hex::pl {
+
+    /* Bump allocator for the many small AST nodes and patterns the pattern language creates. Freed memory is recycled  */
+    /* per size class, also when it's freed from another thread, and everything gets released at once when the arena is */
+    /* reset. Objects are allowed to outlive the arena that created them, its memory is only given back once the last   */
+    /* of them has been freed as well                                                                                   */
+    class Arena {
+        struct State;
+
+    public:
+        Arena();
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /* Releases all memory at once. If objects allocated from this arena are still alive, it starts over with fresh */
+        /* memory instead and the old one is given back once the last of those objects has been freed                   */
+        void reset();
+
+        /* Number of objects allocated from this arena that are still alive and the memory reserved for them */
+        [[nodiscard]] size_t getAllocationCount() const;
+        [[nodiscard]] size_t getMemoryUsage() const;
+
+        /* Allocates from the arena that's active on the calling thread or from the heap if there is none */
+        [[nodiscard]] static void* allocate(size_t size);
+        static void deallocate(void *pointer);
+
+        /* Makes an arena the active one of the calling thread for as long as the scope exists */
+        class Scope {
+        public:
+            explicit Scope(Arena &arena);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            State *m_previous;
+        };
+
+    private:
+        State *m_state;
+    };
+
+}
@@ -5,8 +5,10 @@
 #include <hex/pattern_language/pattern_data.hpp>
 
 #include <bit>
+#include <cstring>
 #include <optional>
 #include <map>
+#include <memory>
 #include <variant>
 #include <vector>
 
@@ -99,6 +101,58 @@ namespace hex::pl {
         }
 
     #undef FLOAT_BIT_OPERATION
+
+        [[nodiscard]] Token::Literal applyOperator(const auto &left, const auto &right) const {
+            switch (this->getOperator()) {
+                case Token::Operator::Plus:
+                    return left + right;
+                case Token::Operator::Minus:
+                    return left - right;
+                case Token::Operator::Star:
+                    return left * right;
+                case Token::Operator::Slash:
+                    if (right == 0) LogConsole::abortEvaluation("division by zero!", this);
+                    return left / right;
+                case Token::Operator::Percent:
+                    if (right == 0) LogConsole::abortEvaluation("division by zero!", this);
+                    return modulus(left, right);
+                case Token::Operator::ShiftLeft:
+                    return shiftLeft(left, right);
+                case Token::Operator::ShiftRight:
+                    return shiftRight(left, right);
+                case Token::Operator::BitAnd:
+                    return bitAnd(left, right);
+                case Token::Operator::BitXor:
+                    return bitXor(left, right);
+                case Token::Operator::BitOr:
+                    return bitOr(left, right);
+                case Token::Operator::BitNot:
+                    return bitNot(left, right);
+                case Token::Operator::BoolEquals:
+                    return left == right;
+                case Token::Operator::BoolNotEquals:
+                    return left != right;
+                case Token::Operator::BoolGreaterThan:
+                    return left > right;
+                case Token::Operator::BoolLessThan:
+                    return left < right;
+                case Token::Operator::BoolGreaterThanOrEquals:
+                    return left >= right;
+                case Token::Operator::BoolLessThanOrEquals:
+                    return left <= right;
+                case Token::Operator::BoolAnd:
+                    return left && right;
+                case Token::Operator::BoolXor:
+                    return left && !right || !left && right;
+                case Token::Operator::BoolOr:
+                    return left || right;
+                case Token::Operator::BoolNot:
+                    return !right;
+                default:
+                    LogConsole::abortEvaluation("invalid operand used in mathematical expression", this);
+            }
+        }
+
     public:
         ASTNodeMathematicalExpression(ASTNode *left, ASTNode *right, Token::Operator op)
                 : ASTNode(), m_left(left), m_right(right), m_operator(op) { }
@@ -119,113 +173,70 @@ namespace hex::pl {
         }
 
         [[nodiscard]] ASTNode* evaluate(Evaluator *evaluator) const override {
-            if (this->getLeftOperand() == nullptr || this->getRightOperand() == nullptr)
-                LogConsole::abortEvaluation("attempted to use void expression in mathematical expression", this);
+            return new ASTNodeLiteral(evaluator->evaluateExpression(this));
+        }
 
-            auto *left = dynamic_cast<ASTNodeLiteral*>(this->getLeftOperand()->evaluate(evaluator));
-            auto *right = dynamic_cast<ASTNodeLiteral*>(this->getRightOperand()->evaluate(evaluator));
-            ON_SCOPE_EXIT { delete left; delete right; };
+        /* Applies the operator to already evaluated operands */
+        [[nodiscard]] Token::Literal apply(const Token::Literal &left, const Token::Literal &right) const {
+            // Most operations happen between two integers of the same signedness, skip the generic dispatch for those
+            if (auto leftValue = std::get_if<u128>(&left), rightValue = std::get_if<u128>(&right); leftValue != nullptr && rightValue != nullptr)
+                return this->applyOperator(*leftValue, *rightValue);
+            else if (auto leftValue = std::get_if<s128>(&left), rightValue = std::get_if<s128>(&right); leftValue != nullptr && rightValue != nullptr)
+                return this->applyOperator(*leftValue, *rightValue);
 
             return std::visit(overloaded {
                 // TODO: :notlikethis:
-                [this](u128 left, PatternData * const &right) -> ASTNode*           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-                [this](s128 left, PatternData * const &right) -> ASTNode*           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-                [this](double left, PatternData * const &right) -> ASTNode*         { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-                [this](char left, PatternData * const &right) -> ASTNode*           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-                [this](bool left, PatternData * const &right) -> ASTNode*           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-                [this](std::string left, PatternData * const &right) -> ASTNode*    { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-                [this](PatternData * const &left, u128 right) -> ASTNode*           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-                [this](PatternData * const &left, s128 right) -> ASTNode*           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-                [this](PatternData * const &left, double right) -> ASTNode*         { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-                [this](PatternData * const &left, char right) -> ASTNode*           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-                [this](PatternData * const &left, bool right) -> ASTNode*           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-                [this](PatternData * const &left, std::string right) -> ASTNode*    { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-                [this](PatternData * const &left, PatternData *right) -> ASTNode*   { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-
-                [this](auto&& left, std::string right) -> ASTNode*          { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
-                [this](std::string left, auto&& right) -> ASTNode* {
+                [this](u128 left, PatternData * const &right) -> Token::Literal           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+                [this](s128 left, PatternData * const &right) -> Token::Literal           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+                [this](double left, PatternData * const &right) -> Token::Literal         { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+                [this](char left, PatternData * const &right) -> Token::Literal           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+                [this](bool left, PatternData * const &right) -> Token::Literal           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+                [this](std::string left, PatternData * const &right) -> Token::Literal    { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+                [this](PatternData * const &left, u128 right) -> Token::Literal           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+                [this](PatternData * const &left, s128 right) -> Token::Literal           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+                [this](PatternData * const &left, double right) -> Token::Literal         { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+                [this](PatternData * const &left, char right) -> Token::Literal           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+                [this](PatternData * const &left, bool right) -> Token::Literal           { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+                [this](PatternData * const &left, std::string right) -> Token::Literal    { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+                [this](PatternData * const &left, PatternData *right) -> Token::Literal   { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+
+                [this](auto&& left, std::string right) -> Token::Literal          { LogConsole::abortEvaluation("invalid operand used in mathematical expression", this); },
+                [this](std::string left, auto&& right) -> Token::Literal {
                     switch (this->getOperator()) {
                         case Token::Operator::Star: {
                             std::string result;
                             for (auto i = 0; i < right; i++)
                                 result += left;
-                            return new ASTNodeLiteral(result);
+                            return result;
                         }
                         default:
                             LogConsole::abortEvaluation("invalid operand used in mathematical expression", this);
                     }
                 },
-                [this](std::string left, std::string right) -> ASTNode* {
+                [this](std::string left, std::string right) -> Token::Literal {
                     switch (this->getOperator()) {
                         case Token::Operator::Plus:
-                            return new ASTNodeLiteral(left + right);
+                            return left + right;
                         case Token::Operator::BoolEquals:
-                            return new ASTNodeLiteral(left == right);
+                            return left == right;
                         case Token::Operator::BoolNotEquals:
-                            return new ASTNodeLiteral(left != right);
+                            return left != right;
                         case Token::Operator::BoolGreaterThan:
-                            return new ASTNodeLiteral(left > right);
+                            return left > right;
                         case Token::Operator::BoolLessThan:
-                            return new ASTNodeLiteral(left < right);
+                            return left < right;
                         case Token::Operator::BoolGreaterThanOrEquals:
-                            return new ASTNodeLiteral(left >= right);
+                            return left >= right;
                         case Token::Operator::BoolLessThanOrEquals:
-                            return new ASTNodeLiteral(left <= right);
+                            return left <= right;
                         default:
                             LogConsole::abortEvaluation("invalid operand used in mathematical expression", this);
                     }
                 },
-                [this](auto &&left, auto &&right) -> ASTNode* {
-                    switch (this->getOperator()) {
-                        case Token::Operator::Plus:
-                            return new ASTNodeLiteral(left + right);
-                        case Token::Operator::Minus:
-                            return new ASTNodeLiteral(left - right);
-                        case Token::Operator::Star:
-                            return new ASTNodeLiteral(left * right);
-                        case Token::Operator::Slash:
-                            if (right == 0) LogConsole::abortEvaluation("division by zero!", this);
-                            return new ASTNodeLiteral(left / right);
-                        case Token::Operator::Percent:
-                            if (right == 0) LogConsole::abortEvaluation("division by zero!", this);
-                            return new ASTNodeLiteral(modulus(left, right));
-                        case Token::Operator::ShiftLeft:
-                            return new ASTNodeLiteral(shiftLeft(left, right));
-                        case Token::Operator::ShiftRight:
-                            return new ASTNodeLiteral(shiftRight(left, right));
-                        case Token::Operator::BitAnd:
-                            return new ASTNodeLiteral(bitAnd(left, right));
-                        case Token::Operator::BitXor:
-                            return new ASTNodeLiteral(bitXor(left, right));
-                        case Token::Operator::BitOr:
-                            return new ASTNodeLiteral(bitOr(left, right));
-                        case Token::Operator::BitNot:
-                            return new ASTNodeLiteral(bitNot(left, right));
-                        case Token::Operator::BoolEquals:
-                            return new ASTNodeLiteral(left == right);
-                        case Token::Operator::BoolNotEquals:
-                            return new ASTNodeLiteral(left != right);
-                        case Token::Operator::BoolGreaterThan:
-                            return new ASTNodeLiteral(left > right);
-                        case Token::Operator::BoolLessThan:
-                            return new ASTNodeLiteral(left < right);
-                        case Token::Operator::BoolGreaterThanOrEquals:
-                            return new ASTNodeLiteral(left >= right);
-                        case Token::Operator::BoolLessThanOrEquals:
-                            return new ASTNodeLiteral(left <= right);
-                        case Token::Operator::BoolAnd:
-                            return new ASTNodeLiteral(left && right);
-                        case Token::Operator::BoolXor:
-                            return new ASTNodeLiteral(left && !right || !left && right);
-                        case Token::Operator::BoolOr:
-                            return new ASTNodeLiteral(left || right);
-                        case Token::Operator::BoolNot:
-                            return new ASTNodeLiteral(!right);
-                        default:
-                            LogConsole::abortEvaluation("invalid operand used in mathematical expression", this);
-                    }
+                [this](auto &&left, auto &&right) -> Token::Literal {
+                    return this->applyOperator(left, right);
                 }
-            }, left->getValue(), right->getValue());
+            }, left, right);
         }
 
         [[nodiscard]] ASTNode *getLeftOperand() const { return this->m_left; }
@@ -260,24 +271,21 @@ namespace hex::pl {
         }
 
         [[nodiscard]] ASTNode* evaluate(Evaluator *evaluator) const override {
-            if (this->getFirstOperand() == nullptr || this->getSecondOperand() == nullptr || this->getThirdOperand() == nullptr)
-                LogConsole::abortEvaluation("attempted to use void expression in mathematical expression", this);
-
-            auto *first = dynamic_cast<ASTNodeLiteral*>(this->getFirstOperand()->evaluate(evaluator));
-            auto *second = dynamic_cast<ASTNodeLiteral*>(this->getSecondOperand()->evaluate(evaluator));
-            auto *third = dynamic_cast<ASTNodeLiteral*>(this->getThirdOperand()->evaluate(evaluator));
-            ON_SCOPE_EXIT { delete first; delete second; delete third; };
+            return new ASTNodeLiteral(evaluator->evaluateExpression(this));
+        }
 
+        /* Selects one of the already evaluated operands */
+        [[nodiscard]] Token::Literal apply(const Token::Literal &first, const Token::Literal &second, const Token::Literal &third) const {
             auto condition = std::visit(overloaded {
                 [this](std::string value) -> bool { return !value.empty(); },
-                [this](PatternData * const &) -> bool { LogConsole::abortEvaluation("cannot cast custom type to bool", this); },
+                [this](PatternData*) -> bool { LogConsole::abortEvaluation("cannot cast custom type to bool", this); },
                 [](auto &&value) -> bool { return bool(value); }
-            }, first->getValue());
+            }, first);
 
             return std::visit(overloaded {
-                [condition]<typename T>(const T &second, const T &third) -> ASTNode* { return new ASTNodeLiteral(condition ? second : third); },
-                [this](auto &&second, auto &&third) -> ASTNode* { LogConsole::abortEvaluation("operands to ternary expression have different types", this); }
-            }, second->getValue(), third->getValue());
+                [condition]<typename T>(const T &second, const T &third) -> Token::Literal { return condition ? second : third; },
+                [this](auto &&second, auto &&third) -> Token::Literal { LogConsole::abortEvaluation("operands to ternary expression have different types", this); }
+            }, second, third);
         }
 
         [[nodiscard]] ASTNode *getFirstOperand() const { return this->m_first; }
@@ -348,6 +356,7 @@ namespace hex::pl {
             else
                 this->m_type = nullptr;
             this->m_endian = other.m_endian;
+            this->m_staticLayout = other.m_staticLayout;
         }
 
         ~ASTNodeTypeDecl() override {
@@ -363,6 +372,15 @@ namespace hex::pl {
         [[nodiscard]] ASTNode* getType() { return this->m_type; }
         [[nodiscard]] std::optional<std::endian> getEndian() const { return this->m_endian; }
 
+        /* Size and member offsets of a type that looks the same no matter what data it's placed on. Set by the validator */
+        struct StaticLayout {
+            u64 size;
+            std::vector<u64> memberOffsets;
+        };
+
+        void setStaticLayout(std::optional<StaticLayout> layout) { this->m_staticLayout = std::move(layout); }
+        [[nodiscard]] const std::optional<StaticLayout>& getStaticLayout() const { return this->m_staticLayout; }
+
         [[nodiscard]] ASTNode *evaluate(Evaluator *evaluator) const override {
             return this->m_type->evaluate(evaluator);
         }
@@ -383,6 +401,7 @@ namespace hex::pl {
         std::string m_name;
         ASTNode *m_type;
         std::optional<std::endian> m_endian;
+        std::optional<StaticLayout> m_staticLayout;
     };
 
     class ASTNodeCast : public ASTNode {
@@ -402,49 +421,63 @@ namespace hex::pl {
             return new ASTNodeCast(*this);
         }
 
+        [[nodiscard]] ASTNode* getValue() const { return this->m_value; }
+        [[nodiscard]] ASTNode* getType() const { return this->m_type; }
+
         [[nodiscard]] ASTNode* evaluate(Evaluator *evaluator) const override {
-            auto literal = dynamic_cast<ASTNodeLiteral*>(this->m_value->evaluate(evaluator));
-            auto type = dynamic_cast<ASTNodeBuiltinType*>(this->m_type->evaluate(evaluator))->getType();
+            return new ASTNodeLiteral(evaluator->evaluateExpression(this));
+        }
+
+        /* Casts the already evaluated value to the type of this node */
+        [[nodiscard]] Token::Literal cast(Evaluator *evaluator, const Token::Literal &literal) const {
+            auto typeNode = this->m_type->evaluate(evaluator);
+            ON_SCOPE_EXIT { delete typeNode; };
+
+            auto builtinType = dynamic_cast<ASTNodeBuiltinType*>(typeNode);
+            if (builtinType == nullptr)
+                LogConsole::abortEvaluation("cannot cast value to custom type", this);
+
+            auto type = builtinType->getType();
 
             auto typePattern = this->m_type->createPatterns(evaluator).front();
             ON_SCOPE_EXIT { delete typePattern; };
 
             return std::visit(overloaded {
-                    [&, this](PatternData * value) -> ASTNode* { LogConsole::abortEvaluation(hex::format("cannot cast custom type '{}' to '{}'", value->getTypeName(), Token::getTypeName(type)), this); },
-                    [&, this](const std::string&) -> ASTNode* { LogConsole::abortEvaluation(hex::format("cannot cast string to '{}'", Token::getTypeName(type)), this); },
-                    [&, this](auto &&value) -> ASTNode* {
+                    [&, this](PatternData * value) -> Token::Literal { LogConsole::abortEvaluation(hex::format("cannot cast custom type '{}' to '{}'", value->getTypeName(), Token::getTypeName(type)), this); },
+                    [&, this](const std::string&) -> Token::Literal { LogConsole::abortEvaluation(hex::format("cannot cast string to '{}'", Token::getTypeName(type)), this); },
+                    [&, this](auto &&value) -> Token::Literal {
                         auto endianAdjustedValue = hex::changeEndianess(value, typePattern->getSize(), typePattern->getEndian());
                         switch (type) {
                             case Token::ValueType::Unsigned8Bit:
-                                return new ASTNodeLiteral(u128(u8(endianAdjustedValue)));
+                                return u128(u8(endianAdjustedValue));
                             case Token::ValueType::Unsigned16Bit:
-                                return new ASTNodeLiteral(u128(u16(endianAdjustedValue)));
+                                return u128(u16(endianAdjustedValue));
                             case Token::ValueType::Unsigned32Bit:
-                                return new ASTNodeLiteral(u128(u32(endianAdjustedValue)));
+                                return u128(u32(endianAdjustedValue));
                             case Token::ValueType::Unsigned64Bit:
-                                return new ASTNodeLiteral(u128(u64(endianAdjustedValue)));
+                                return u128(u64(endianAdjustedValue));
                             case Token::ValueType::Unsigned128Bit:
-                                return new ASTNodeLiteral(u128(endianAdjustedValue));
+                                return u128(endianAdjustedValue);
                             case Token::ValueType::Signed8Bit:
-                                return new ASTNodeLiteral(s128(s8(endianAdjustedValue)));
+                                return s128(s8(endianAdjustedValue));
                             case Token::ValueType::Signed16Bit:
-                                return new ASTNodeLiteral(s128(s16(endianAdjustedValue)));
+                                return s128(s16(endianAdjustedValue));
                             case Token::ValueType::Signed32Bit:
-                                return new ASTNodeLiteral(s128(s32(endianAdjustedValue)));
+                                return s128(s32(endianAdjustedValue));
                             case Token::ValueType::Signed64Bit:
-                                return new ASTNodeLiteral(s128(s64(endianAdjustedValue)));
+                                return s128(s64(endianAdjustedValue));
                             case Token::ValueType::Signed128Bit:
-                                return new ASTNodeLiteral(s128(endianAdjustedValue));
+                                return s128(endianAdjustedValue);
                             case Token::ValueType::Float:
-                                return new ASTNodeLiteral(double(float(endianAdjustedValue)));
+                                return double(float(endianAdjustedValue));
                             case Token::ValueType::Double:
-                                return new ASTNodeLiteral(double(endianAdjustedValue));
+                                return double(endianAdjustedValue);
                             case Token::ValueType::Character:
-                                return new ASTNodeLiteral(char(endianAdjustedValue));
+                                return char(endianAdjustedValue);
                             case Token::ValueType::Character16:
-                                return new ASTNodeLiteral(u128(char16_t(endianAdjustedValue)));
+                                return u128(char16_t(endianAdjustedValue));
                             case Token::ValueType::Boolean:
-                                return new ASTNodeLiteral(bool(endianAdjustedValue));
+                                return bool(endianAdjustedValue);
                             case Token::ValueType::String:
                             {
                                 std::string string(sizeof(value), '\x00');
@@ -454,13 +487,13 @@ namespace hex::pl {
                                 if (typePattern->getEndian() != std::endian::native)
                                     std::reverse(string.begin(), string.end());
 
-                                return new ASTNodeLiteral(string);
+                                return string;
                             }
                             default:
                                 LogConsole::abortEvaluation(hex::format("cannot cast value to '{}'", Token::getTypeName(type)), this);
                         }
                     },
-            }, literal->getValue());
+            }, literal);
         }
 
     private:
@@ -499,6 +532,8 @@ namespace hex::pl {
         FunctionResult execute(Evaluator *evaluator) override {
 
             while (evaluateCondition(evaluator)) {
+                evaluator->handleAbort();
+
                 auto variables = *evaluator->getScope(0).scope;
                 u32 startVariableCount = variables.size();
                 ON_SCOPE_EXIT {
@@ -527,14 +562,11 @@ namespace hex::pl {
 
         [[nodiscard]]
         bool evaluateCondition(Evaluator *evaluator) const {
-            auto literal = dynamic_cast<ASTNodeLiteral*>(this->m_condition->evaluate(evaluator));
-            ON_SCOPE_EXIT { delete literal; };
-
             return std::visit(overloaded {
                     [](std::string value) -> bool { return !value.empty(); },
-                    [this](PatternData * const &) -> bool { LogConsole::abortEvaluation("cannot cast custom type to bool", this); },
+                    [this](PatternData*) -> bool { LogConsole::abortEvaluation("cannot cast custom type to bool", this); },
                     [](auto &&value) -> bool { return value != 0; }
-            }, literal->getValue());
+            }, evaluator->evaluateExpression(this->m_condition));
         }
 
     private:
@@ -571,11 +603,12 @@ namespace hex::pl {
             } else if (name == "hidden" && noValue()) {
                 pattern->setHidden(true);
             } else if (name == "format" && requiresValue()) {
-                auto functions = evaluator->getCustomFunctions();
-                if (!functions.contains(*value))
+                const auto &functions = evaluator->getCustomFunctions();
+                auto formatter = functions.find(*value);
+                if (formatter == functions.end())
                     LogConsole::abortEvaluation(hex::format("cannot find formatter function '{}'", *value), node);
 
-                const auto &function = functions[*value];
+                const auto &function = formatter->second;
                 if (function.parameterCount != 1)
                     LogConsole::abortEvaluation("formatter function needs exactly one parameter", node);
 
@@ -614,14 +647,11 @@ namespace hex::pl {
 
         [[nodiscard]] std::vector<PatternData*> createPatterns(Evaluator *evaluator) const override {
             if (this->m_placementOffset != nullptr) {
-                auto offset = dynamic_cast<ASTNodeLiteral *>(this->m_placementOffset->evaluate(evaluator));
-                ON_SCOPE_EXIT { delete offset; };
-
                 evaluator->dataOffset() = std::visit(overloaded {
                     [this](std::string) -> u64 { LogConsole::abortEvaluation("placement offset cannot be a string", this); },
-                    [this](PatternData * const &) -> u64 { LogConsole::abortEvaluation("placement offset cannot be a custom type", this); },
+                    [this](PatternData*) -> u64 { LogConsole::abortEvaluation("placement offset cannot be a custom type", this); },
                     [](auto &&offset) -> u64 { return offset; }
-                }, offset->getValue());
+                }, evaluator->evaluateExpression(this->m_placementOffset));
             }
 
             auto pattern = this->m_type->createPatterns(evaluator).front();
@@ -675,36 +705,18 @@ namespace hex::pl {
 
         [[nodiscard]] std::vector<PatternData*> createPatterns(Evaluator *evaluator) const override {
             if (this->m_placementOffset != nullptr) {
-                auto offset = dynamic_cast<ASTNodeLiteral*>(this->m_placementOffset->evaluate(evaluator));
-                ON_SCOPE_EXIT { delete offset; };
-
                 evaluator->dataOffset() = std::visit(overloaded {
                         [this](std::string) -> u64 { LogConsole::abortEvaluation("placement offset cannot be a string", this); },
-                        [this](PatternData * const &) -> u64 { LogConsole::abortEvaluation("placement offset cannot be a custom type", this); },
+                        [this](PatternData*) -> u64 { LogConsole::abortEvaluation("placement offset cannot be a custom type", this); },
                         [](auto &&offset) -> u64 { return offset; }
-                }, offset->getValue());
+                }, evaluator->evaluateExpression(this->m_placementOffset));
             }
 
-            auto type = this->m_type->evaluate(evaluator);
-            ON_SCOPE_EXIT { delete type; };
-
             PatternData *pattern;
-            if (dynamic_cast<ASTNodeBuiltinType*>(type))
+            if (this->isStaticType(evaluator))
                 pattern = createStaticArray(evaluator);
-            else if (auto attributable = dynamic_cast<Attributable*>(type)) {
-                auto &attributes = attributable->getAttributes();
-
-                bool isStaticType = std::any_of(attributes.begin(), attributes.end(), [](ASTNodeAttribute *attribute) {
-                    return attribute->getAttribute() == "static" && !attribute->getValue().has_value();
-                });
-
-                if (isStaticType)
-                    pattern = createStaticArray(evaluator);
-                else
-                    pattern = createDynamicArray(evaluator);
-            } else {
-                LogConsole::abortEvaluation("invalid type used in array", this);
-            }
+            else
+                pattern = createDynamicArray(evaluator);
 
             applyVariableAttributes(evaluator, this, pattern);
             return { pattern };
@@ -721,6 +733,71 @@ namespace hex::pl {
         ASTNode *m_size;
         ASTNode *m_placementOffset;
 
+        /* Entries of static types all look the same so only a single one of them needs to be created. Besides builtin types and */
+        /* ones marked as [[static]], that's the case for every type the validator found to not depend on the data it's placed on */
+        [[nodiscard]] bool isStaticType(Evaluator *evaluator) const {
+            if (auto typeDecl = dynamic_cast<ASTNodeTypeDecl*>(this->m_type); typeDecl != nullptr) {
+                if (const auto &layout = typeDecl->getStaticLayout(); layout.has_value() && layout->size > 0)
+                    return true;
+            }
+
+            auto type = this->m_type->evaluate(evaluator);
+            ON_SCOPE_EXIT { delete type; };
+
+            if (dynamic_cast<ASTNodeBuiltinType*>(type))
+                return true;
+            else if (auto attributable = dynamic_cast<Attributable*>(type)) {
+                auto &attributes = attributable->getAttributes();
+
+                return std::any_of(attributes.begin(), attributes.end(), [](ASTNodeAttribute *attribute) {
+                    return attribute->getAttribute() == "static" && !attribute->getValue().has_value();
+                });
+            } else {
+                LogConsole::abortEvaluation("invalid type used in array", this);
+            }
+        }
+
+        [[nodiscard]] u128 evaluateEntryCount(Evaluator *evaluator) const {
+            return std::visit(overloaded {
+                    [this](std::string) -> u128 { LogConsole::abortEvaluation("cannot use string to index array", this); },
+                    [this](PatternData*) -> u128 { LogConsole::abortEvaluation("cannot use custom type to index array", this); },
+                    [](auto &&size) -> u128 { return size; }
+            }, evaluator->evaluateExpression(this->m_size));
+        }
+
+        /* Index of the first entry that consists of nothing but zeros. Empty entries always count as such */
+        [[nodiscard]] static std::optional<u64> findZeroEntry(const u8 *buffer, u64 entryCount, u64 entrySize) {
+            if (entrySize == 0)
+                return 0;
+
+            if (entrySize == 1) {
+                if (auto zero = static_cast<const u8*>(std::memchr(buffer, 0x00, entryCount)); zero != nullptr)
+                    return zero - buffer;
+                else
+                    return std::nullopt;
+            }
+
+            for (u64 entry = 0; entry < entryCount; entry++) {
+                auto entryStart = buffer + entry * entrySize;
+
+                // Or-ing the entry together a word at a time instead of checking every byte on its own lets this be vectorized
+                u64 combined = 0;
+                u64 offset = 0;
+                for (; offset + sizeof(u64) <= entrySize; offset += sizeof(u64)) {
+                    u64 word;
+                    std::memcpy(&word, entryStart + offset, sizeof(u64));
+                    combined |= word;
+                }
+                for (; offset < entrySize; offset++)
+                    combined |= entryStart[offset];
+
+                if (combined == 0)
+                    return entry;
+            }
+
+            return std::nullopt;
+        }
+
         PatternData* createStaticArray(Evaluator *evaluator) const {
             u64 startOffset = evaluator->dataOffset();
 
@@ -732,41 +809,55 @@ namespace hex::pl {
             u128 entryCount = 0;
 
             if (this->m_size != nullptr) {
-                auto sizeNode = this->m_size->evaluate(evaluator);
-                ON_SCOPE_EXIT { delete sizeNode; };
-
-                if (auto literal = dynamic_cast<ASTNodeLiteral*>(sizeNode)) {
-                    entryCount = std::visit(overloaded {
-                            [this](std::string) -> u128  { LogConsole::abortEvaluation("cannot use string to index array", this); },
-                            [this](PatternData*) -> u128 { LogConsole::abortEvaluation("cannot use custom type to index array", this); },
-                            [](auto &&size) -> u128 { return size; }
-                    }, literal->getValue());
-                } else if (auto whileStatement = dynamic_cast<ASTNodeWhileStatement*>(sizeNode)) {
+                if (auto whileStatement = dynamic_cast<ASTNodeWhileStatement*>(this->m_size)) {
                     while (whileStatement->evaluateCondition(evaluator)) {
+                        evaluator->handleAbort();
+
+                        auto limit = evaluator->getArrayLimit();
+                        if (entryCount > limit)
+                            LogConsole::abortEvaluation(hex::format("array grew past set limit of {}", limit), this);
+
                         entryCount++;
                         evaluator->dataOffset() += templatePattern->getSize();
                     }
+                } else {
+                    entryCount = this->evaluateEntryCount(evaluator);
                 }
             } else {
-                std::vector<u8> buffer(templatePattern->getSize());
+                const u64 entrySize = templatePattern->getSize();
+                const u64 dataSize = evaluator->getProvider()->getActualSize();
+
+                // Instead of reading every entry on its own, the data is looked through in chunks of as many entries as fit into a cache block
+                std::vector<u8> buffer(entrySize == 0 ? 0 : std::max<u64>(prv::Provider::CacheBlockSize / entrySize, 1) * entrySize);
                 while (true) {
-                    if (evaluator->dataOffset() >= evaluator->getProvider()->getActualSize() - buffer.size())
-                        LogConsole::abortEvaluation("reached end of file before finding end of unsized array", this);
+                    evaluator->handleAbort();
 
-                    evaluator->getProvider()->read(evaluator->dataOffset(), buffer.data(), buffer.size());
-                    evaluator->dataOffset() += buffer.size();
+                    auto limit = evaluator->getArrayLimit();
+                    if (entryCount > limit)
+                        LogConsole::abortEvaluation(hex::format("array grew past set limit of {}", limit), this);
 
-                    entryCount++;
+                    if (evaluator->dataOffset() >= dataSize - entrySize)
+                        LogConsole::abortEvaluation("reached end of file before finding end of unsized array", this);
 
-                    bool reachedEnd = true;
-                    for (u8 &byte : buffer) {
-                        if (byte != 0x00) {
-                            reachedEnd = false;
-                            break;
-                        }
+                    // Only entries that start before the end of file check above would fail are part of the chunk
+                    u64 chunkEntryCount = 1;
+                    if (entrySize != 0) {
+                        const auto remainingEntryCount = (dataSize - entrySize - evaluator->dataOffset() + entrySize - 1) / entrySize;
+                        chunkEntryCount = std::min<u64>(remainingEntryCount, buffer.size() / entrySize);
                     }
 
-                    if (reachedEnd) break;
+                    evaluator->readData(evaluator->dataOffset(), buffer.data(), chunkEntryCount * entrySize);
+
+                    auto endEntry = findZeroEntry(buffer.data(), chunkEntryCount, entrySize);
+                    auto readEntryCount = endEntry.value_or(chunkEntryCount - 1) + 1;
+
+                    if (entryCount + readEntryCount - 1 > limit)
+                        LogConsole::abortEvaluation(hex::format("array grew past set limit of {}", limit), this);
+
+                    entryCount += readEntryCount;
+                    evaluator->dataOffset() += readEntryCount * entrySize;
+
+                    if (endEntry.has_value()) break;
                 }
             }
 
@@ -798,13 +889,79 @@ namespace hex::pl {
             auto arrayPattern = new PatternDataDynamicArray(evaluator->dataOffset(), 0);
             arrayPattern->setVariableName(this->m_name);
 
+            const auto entryEndian = arrayPattern->getEndian();
+            const auto entryColor = arrayPattern->getColor();
+
             std::vector<PatternData *> entries;
+            std::vector<u64> entryOffsets;
+            std::vector<u8> entryPaletteOffsets;
+            std::vector<HighlightedRange> entryHighlightedRanges;
             size_t size = 0;
             u64 entryCount = 0;
 
+            // Entries that don't access anything outside of themselves don't need to be kept around. Only their location
+            // is remembered and they get decoded again once they're needed. This is checked for every single entry as
+            // conditionals might make only some of them depend on their surroundings
+            bool lazy = true;
+            const auto scopeCount = evaluator->getScopeCount();
+            auto lowestAccessedScope = evaluator->lowestAccessedScope();
+            ON_SCOPE_EXIT { evaluator->lowestAccessedScope() = std::min(lowestAccessedScope, evaluator->lowestAccessedScope()); };
+
+            auto createEntry = [&]() -> PatternData* {
+                evaluator->handleAbort();
+
+                entryOffsets.push_back(evaluator->dataOffset());
+                entryPaletteOffsets.push_back(SharedData::patternPaletteOffset);
+
+                lowestAccessedScope = std::min(lowestAccessedScope, std::exchange(evaluator->lowestAccessedScope(), std::numeric_limits<u64>::max()));
+
+                auto pattern = this->m_type->createPatterns(evaluator).front();
+                pattern->setVariableName(hex::format("[{}]", entryCount));
+                pattern->setEndian(entryEndian);
+                pattern->setColor(entryColor);
+
+                if (lazy && evaluator->lowestAccessedScope() < scopeCount) {
+                    lazy = false;
+
+                    for (u64 i = 0; i < entryCount; i++) {
+                        auto entry = this->decodeEntry(evaluator, i, entryOffsets[i], entryPaletteOffsets[i], entryEndian, entryColor);
+                        if (entry == nullptr) {
+                            delete pattern;
+                            LogConsole::abortEvaluation("failed to decode array entry", this);
+                        }
+
+                        entries.push_back(entry);
+                    }
+                }
+
+                return pattern;
+            };
+
+            auto addEntry = [&](PatternData *pattern) {
+                size += pattern->getSize();
+                entryCount++;
+
+                if (lazy) {
+                    // Highlighting needs all entries at once, their ranges are kept so they don't have to be decoded again for it
+                    for (const auto &range : pattern->getHighlightedRanges()) {
+                        if (!entryHighlightedRanges.empty() && entryHighlightedRanges.back().end == range.start && entryHighlightedRanges.back().color == range.color)
+                            entryHighlightedRanges.back().end = range.end;
+                        else
+                            entryHighlightedRanges.push_back(range);
+                    }
+
+                    delete pattern;
+                } else {
+                    entries.push_back(pattern);
+                }
+            };
+
             if (this->m_size != nullptr) {
-                auto sizeNode = this->m_size->evaluate(evaluator);
-                ON_SCOPE_EXIT { delete sizeNode; };
+                auto whileStatement = dynamic_cast<ASTNodeWhileStatement*>(this->m_size);
+
+                // The size needs to be evaluated before the template pattern moves the current offset
+                if (whileStatement == nullptr)
+                    entryCount = this->evaluateEntryCount(evaluator);
 
                 {
                     auto templatePattern = this->m_type->createPatterns(evaluator).front();
@@ -814,42 +971,21 @@ namespace hex::pl {
                     evaluator->dataOffset() -= templatePattern->getSize();
                 }
 
-                if (auto literal = dynamic_cast<ASTNodeLiteral*>(sizeNode)) {
-                    entryCount = std::visit(overloaded{
-                            [this](std::string) -> u128  { LogConsole::abortEvaluation("cannot use string to index array", this); },
-                            [this](PatternData*) -> u128 { LogConsole::abortEvaluation("cannot use custom type to index array", this); },
-                            [](auto &&size) -> u128 { return size; }
-                    }, literal->getValue());
-
+                if (whileStatement == nullptr) {
                     auto limit = evaluator->getArrayLimit();
                     if (entryCount > limit)
                         LogConsole::abortEvaluation(hex::format("array grew past set limit of {}", limit), this);
 
-                    for (u64 i = 0; i < entryCount; i++) {
-                        auto pattern = this->m_type->createPatterns(evaluator).front();
-
-                        pattern->setVariableName(hex::format("[{}]", i));
-                        pattern->setEndian(arrayPattern->getEndian());
-                        pattern->setColor(arrayPattern->getColor());
-                        entries.push_back(pattern);
-
-                        size += pattern->getSize();
-                    }
-                } else if (auto whileStatement = dynamic_cast<ASTNodeWhileStatement*>(sizeNode)) {
+                    const auto totalEntryCount = std::exchange(entryCount, 0);
+                    while (entryCount < totalEntryCount)
+                        addEntry(createEntry());
+                } else {
                     while (whileStatement->evaluateCondition(evaluator)) {
                         auto limit = evaluator->getArrayLimit();
                         if (entryCount > limit)
                             LogConsole::abortEvaluation(hex::format("array grew past set limit of {}", limit), this);
 
-                        auto pattern = this->m_type->createPatterns(evaluator).front();
-
-                        pattern->setVariableName(hex::format("[{}]", entryCount));
-                        pattern->setEndian(arrayPattern->getEndian());
-                        pattern->setColor(arrayPattern->getColor());
-                        entries.push_back(pattern);
-
-                        entryCount++;
-                        size += pattern->getSize();
+                        addEntry(createEntry());
                     }
                 }
             } else {
@@ -858,7 +994,7 @@ namespace hex::pl {
                     if (entryCount > limit)
                         LogConsole::abortEvaluation(hex::format("array grew past set limit of {}", limit), this);
 
-                    auto pattern = this->m_type->createPatterns(evaluator).front();
+                    auto pattern = createEntry();
                     std::vector<u8> buffer(pattern->getSize());
 
                     if (evaluator->dataOffset() >= evaluator->getProvider()->getActualSize() - buffer.size()) {
@@ -866,15 +1002,9 @@ namespace hex::pl {
                         LogConsole::abortEvaluation("reached end of file before finding end of unsized array", this);
                     }
 
-                    pattern->setVariableName(hex::format("[{}]", entryCount));
-                    pattern->setEndian(arrayPattern->getEndian());
-                    pattern->setColor(arrayPattern->getColor());
-                    entries.push_back(pattern);
-
-                    size += pattern->getSize();
-                    entryCount++;
+                    addEntry(pattern);
 
-                    evaluator->getProvider()->read(evaluator->dataOffset() - pattern->getSize(), buffer.data(), buffer.size());
+                    evaluator->readData(evaluator->dataOffset() - buffer.size(), buffer.data(), buffer.size());
                     bool reachedEnd = true;
                     for (u8 &byte : buffer) {
                         if (byte != 0x00) {
@@ -887,11 +1017,55 @@ namespace hex::pl {
                 }
             }
 
-            arrayPattern->setEntries(entries);
+            if (lazy) {
+                // The ranges stay around as long as the array does
+                entryHighlightedRanges.shrink_to_fit();
+
+                arrayPattern->setLazyEntries(std::move(entryOffsets), std::move(entryPaletteOffsets), std::move(entryHighlightedRanges), [this, context = evaluator->getDecodingContext(), evaluationId = evaluator->getEvaluationId(), entryEndian, entryColor](u64 index, u64 offset, u32 paletteOffset) -> PatternData* {
+                    std::scoped_lock lock(context->mutex);
+
+                    // This node belongs to the AST of the evaluation that created the array, it's deleted once nothing refers to it anymore
+                    if (context->evaluator == nullptr || !context->decodableEvaluations.contains(evaluationId))
+                        return nullptr;
+
+                    return this->decodeEntry(context->evaluator, index, offset, paletteOffset, entryEndian, entryColor);
+                });
+            } else {
+                arrayPattern->setEntries(entries);
+            }
+
             arrayPattern->setSize(size);
 
             return arrayPattern;
         }
+
+        /* Decodes a single entry of a dynamic array again. Neither the current offset nor the colors of other patterns are affected */
+        PatternData* decodeEntry(Evaluator *evaluator, u64 index, u64 offset, u32 paletteOffset, std::endian endian, u32 color) const {
+            const auto previousOffset = evaluator->dataOffset();
+            const auto previousPaletteOffset = SharedData::patternPaletteOffset;
+            ON_SCOPE_EXIT {
+                evaluator->dataOffset() = previousOffset;
+                SharedData::patternPaletteOffset = previousPaletteOffset;
+            };
+
+            evaluator->dataOffset() = offset;
+            SharedData::patternPaletteOffset = paletteOffset;
+
+            PatternData *pattern;
+            try {
+                pattern = this->m_type->createPatterns(evaluator).front();
+            } catch (const LogConsole::EvaluateError&) {
+                return nullptr;
+            } catch (const std::string&) {
+                return nullptr;
+            }
+
+            pattern->setVariableName(hex::format("[{}]", index));
+            pattern->setEndian(endian);
+            pattern->setColor(color);
+
+            return pattern;
+        }
     };
 
     class ASTNodePointerVariableDecl : public ASTNode, public Attributable {
@@ -927,14 +1101,11 @@ namespace hex::pl {
 
         [[nodiscard]] std::vector<PatternData*> createPatterns(Evaluator *evaluator) const override {
             if (this->m_placementOffset != nullptr) {
-                auto offset = dynamic_cast<ASTNodeLiteral *>(this->m_placementOffset->evaluate(evaluator));
-                ON_SCOPE_EXIT { delete offset; };
-
                 evaluator->dataOffset() = std::visit(overloaded {
                         [this](std::string) -> u64 { LogConsole::abortEvaluation("placement offset cannot be a string", this); },
                         [this](PatternData*) -> u64 { LogConsole::abortEvaluation("placement offset cannot be a custom type", this); },
                         [](auto &&offset) -> u64   { return u64(offset); }
-                }, offset->getValue());
+                }, evaluator->evaluateExpression(this->m_placementOffset));
             }
 
             auto sizePattern = this->m_sizeType->createPatterns(evaluator).front();
@@ -1121,12 +1292,8 @@ namespace hex::pl {
             auto pattern = new PatternDataEnum(evaluator->dataOffset(), 0);
 
             std::vector<std::pair<Token::Literal, std::string>> enumEntries;
-            for (const auto &[name, value] : this->m_entries) {
-                auto literal = dynamic_cast<ASTNodeLiteral*>(value->evaluate(evaluator));
-                ON_SCOPE_EXIT { delete literal; };
-
-                enumEntries.emplace_back(literal->getValue(), name);
-            }
+            for (const auto &[name, value] : this->m_entries)
+                enumEntries.emplace_back(evaluator->evaluateExpression(value), name);
 
             pattern->setEnumValues(enumEntries);
 
@@ -1176,14 +1343,11 @@ namespace hex::pl {
             std::vector<PatternData*> fields;
             evaluator->pushScope(pattern, fields);
             for (auto [name, bitSizeNode] : this->m_entries) {
-                auto literal = bitSizeNode->evaluate(evaluator);
-                ON_SCOPE_EXIT { delete literal; };
-
                 u8 bitSize = std::visit(overloaded {
                         [this](std::string) -> u8 { LogConsole::abortEvaluation("bitfield field size cannot be a string", this); },
                         [this](PatternData*) -> u8 { LogConsole::abortEvaluation("bitfield field size cannot be a custom type", this); },
                         [](auto &&offset) -> u8 { return static_cast<u8>(offset); }
-                }, dynamic_cast<ASTNodeLiteral*>(literal)->getValue());
+                }, evaluator->evaluateExpression(bitSizeNode));
 
                 auto field = new PatternDataBitfieldField(evaluator->dataOffset(), bitOffset, bitSize);
                 field->setVariableName(name);
@@ -1209,7 +1373,7 @@ namespace hex::pl {
     public:
         using Path = std::vector<std::variant<std::string, ASTNode*>>;
 
-        explicit ASTNodeRValue(Path path) : ASTNode(), m_path(std::move(path)) { }
+        explicit ASTNodeRValue(Path path) : ASTNode(), m_path(std::move(path)), m_slots(this->m_path.size(), 0) { }
 
         ASTNodeRValue(const ASTNodeRValue&) = default;
 
@@ -1229,17 +1393,27 @@ namespace hex::pl {
             return this->m_path;
         }
 
+        [[nodiscard]] bool isPlaceholder() const {
+            if (this->getPath().size() != 1)
+                return false;
+
+            auto name = std::get_if<std::string>(&this->getPath().front());
+            return name != nullptr && *name == "$";
+        }
+
         [[nodiscard]] ASTNode* evaluate(Evaluator *evaluator) const override {
-            if (this->getPath().size() == 1) {
-                if (auto name = std::get_if<std::string>(&this->getPath().front()); name != nullptr) {
-                    if (*name == "$") return new ASTNodeLiteral(u128(evaluator->dataOffset()));
-                }
-            }
+            return new ASTNodeLiteral(evaluator->evaluateExpression(this));
+        }
 
-            auto pattern = this->createPatterns(evaluator).front();
-            ON_SCOPE_EXIT { delete pattern; };
+        /* Reads the current value of the variable this rvalue refers to */
+        [[nodiscard]] Token::Literal getValue(Evaluator *evaluator) const {
+            if (this->isPlaceholder())
+                return u128(evaluator->dataOffset());
 
-            auto readValue = [&evaluator](auto &value, PatternData *pattern) {
+            std::unique_ptr<PatternData> copy;
+            auto pattern = this->resolve(evaluator, copy);
+
+            auto readValue = [&evaluator, &pattern](auto &value) {
                 if (pattern->isLocal()) {
                     auto &literal = evaluator->getStack()[pattern->getOffset()];
 
@@ -1249,39 +1423,39 @@ namespace hex::pl {
                     }, literal);
                 }
                 else
-                    evaluator->getProvider()->read(pattern->getOffset(), &value, pattern->getSize());
+                    evaluator->readData(pattern->getOffset(), &value, pattern->getSize());
             };
 
             Token::Literal literal;
             if (dynamic_cast<PatternDataUnsigned*>(pattern)) {
                 u128 value = 0;
-                readValue(value, pattern);
+                readValue(value);
                 literal = value;
             } else if (dynamic_cast<PatternDataSigned*>(pattern)) {
                 s128 value = 0;
-                readValue(value, pattern);
+                readValue(value);
                 literal = value;
             } else if (dynamic_cast<PatternDataFloat*>(pattern)) {
                 if (pattern->getSize() == sizeof(u16)) {
                     u16 value = 0;
-                    readValue(value, pattern);
+                    readValue(value);
                     literal = double(float16ToFloat32(value));
                 } else if (pattern->getSize() == sizeof(float)) {
                     float value = 0;
-                    readValue(value, pattern);
+                    readValue(value);
                     literal = double(value);
                 } else if (pattern->getSize() == sizeof(double)) {
                     double value = 0;
-                    readValue(value, pattern);
+                    readValue(value);
                     literal = value;
                 } else LogConsole::abortEvaluation("invalid floating point type access", this);
             } else if (dynamic_cast<PatternDataCharacter*>(pattern)) {
                 char value = 0;
-                readValue(value, pattern);
+                readValue(value);
                 literal = value;
             } else if (dynamic_cast<PatternDataBoolean*>(pattern)) {
                 bool value = false;
-                readValue(value, pattern);
+                readValue(value);
                 literal = value;
             } else if (dynamic_cast<PatternDataString*>(pattern)) {
                 std::string value;
@@ -1295,118 +1469,147 @@ namespace hex::pl {
                     }, literal);
                 }
                 else
-                    evaluator->getProvider()->read(pattern->getOffset(), value.data(), pattern->getSize());
+                    evaluator->readData(pattern->getOffset(), value.data(), pattern->getSize());
 
                 literal = value;
             } else if (auto bitfieldFieldPattern = dynamic_cast<PatternDataBitfieldField*>(pattern)) {
                 u64 value = 0;
-                readValue(value, pattern);
+                readValue(value);
                 literal = u128(hex::extract(bitfieldFieldPattern->getBitOffset() + (bitfieldFieldPattern->getBitSize() - 1), bitfieldFieldPattern->getBitOffset(), value));
             } else {
                 literal = pattern->clone();
             }
 
-            return new ASTNodeLiteral(literal);
+            return literal;
         }
 
         [[nodiscard]] std::vector<PatternData*> createPatterns(Evaluator *evaluator) const override {
+            std::unique_ptr<PatternData> copy;
+            auto pattern = this->resolve(evaluator, copy);
+
+            if (pattern == nullptr)
+                return { nullptr };
+            else if (pattern == copy.get())
+                return { copy.release() };
+            else
+                return { pattern->clone() };
+        }
+
+    private:
+        /* Finds the pattern the path refers to. Patterns are only looked at, not copied. The exception are static array */
+        /* entries which don't exist as patterns of their own, these are created from the array's template into copy     */
+        PatternData* resolve(Evaluator *evaluator, std::unique_ptr<PatternData> &copy) const {
             s32 scopeIndex = 0;
 
-            auto searchScope = *evaluator->getScope(scopeIndex).scope;
+            const std::vector<PatternData*> *searchScope = evaluator->getScope(scopeIndex).scope;
+            std::vector<PatternData*> templateScope;
             PatternData *currPattern = nullptr;
 
-            for (const auto &part : this->getPath()) {
+            for (u32 part = 0; part < this->m_path.size(); part++) {
 
-                if (part.index() == 0) {
+                if (auto name = std::get_if<std::string>(&this->m_path[part]); name != nullptr) {
                     // Variable access
-                    auto name = std::get<std::string>(part);
-
-                    if (name == "parent") {
+                    if (*name == "parent") {
                         scopeIndex--;
-                        searchScope = *evaluator->getScope(scopeIndex).scope;
-                        currPattern = searchScope.front()->getParent();
-                    } else if (name == "this") {
-                        searchScope = *evaluator->getScope(scopeIndex).scope;
+                        searchScope = evaluator->getScope(scopeIndex).scope;
+                        if (searchScope == nullptr)
+                            LogConsole::abortEvaluation("invalid use of 'parent' outside of nested type", this);
+
+                        currPattern = searchScope->empty() ? nullptr : searchScope->front()->getParent();
+                    } else if (*name == "this") {
+                        searchScope = evaluator->getScope(scopeIndex).scope;
 
                         auto currParent = evaluator->getScope(0).parent;
 
                         if (currParent == nullptr)
                             LogConsole::abortEvaluation("invalid use of 'this' outside of struct-like type", this);
 
-                        currPattern = currParent->clone();
+                        currPattern = currParent;
                         continue;
                     } else {
-                        bool found = false;
-                        for (const auto &variable : searchScope) {
-                            if (variable->getVariableName() == name) {
-                                auto newPattern = variable->clone();
-                                delete currPattern;
-                                currPattern = newPattern;
-                                found = true;
-                                break;
-                            }
-                        }
+                        auto variable = this->findVariable(*searchScope, part);
 
-                        if (name == "$")
+                        if (*name == "$")
                             LogConsole::abortEvaluation("invalid use of placeholder operator in rvalue");
 
-                        if (!found)
-                            LogConsole::abortEvaluation(hex::format("no variable named '{}' found", name), this);
+                        if (variable == nullptr)
+                            LogConsole::abortEvaluation(hex::format("no variable named '{}' found", *name), this);
+
+                        currPattern = variable;
                     }
                 } else {
                     // Array indexing
-                    auto index = dynamic_cast<ASTNodeLiteral*>(std::get<ASTNode*>(part)->evaluate(evaluator));
-                    ON_SCOPE_EXIT { delete index; };
-
                     std::visit(overloaded {
                         [](std::string) { throw std::string("cannot use string to index array"); },
-                        [](PatternData * const &) { throw std::string("cannot use custom type to index array"); },
+                        [](PatternData*) { throw std::string("cannot use custom type to index array"); },
                         [&, this](auto &&index) {
                             if (auto dynamicArrayPattern = dynamic_cast<PatternDataDynamicArray*>(currPattern)) {
-                                if (index >= searchScope.size() || index < 0)
+                                if (index >= dynamicArrayPattern->getEntryCount() || index < 0)
                                     LogConsole::abortEvaluation("array index out of bounds", this);
 
-                                auto newPattern = searchScope[index]->clone();
-                                delete currPattern;
-                                currPattern = newPattern;
+                                currPattern = dynamicArrayPattern->getEntry(index);
+                                if (currPattern == nullptr)
+                                    LogConsole::abortEvaluation("failed to decode array entry", this);
                             }
                             else if (auto staticArrayPattern = dynamic_cast<PatternDataStaticArray*>(currPattern)) {
                                 if (index >= staticArrayPattern->getEntryCount() || index < 0)
                                     LogConsole::abortEvaluation("array index out of bounds", this);
 
-                                auto newPattern = searchScope.front()->clone();
-                                delete currPattern;
-                                currPattern = newPattern;
-                                currPattern->setOffset(staticArrayPattern->getOffset() + index * staticArrayPattern->getSize());
+                                auto entryOffset = staticArrayPattern->getOffset() + index * staticArrayPattern->getSize();
+
+                                // The array might be part of the previous copy, so that one has to stay alive until the template got cloned
+                                copy.reset(searchScope->front()->clone());
+                                currPattern = copy.get();
+                                currPattern->setOffset(entryOffset);
                             }
                         }
-                    }, index->getValue());
+                    }, evaluator->evaluateExpression(std::get<ASTNode*>(this->m_path[part])));
                 }
 
-                if (auto pointerPattern = dynamic_cast<PatternDataPointer*>(currPattern)) {
-                    auto newPattern = pointerPattern->getPointedAtPattern()->clone();
-                    delete currPattern;
-                    currPattern = newPattern;
-                }
+                if (auto pointerPattern = dynamic_cast<PatternDataPointer*>(currPattern))
+                    currPattern = pointerPattern->getPointedAtPattern();
 
                 if (auto structPattern = dynamic_cast<PatternDataStruct*>(currPattern))
-                    searchScope = structPattern->getMembers();
+                    searchScope = &structPattern->getMembers();
                 else if (auto unionPattern = dynamic_cast<PatternDataUnion*>(currPattern))
-                    searchScope = unionPattern->getMembers();
+                    searchScope = &unionPattern->getMembers();
                 else if (auto bitfieldPattern = dynamic_cast<PatternDataBitfield*>(currPattern))
-                    searchScope = bitfieldPattern->getFields();
-                else if (auto dynamicArrayPattern = dynamic_cast<PatternDataDynamicArray*>(currPattern))
-                    searchScope = dynamicArrayPattern->getEntries();
-                else if (auto staticArrayPattern = dynamic_cast<PatternDataStaticArray*>(currPattern))
-                    searchScope = { staticArrayPattern->getTemplate() };
+                    searchScope = &bitfieldPattern->getFields();
+                else if (dynamic_cast<PatternDataDynamicArray*>(currPattern)) {
+                    // Entries can only be accessed by index
+                    templateScope = { };
+                    searchScope = &templateScope;
+                } else if (auto staticArrayPattern = dynamic_cast<PatternDataStaticArray*>(currPattern)) {
+                    templateScope = { staticArrayPattern->getTemplate() };
+                    searchScope = &templateScope;
+                }
 
             }
 
-            return { currPattern };
+            return currPattern;
+        }
+
+        /* Looks up a variable by name. The slot it was found in last time is checked first as the same */
+        /* rvalue mostly gets evaluated against scopes that are laid out the same way                   */
+        PatternData* findVariable(const std::vector<PatternData*> &scope, u32 part) const {
+            const auto &name = std::get<std::string>(this->m_path[part]);
+            auto &slot = this->m_slots[part];
+
+            if (slot < scope.size() && scope[slot]->getVariableName() == name)
+                return scope[slot];
+
+            for (u32 i = 0; i < scope.size(); i++) {
+                if (scope[i]->getVariableName() == name) {
+                    slot = i;
+                    return scope[i];
+                }
+            }
+
+            return nullptr;
         }
 
-    private:
         Path m_path;
+        mutable std::vector<u32> m_slots;
     };
 
     class ASTNodeScopeResolution : public ASTNode {
@@ -1509,14 +1712,11 @@ namespace hex::pl {
     private:
         [[nodiscard]]
         bool evaluateCondition(Evaluator *evaluator) const {
-            auto literal = dynamic_cast<ASTNodeLiteral*>(this->m_condition->evaluate(evaluator));
-            ON_SCOPE_EXIT { delete literal; };
-
             return std::visit(overloaded {
                 [](std::string value) -> bool { return !value.empty(); },
-                [this](PatternData * const &) -> bool { LogConsole::abortEvaluation("cannot cast custom type to bool", this); },
+                [this](PatternData*) -> bool { LogConsole::abortEvaluation("cannot cast custom type to bool", this); },
                 [](auto &&value) -> bool { return value != 0; }
-                }, literal->getValue());
+                }, evaluator->evaluateExpression(this->m_condition));
         }
 
         ASTNode *m_condition;
@@ -1544,7 +1744,7 @@ namespace hex::pl {
             return new ASTNodeFunctionCall(*this);
         }
 
-        [[nodiscard]] const std::string& getFunctionName() {
+        [[nodiscard]] const std::string& getFunctionName() const {
             return this->m_functionName;
         }
 
@@ -1553,27 +1753,15 @@ namespace hex::pl {
         }
 
         [[nodiscard]] ASTNode* evaluate(Evaluator *evaluator) const override {
-            std::vector<Token::Literal> evaluatedParams;
-            for (auto param : this->m_params) {
-                auto expression = param->evaluate(evaluator);
-                ON_SCOPE_EXIT { delete expression; };
-
-                auto literal = dynamic_cast<ASTNodeLiteral*>(expression->evaluate(evaluator));
-                ON_SCOPE_EXIT { delete literal; };
-
-                evaluatedParams.push_back(literal->getValue());
-            }
-
-            auto &customFunctions = evaluator->getCustomFunctions();
-            auto functions = ContentRegistry::PatternLanguageFunctions::getEntries();
-
-            for (auto &func : customFunctions)
-                functions.insert(func);
+            return new ASTNodeLiteral(evaluator->evaluateExpression(this));
+        }
 
-            if (!functions.contains(this->m_functionName))
+        /* Calls the function at functionIndex of the evaluator's dispatch table with already evaluated parameters */
+        std::optional<Token::Literal> call(Evaluator *evaluator, u32 functionIndex, const std::vector<Token::Literal> &evaluatedParams) const {
+            if (functionIndex == Evaluator::NoFunction)
                 LogConsole::abortEvaluation(hex::format("call to unknown function '{}'", this->m_functionName), this);
 
-            auto function = functions[this->m_functionName];
+            const auto &function = evaluator->getFunction(functionIndex);
             if (function.parameterCount == ContentRegistry::PatternLanguageFunctions::UnlimitedParameters) {
                 ; // Don't check parameter count
             }
@@ -1588,21 +1776,18 @@ namespace hex::pl {
             }
 
             try {
-                auto result = functions[this->m_functionName].func(evaluator, evaluatedParams);
-
-                if (result.has_value())
-                    return new ASTNodeLiteral(result.value());
-                else
-                    return new ASTNodeMathematicalExpression(nullptr, nullptr, Token::Operator::Plus);
+                return function.func(evaluator, evaluatedParams);
             } catch (std::string &error) {
                 LogConsole::abortEvaluation(error, this);
             }
-
-            return nullptr;
         }
 
         FunctionResult execute(Evaluator *evaluator) override {
-            delete this->evaluate(evaluator);
+            std::vector<Token::Literal> evaluatedParams;
+            for (auto param : this->m_params)
+                evaluatedParams.push_back(evaluator->evaluateExpression(param));
+
+            (void)this->call(evaluator, evaluator->findFunction(this->m_functionName), evaluatedParams);
 
             return { false, { } };
         }
@@ -1643,14 +1828,19 @@ namespace hex::pl {
 
         [[nodiscard]]
         ASTNode* evaluate(Evaluator *evaluator) const override {
+            return new ASTNodeLiteral(evaluator->evaluateExpression(this));
+        }
+
+        [[nodiscard]]
+        Token::Literal getValue(Evaluator *evaluator) const {
             auto pattern = this->m_expression->createPatterns(evaluator).front();
             ON_SCOPE_EXIT { delete pattern; };
 
             switch (this->getOperator()) {
                 case Token::Operator::AddressOf:
-                    return new ASTNodeLiteral(u128(pattern->getOffset()));
+                    return u128(pattern->getOffset());
                 case Token::Operator::SizeOf:
-                    return new ASTNodeLiteral(u128(pattern->getSize()));
+                    return u128(pattern->getSize());
                 default:
                     LogConsole::abortEvaluation("invalid type operator", this);
             }
@@ -1692,10 +1882,7 @@ namespace hex::pl {
         }
 
         FunctionResult execute(Evaluator *evaluator) override {
-            auto literal = dynamic_cast<ASTNodeLiteral*>(this->getRValue()->evaluate(evaluator));
-            ON_SCOPE_EXIT { delete literal; };
-
-            evaluator->setVariable(this->getLValueName(), literal->getValue());
+            evaluator->setVariable(this->getLValueName(), evaluator->evaluateExpression(this->getRValue()));
 
             return { false, { } };
         }
@@ -1733,12 +1920,8 @@ namespace hex::pl {
 
             if (returnValue == nullptr)
                 return { true, std::nullopt };
-            else {
-                auto literal = dynamic_cast<ASTNodeLiteral*>(returnValue->evaluate(evaluator));
-                ON_SCOPE_EXIT { delete literal; };
-
-                return { true, literal->getValue() };
-            }
+            else
+                return { true, evaluator->evaluateExpression(returnValue) };
         }
 
     private:
@@ -3,6 +3,7 @@
 #include <optional>
 #include <vector>
 
+#include <hex/pattern_language/arena.hpp>
 #include <hex/pattern_language/token.hpp>
 
 namespace hex::pl {
@@ -47,6 +48,9 @@ namespace hex::pl {
 
         constexpr ASTNode(const ASTNode &) = default;
 
+        static void* operator new(size_t size) { return Arena::allocate(size); }
+        static void operator delete(void *pointer) { Arena::deallocate(pointer); }
+
         [[nodiscard]] constexpr u32 getLineNumber() const { return this->m_lineNumber; }
 
         [[maybe_unused]] constexpr void setLineNumber(u32 lineNumber) { this->m_lineNumber = lineNumber; }
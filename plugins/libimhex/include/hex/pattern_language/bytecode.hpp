@@ -0,0 +1,60 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <vector>
+
+#include <hex/pattern_language/token.hpp>
+
+namespace hex::pl {
+
+    class ASTNode;
+    class Evaluator;
+
+    enum class OpCode : u8 {
+        PushConstant,       // Pushes constants[operand]
+        PushOffset,         // Pushes the current data offset ($)
+        LoadRValue,         // Pushes the value of the ASTNodeRValue node
+        TypeOperator,       // Pushes the result of the ASTNodeTypeOperator node
+        Operation,          // Pops two values and pushes the result of the ASTNodeMathematicalExpression node's operator
+        Select,             // Pops three values and pushes the second or third one depending on the first one
+        Cast,               // Pops a value and pushes it casted to the ASTNodeCast node's type
+        Call,               // Pops the ASTNodeFunctionCall node's parameters and pushes the result of calling function number operand (or the one with its name if that is NoFunction)
+        Evaluate            // Pushes the literal of evaluating the node using the AST
+    };
+
+    struct Instruction {
+        OpCode opCode;
+        u32 operand;
+        const ASTNode *node;
+    };
+
+    /* Expression flattened into a sequence of stack machine instructions */
+    struct Bytecode {
+        std::vector<Instruction> instructions;
+        std::vector<Token::Literal> constants;
+    };
+
+    class Compiler {
+    public:
+        Compiler() = delete;
+
+        /* Compiles an expression tree. Subexpressions that only consist of constants get folded into a single constant */
+        /* Function calls get bound to the evaluator's functions that exist at this point                                */
+        [[nodiscard]] static Bytecode compile(const ASTNode *expression, const Evaluator *evaluator);
+
+    private:
+        static void compileNode(Bytecode &bytecode, const ASTNode *node, const Evaluator *evaluator);
+        static void tryFoldConstants(Bytecode &bytecode, size_t startInstruction, u32 operandCount);
+    };
+
+    class VirtualMachine {
+    public:
+        [[nodiscard]] Token::Literal execute(const Bytecode &bytecode, Evaluator *evaluator);
+
+    private:
+        /* Shared between nested executions caused by function calls, each one only touches the part above its own base */
+        std::vector<Token::Literal> m_stack;
+    };
+
+}
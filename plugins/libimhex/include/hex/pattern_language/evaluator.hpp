@@ -1,10 +1,20 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <bit>
+#include <chrono>
+#include <limits>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <set>
+#include <unordered_map>
 #include <vector>
 
+#include <hex/pattern_language/arena.hpp>
+#include <hex/pattern_language/bytecode.hpp>
 #include <hex/pattern_language/log_console.hpp>
 #include <hex/api/content_registry.hpp>
 
@@ -19,10 +29,49 @@ namespace hex::pl {
 
     class Evaluator {
     public:
-        Evaluator() = default;
+        Evaluator();
+        ~Evaluator();
 
         std::optional<std::vector<PatternData*>> evaluate(const std::vector<ASTNode*> &ast);
 
+        /* Identifies the code of a top-level placement together with the types, functions and variables it refers to */
+        struct PlacementHash {
+            u64 hash;
+            bool dependsOnOffset;
+            std::vector<const ASTNode*> dependencies;
+        };
+
+        /* Placements with a known hash are only evaluated again once their code, their start offset or the data changed */
+        void setPlacementHashes(std::unordered_map<const ASTNode*, PlacementHash> placementHashes) {
+            this->m_placementHashes = std::move(placementHashes);
+        }
+
+        [[nodiscard]]
+        u64 getEvaluationId() const {
+            return this->m_evaluationId;
+        }
+
+        /* Whether results of the given evaluation are still being reused, in which case its AST needs to be kept around */
+        [[nodiscard]]
+        bool isEvaluationCached(u64 evaluationId) const;
+
+        /* Lazily decoded array entries get decoded through the evaluator that created them, possibly from another thread. */
+        /* The mutex is held while evaluating so decoding waits for it, the evaluator and the evaluations whose AST still  */
+        /* exists are tracked so entries that outlived either of them are never decoded                                   */
+        struct DecodingContext {
+            std::recursive_mutex mutex;
+            Evaluator *evaluator = nullptr;
+            std::set<u64> decodableEvaluations;
+        };
+
+        [[nodiscard]]
+        const std::shared_ptr<DecodingContext>& getDecodingContext() const {
+            return this->m_decodingContext;
+        }
+
+        /* Compiles the expression to bytecode the first time it gets evaluated and runs it */
+        Token::Literal evaluateExpression(const ASTNode *expression);
+
         [[nodiscard]]
         LogConsole& getConsole() {
             return this->m_console;
@@ -43,6 +92,9 @@ namespace hex::pl {
         const Scope& getScope(s32 index) {
             static Scope empty;
 
+            if (index < 0)
+                this->m_lowestAccessedScope = std::min<u64>(this->m_lowestAccessedScope, std::max<s64>(s64(this->m_scopes.size()) - 1 + index, 0));
+
             if (index > 0 || -index >= this->m_scopes.size()) return empty;
             return this->m_scopes[this->m_scopes.size() - 1 + index];
         }
@@ -51,6 +103,14 @@ namespace hex::pl {
             return this->m_scopes.front();
         }
 
+        [[nodiscard]]
+        u64 getScopeCount() const {
+            return this->m_scopes.size();
+        }
+
+        /* Lowest scope that has been accessed from a nested one so far. Used to find types that only depend on their own data */
+        u64& lowestAccessedScope() { return this->m_lowestAccessedScope; }
+
         void setProvider(prv::Provider *provider) {
             this->m_provider = provider;
         }
@@ -60,6 +120,19 @@ namespace hex::pl {
             return this->m_provider;
         }
 
+        /* Address the data starts at as seen by the pattern. Only applies to the current run, the provider keeps its own base address */
+        void setDataBaseAddress(u64 address) {
+            this->m_dataBaseAddress = address;
+        }
+
+        [[nodiscard]]
+        u64 getDataBaseAddress() const {
+            return this->m_dataBaseAddress;
+        }
+
+        /* Reads the data at an address as seen by the pattern */
+        void readData(u64 address, void *buffer, size_t size);
+
         void setDefaultEndian(std::endian endian) {
             this->m_defaultEndian = endian;
         }
@@ -87,14 +160,98 @@ namespace hex::pl {
             return this->m_arrayLimit;
         }
 
+        /* Limits for a single evaluation, 0 disables them. Reaching one of them aborts the evaluation */
+        void setTimeLimit(u32 seconds) {
+            this->m_timeLimit = seconds;
+        }
+
+        [[nodiscard]]
+        u32 getTimeLimit() const {
+            return this->m_timeLimit;
+        }
+
+        void setPatternLimit(u64 patternLimit) {
+            this->m_patternLimit = patternLimit;
+        }
+
+        [[nodiscard]]
+        u64 getPatternLimit() const {
+            return this->m_patternLimit;
+        }
+
+        void setMemoryLimit(u64 memoryLimit) {
+            this->m_memoryLimit = memoryLimit;
+        }
+
+        [[nodiscard]]
+        u64 getMemoryLimit() const {
+            return this->m_memoryLimit;
+        }
+
+        /* Arena the patterns get allocated from. Its usage is what the pattern and memory limits are checked against */
+        void setPatternArena(Arena *arena) {
+            this->m_patternArena = arena;
+        }
+
+        /* Stops the running evaluation as soon as it reaches the next loop iteration or array entry. Safe to call from any thread */
+        void abort() {
+            this->m_aborted = true;
+        }
+
+        /* Evaluating doesn't reset an abort so one that came in while the code was still being parsed isn't lost */
+        void resetAbort() {
+            this->m_aborted = false;
+        }
+
+        /* Rough estimate between 0 and 1 of how far the evaluation got, based on the current offset. Safe to call from any thread */
+        [[nodiscard]]
+        float getProgress() const;
+
+        /* Called from loops and arrays. Aborts the evaluation if it got cancelled or exceeded one of its limits */
+        void handleAbort() {
+            if (!this->m_running)
+                return;
+
+            this->m_progressOffset.store(this->m_currOffset, std::memory_order_relaxed);
+
+            if (this->m_aborted.load(std::memory_order_relaxed))
+                LogConsole::abortEvaluation("evaluation aborted by user");
+
+            // Looking at the clock and the arena is comparatively expensive so it's not done every single time
+            if ((++this->m_abortCheckCount & 0xFF) == 0)
+                this->checkLimits();
+        }
+
         u64& dataOffset() { return this->m_currOffset; }
 
         bool addCustomFunction(const std::string &name, u32 numParams, const ContentRegistry::PatternLanguageFunctions::Callback &function) {
             const auto [iter, inserted] = this->m_customFunctions.insert({ name, { numParams, function } });
 
+            // Builtin functions take precedence over custom functions with the same name
+            if (inserted && !this->m_functionIndices.contains(name)) {
+                this->m_functionIndices.emplace(name, this->m_functions.size());
+                this->m_functions.push_back(iter->second);
+            }
+
             return inserted;
         }
 
+        constexpr static u32 NoFunction = 0xFFFF'FFFF;
+
+        /* Index of the function in the dispatch table or NoFunction if there is no function with that name (yet) */
+        [[nodiscard]]
+        u32 findFunction(const std::string &name) const {
+            if (auto function = this->m_functionIndices.find(name); function != this->m_functionIndices.end())
+                return function->second;
+            else
+                return NoFunction;
+        }
+
+        [[nodiscard]]
+        const ContentRegistry::PatternLanguageFunctions::Function& getFunction(u32 index) const {
+            return this->m_functions[index];
+        }
+
         [[nodiscard]]
         const std::map<std::string, ContentRegistry::PatternLanguageFunctions::Function>& getCustomFunctions() const {
             return this->m_customFunctions;
@@ -110,18 +267,53 @@ namespace hex::pl {
         void setVariable(const std::string &name, const Token::Literal& value);
 
     private:
+        std::vector<PatternData*> createPlacement(ASTNode *node);
+        void checkLimits();
+
         u64 m_currOffset;
         prv::Provider *m_provider = nullptr;
+        u64 m_dataBaseAddress = 0;
         LogConsole m_console;
 
         std::endian m_defaultEndian = std::endian::native;
         u32 m_evalDepth;
         u32 m_arrayLimit;
+        u32 m_timeLimit = 0;
+        u64 m_patternLimit = 0;
+        u64 m_memoryLimit = 0;
+
+        Arena *m_patternArena = nullptr;
+        bool m_running = false;
+        u32 m_abortCheckCount = 0;
+        std::atomic<bool> m_aborted = false;
+        std::atomic<u64> m_progressOffset = 0, m_progressSize = 0;
+        std::chrono::steady_clock::time_point m_evaluationStart;
 
         std::vector<Scope> m_scopes;
+        u64 m_lowestAccessedScope = std::numeric_limits<u64>::max();
         std::map<std::string, ContentRegistry::PatternLanguageFunctions::Function> m_customFunctions;
         std::vector<ASTNode*> m_customFunctionDefinitions;
+        std::vector<ContentRegistry::PatternLanguageFunctions::Function> m_functions;
+        std::unordered_map<std::string, u32> m_functionIndices;
         std::vector<Token::Literal> m_stack;
+
+        std::unordered_map<const ASTNode*, Bytecode> m_compiledExpressions;
+        VirtualMachine m_virtualMachine;
+
+        struct CachedPlacement {
+            std::vector<PatternData*> patterns;
+            u64 endOffset;
+            u32 endPaletteOffset;
+            std::vector<std::pair<LogConsole::Level, std::string>> log;
+            u64 createdIn, usedIn;
+        };
+
+        u64 m_evaluationId = 0;
+        std::shared_ptr<DecodingContext> m_decodingContext;
+        std::unordered_map<const ASTNode*, PlacementHash> m_placementHashes;
+        std::unordered_map<const ASTNode*, u64> m_placementKeys;
+        std::unordered_map<u64, CachedPlacement> m_placementCache;
+        Arena m_placementArena;
     };
 
 }
\ No newline at end of file
@@ -6,6 +6,8 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace hex::pl {
@@ -14,7 +16,7 @@ namespace hex::pl {
     public:
         using LexerError = std::pair<u32, std::string>;
 
-        Lexer() = default;
+        Lexer();
 
         std::optional<std::vector<Token>> lex(const std::string& code);
         const LexerError& getError() { return this->m_error; }
@@ -22,6 +24,30 @@ namespace hex::pl {
     private:
         LexerError m_error;
 
+        struct SymbolHash {
+            using is_transparent = void;
+
+            size_t operator()(std::string_view string) const { return std::hash<std::string_view>{}(string); }
+        };
+
+        /* Keywords, builtin types and every identifier seen so far. Identifier tokens refer to the names stored in here */
+        std::unordered_map<std::string, Token, SymbolHash, std::equal_to<>> m_symbols;
+
+        /* Source and tokens of the last run. Lines that didn't change, like the ones holding included files, */
+        /* don't need to be lexed again and can copy their tokens from there instead                         */
+        struct CachedLine {
+            size_t hash;
+            u32 codeOffset, codeSize;
+            u32 firstToken, tokenCount;
+        };
+
+        std::string m_cachedCode;
+        std::vector<Token> m_cachedTokens;
+        std::vector<CachedLine> m_lineCache;
+
+        const Token& getSymbol(std::string_view name);
+        const CachedLine* findCachedLine(size_t hash, std::string_view line) const;
+
         [[noreturn]] void throwLexerError(const std::string &error, u32 lineNumber) const {
             throw LexerError(lineNumber, "Lexer: " + error);
         }
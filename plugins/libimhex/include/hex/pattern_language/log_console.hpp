@@ -37,6 +37,11 @@ namespace hex::pl {
             }
         }
 
+        /* Adds entries that have been logged before again, e.g. when the result of an earlier evaluation gets reused */
+        void replay(const std::vector<std::pair<Level, std::string>> &entries) {
+            this->m_consoleLog.insert(this->m_consoleLog.end(), entries.begin(), entries.end());
+        }
+
         [[noreturn]]
         static void abortEvaluation(const std::string &message) {
             throw EvaluateError(0, message);
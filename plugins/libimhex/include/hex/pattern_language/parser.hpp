@@ -24,6 +24,11 @@ namespace hex::pl {
         std::optional<std::vector<ASTNode*>> parse(const std::vector<Token> &tokens);
         const ParseError& getError() { return this->m_error; }
 
+        /* Hashes of all top-level placements of the last parsed program. Used by the evaluator to skip placements that didn't change */
+        [[nodiscard]] const std::unordered_map<const ASTNode*, Evaluator::PlacementHash>& getPlacementHashes() const {
+            return this->m_placementHashes;
+        }
+
     private:
         ParseError m_error;
         TokenIter m_curr;
@@ -33,6 +38,16 @@ namespace hex::pl {
         std::vector<TokenIter> m_matchedOptionals;
         std::vector<std::vector<std::string>> m_currNamespace;
 
+        struct Statement {
+            ASTNode *node;
+            u64 hash;
+            std::vector<std::string> declaredNames, referencedNames;
+            bool readsCurrentOffset, hasPlacementOffset;
+        };
+
+        std::vector<Statement> m_statements;
+        std::unordered_map<const ASTNode*, Evaluator::PlacementHash> m_placementHashes;
+
         u32 getLineNumber(s32 index) const {
             return this->m_curr[index].lineNumber;
         }
@@ -117,6 +132,9 @@ namespace hex::pl {
         std::vector<ASTNode*> parseNamespace();
         std::vector<ASTNode*> parseStatements();
 
+        void addStatement(ASTNode *node, TokenIter begin);
+        void hashPlacements();
+
         std::vector<ASTNode*> parseTillToken(Token::Type endTokenType, const auto value) {
             std::vector<ASTNode*> program;
             auto guard = SCOPE_GUARD {
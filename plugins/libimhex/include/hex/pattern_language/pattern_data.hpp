@@ -5,6 +5,7 @@
 #include <imgui.h>
 
 #include <hex/providers/provider.hpp>
+#include <hex/pattern_language/arena.hpp>
 #include <hex/pattern_language/token.hpp>
 #include <hex/views/view.hpp>
 #include <hex/helpers/utils.hpp>
@@ -12,9 +13,12 @@
 #include <hex/helpers/concepts.hpp>
 #include <hex/helpers/logger.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <codecvt>
+#include <functional>
 #include <locale>
+#include <mutex>
 #include <random>
 #include <string>
 #include <type_traits>
@@ -43,6 +47,12 @@ namespace hex::pl {
 
     }
 
+    /* Range of bytes [start, end) a pattern highlights in its colour */
+    struct HighlightedRange {
+        u64 start, end;
+        u32 color;
+    };
+
     class PatternData {
     public:
         PatternData(u64 offset, size_t size, u32 color = 0)
@@ -62,10 +72,16 @@ namespace hex::pl {
 
         virtual ~PatternData() = default;
 
+        static void* operator new(size_t size) { return Arena::allocate(size); }
+        static void operator delete(void *pointer) { Arena::deallocate(pointer); }
+
         virtual PatternData* clone() = 0;
 
         [[nodiscard]] u64 getOffset() const { return this->m_offset; }
-        virtual void setOffset(u64 offset) { this->m_offset = offset; }
+        virtual void setOffset(u64 offset) {
+            this->m_offset = offset;
+            this->m_displayValue.reset();
+        }
 
         [[nodiscard]] size_t getSize() const { return this->m_size; }
         void setSize(size_t size) { this->m_size = size; }
@@ -83,7 +99,10 @@ namespace hex::pl {
         void setColor(u32 color) { this->m_color = color; }
 
         [[nodiscard]] std::endian getEndian() const { return this->m_endian; }
-        void setEndian(std::endian endian) { this->m_endian = endian; }
+        void setEndian(std::endian endian) {
+            this->m_endian = endian;
+            this->m_displayValue.reset();
+        }
 
         [[nodiscard]] PatternData* getParent() const { return this->m_parent; }
         void setParent(PatternData *parent) { this->m_parent = parent; }
@@ -95,9 +114,36 @@ namespace hex::pl {
             this->m_formatterFunction = { function, evaluator };
         }
 
+        /* Draws the table row of this pattern. Its children are drawn as rows of their own by the pattern data view */
         virtual void createEntry(prv::Provider* &provider) = 0;
         [[nodiscard]] virtual std::string getFormattedName() const = 0;
 
+        /* Whether createEntry draws a row for this pattern at all */
+        [[nodiscard]] virtual bool hasEntry() const { return !this->isHidden(); }
+
+        /* Patterns nested below this one in the pattern data view, in the order they're displayed in */
+        [[nodiscard]] virtual u64 getChildCount() const { return 0; }
+        [[nodiscard]] virtual PatternData* getChild(u64 index) const { return nullptr; }
+
+        /* Draws the row of a single child. Children that couldn't be created still take up their row */
+        virtual void drawChild(prv::Provider* &provider, u64 index) {
+            if (auto child = this->getChild(index); child != nullptr)
+                child->draw(provider);
+            else
+                ImGui::TableNextRow();
+        }
+
+        /* Index of the child that contains the given offset */
+        [[nodiscard]] virtual std::optional<u64> findChild(u64 offset) const {
+            for (u64 i = 0; i < this->getChildCount(); i++) {
+                auto child = this->getChild(i);
+                if (child != nullptr && offset >= child->getOffset() && offset < child->getOffset() + child->getSize())
+                    return i;
+            }
+
+            return { };
+        }
+
         virtual std::optional<u32> highlightBytes(size_t offset) {
             auto currOffset = this->getOffset();
             if (offset >= currOffset && offset < (currOffset + this->getSize()))
@@ -106,72 +152,90 @@ namespace hex::pl {
                 return { };
         }
 
-        virtual std::map<u64, u32> getHighlightedAddresses() {
-            if (this->isHidden()) return { };
-            if (this->m_highlightedAddresses.empty()) {
-                for (u64 i = 0; i < this->getSize(); i++)
-                    this->m_highlightedAddresses.insert({ this->getOffset() + i, this->getColor() });
-            }
+        /* Ranges are ordered by priority, where ranges overlap the earlier one wins */
+        virtual std::vector<HighlightedRange> getHighlightedRanges() {
+            if (this->isHidden() || this->getSize() == 0) return { };
 
-            return this->m_highlightedAddresses;
+            return { { this->getOffset(), this->getOffset() + this->getSize(), this->getColor() } };
         }
 
-        virtual void clearHighlightedAddresses() {
-            this->m_highlightedAddresses.clear();
+        virtual void clearHighlightedRanges() {
+            this->m_highlightedRanges.clear();
         }
 
         virtual void sort(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider) { }
 
-        static bool sortPatternDataTable(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider, pl::PatternData* left, pl::PatternData* right) {
-            if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("name")) {
-                if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                    return left->getDisplayName() > right->getDisplayName();
-                else
-                    return left->getDisplayName() < right->getDisplayName();
-            }
-            else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("offset")) {
-                if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                    return left->getOffset() > right->getOffset();
-                else
-                    return left->getOffset() < right->getOffset();
+        /* Column, direction and data a list of patterns has last been sorted by */
+        class SortState {
+        public:
+            /* Remembers the sort order that's used now. Returns whether the patterns have to be sorted again for it */
+            bool update(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider, u64 offset, size_t size) {
+                const auto column = sortSpecs->Specs->ColumnUserID;
+                const auto direction = sortSpecs->Specs->SortDirection;
+
+                // Only the order by value depends on the data
+                bool outdated = !this->m_valid || column != this->m_column || direction != this->m_direction || provider != this->m_provider;
+                if (!outdated && column == ImGui::GetID("value"))
+                    outdated = provider->hasDataChanged(offset, size, this->m_dataVersion);
+
+                this->m_valid = true;
+                this->m_column = column;
+                this->m_direction = direction;
+                this->m_provider = provider;
+                this->m_dataVersion = provider->getDataVersion();
+
+                return outdated;
             }
-            else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("size")) {
-                if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                    return left->getSize() > right->getSize();
-                else
-                    return left->getSize() < right->getSize();
-            }
-            else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("value")) {
-                size_t biggerSize = std::max(left->getSize(), right->getSize());
-                std::vector<u8> leftBuffer(biggerSize, 0x00), rightBuffer(biggerSize, 0x00);
-
-                provider->read(left->getOffset(), leftBuffer.data(), left->getSize());
-                provider->read(right->getOffset(), rightBuffer.data(), right->getSize());
-
-                if (left->m_endian != std::endian::native)
-                    std::reverse(leftBuffer.begin(), leftBuffer.end());
-                if (right->m_endian != std::endian::native)
-                    std::reverse(rightBuffer.begin(), rightBuffer.end());
 
-                if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                    return leftBuffer > rightBuffer;
-                else
-                    return leftBuffer < rightBuffer;
-            }
-            else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("type")) {
-                if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                    return left->getTypeName() > right->getTypeName();
-                else
-                    return left->getTypeName() < right->getTypeName();
-            }
-            else if (sortSpecs->Specs->ColumnUserID == ImGui::GetID("color")) {
-                if (sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending)
-                    return left->getColor() > right->getColor();
-                else
-                    return left->getColor() < right->getColor();
+            void reset() {
+                this->m_valid = false;
             }
 
-            return false;
+        private:
+            bool m_valid = false;
+            ImGuiID m_column = 0;
+            ImGuiSortDirection m_direction = ImGuiSortDirection_None;
+            prv::Provider *m_provider = nullptr;
+            u64 m_dataVersion = 0;
+        };
+
+        /* Sorts the patterns by the column selected in the sort specs. Keys are extracted only once per pattern */
+        /* instead of in every single comparison, which would read the data of both patterns again each time    */
+        static void sortPatterns(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider, std::vector<PatternData*> &patterns) {
+            const auto column = sortSpecs->Specs->ColumnUserID;
+            const bool descending = sortSpecs->Specs->SortDirection == ImGuiSortDirection_Ascending;
+
+            if (column == ImGui::GetID("name"))
+                sortPatternsByKey(patterns, descending, [](PatternData *pattern) { return pattern->getDisplayName(); });
+            else if (column == ImGui::GetID("offset"))
+                sortPatternsByKey(patterns, descending, [](PatternData *pattern) { return pattern->getOffset(); });
+            else if (column == ImGui::GetID("size"))
+                sortPatternsByKey(patterns, descending, [](PatternData *pattern) { return pattern->getSize(); });
+            else if (column == ImGui::GetID("type"))
+                sortPatternsByKey(patterns, descending, [](PatternData *pattern) { return pattern->getTypeName(); });
+            else if (column == ImGui::GetID("color"))
+                sortPatternsByKey(patterns, descending, [](PatternData *pattern) { return pattern->getColor(); });
+            else if (column == ImGui::GetID("value"))
+                sortPatternsByValue(provider, patterns, descending);
+        }
+
+        /* Smaller patterns come first, ones of the same size are compared as big endian numbers. Only the most */
+        /* significant bytes of each value are looked at so huge patterns don't all need a copy of their data   */
+        static void sortPatternsByValue(prv::Provider *provider, std::vector<PatternData*> &patterns, bool descending) {
+            sortPatternsByKey(patterns, descending, [&](PatternData *pattern) {
+                const auto size = pattern->getSize();
+                std::vector<u8> buffer(std::min(size, MaxValueSortKeySize), 0x00);
+
+                // The most significant bytes of little endian values are the ones at their end
+                if (pattern->m_endian == std::endian::little) {
+                    provider->readCached(pattern->getOffset() + size - buffer.size(), buffer.data(), buffer.size());
+                    std::reverse(buffer.begin(), buffer.end());
+                } else {
+                    provider->readCached(pattern->getOffset(), buffer.data(), buffer.size());
+                }
+
+                return std::pair { size, std::move(buffer) };
+            });
         }
 
         void draw(prv::Provider *provider) {
@@ -216,7 +280,79 @@ namespace hex::pl {
         }
 
     protected:
-        void createDefaultEntry(const std::string &value, const Token::Literal &literal) const {
+        constexpr static size_t MaxValueSortKeySize = 0x40;
+
+        template<typename F>
+        static void sortPatternsByKey(std::vector<PatternData*> &patterns, bool descending, F &&extractKey) {
+            std::vector<std::pair<std::invoke_result_t<F, PatternData*>, PatternData*>> keys;
+            keys.reserve(patterns.size());
+            for (auto &pattern : patterns)
+                keys.emplace_back(extractKey(pattern), pattern);
+
+            hex::parallelSort(keys.begin(), keys.end(), [descending](const auto &left, const auto &right) {
+                if (descending)
+                    return left.first > right.first;
+                else
+                    return left.first < right.first;
+            });
+
+            for (size_t i = 0; i < keys.size(); i++)
+                patterns[i] = keys[i].second;
+        }
+
+        /* Region of the data the value is read from */
+        [[nodiscard]] virtual std::pair<u64, size_t> getValueRegion() const {
+            return { this->getOffset(), this->getSize() };
+        }
+
+        /* Text of the value column. Reading and formatting it again is only done once the data below the pattern changed. */
+        /* Format functions can read from anywhere though so their results are redone whenever any data changed            */
+        template<typename F>
+        const std::string& getDisplayValue(prv::Provider *provider, F &&formatValue) {
+            const auto dataChanged = [&, this] {
+                if (this->m_formatterFunction.has_value())
+                    return provider->getDataVersion() != this->m_displayValueVersion;
+                else {
+                    const auto [offset, size] = this->getValueRegion();
+                    return provider->hasDataChanged(offset, size, this->m_displayValueVersion);
+                }
+            };
+
+            if (!this->m_displayValue.has_value() || this->m_displayValueProvider != provider || dataChanged()) {
+                this->m_displayValueVersion = provider->getDataVersion();
+                this->m_displayValueProvider = provider;
+                this->m_displayValue = formatValue();
+            }
+
+            return *this->m_displayValue;
+        }
+
+        /* The value is read using readValue, which returns its text along with the literal passed to the format function of the pattern */
+        template<typename F>
+        void createDefaultEntry(prv::Provider *provider, F &&readValue) {
+            const auto &value = this->getDisplayValue(provider, [&, this]() -> std::string {
+                auto [valueString, literal] = readValue();
+
+                if (!this->m_formatterFunction.has_value())
+                    return valueString;
+
+                auto &[func, evaluator] = this->m_formatterFunction.value();
+                auto result = func.func(evaluator, { literal });
+
+                if (result.has_value()) {
+                    if (auto displayValue = std::get_if<std::string>(&result.value()); displayValue != nullptr)
+                        return *displayValue;
+                    else
+                        return "";
+                } else {
+                    return "???";
+                }
+            });
+
+            this->createDefaultEntry(value);
+        }
+
+        void createDefaultEntry(const std::string &value) const {
             ImGui::TableNextRow();
             ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap);
             ImGui::TableNextColumn();
@@ -235,20 +371,12 @@ namespace hex::pl {
             ImGui::TableNextColumn();
             ImGui::TextColored(ImColor(0xFF9BC64D), "%s", this->getFormattedName().c_str());
             ImGui::TableNextColumn();
+            ImGui::Text("%s", value.c_str());
+        }
 
-            if (!this->m_formatterFunction.has_value())
-                ImGui::Text("%s", value.c_str());
-            else {
-                auto &[func, evaluator] = this->m_formatterFunction.value();
-                auto result = func.func(evaluator, { literal });
-
-                if (result.has_value()) {
-                    if (auto displayValue = std::get_if<std::string>(&result.value()); displayValue != nullptr)
-                        ImGui::Text("%s", displayValue->c_str());
-                } else {
-                    ImGui::Text("???");
-                }
-            }
+        void addHighlightedRanges(PatternData *pattern) {
+            auto ranges = pattern->getHighlightedRanges();
+            this->m_highlightedRanges.insert(this->m_highlightedRanges.end(), ranges.begin(), ranges.end());
         }
 
         void drawCommentTooltip() const {
@@ -261,7 +389,7 @@ namespace hex::pl {
 
     protected:
         std::endian m_endian = std::endian::native;
-        std::map<u64, u32> m_highlightedAddresses;
+        std::vector<HighlightedRange> m_highlightedRanges;
         bool m_hidden = false;
 
     private:
@@ -278,6 +406,10 @@ namespace hex::pl {
 
         PatternData *m_parent;
         bool m_local = false;
+
+        std::optional<std::string> m_displayValue;
+        u64 m_displayValueVersion = 0;
+        prv::Provider *m_displayValueProvider = nullptr;
     };
 
     class PatternDataPadding : public PatternData {
@@ -291,6 +423,8 @@ namespace hex::pl {
         void createEntry(prv::Provider* &provider) override {
         }
 
+        [[nodiscard]] bool hasEntry() const override { return false; }
+
         [[nodiscard]] std::string getFormattedName() const override {
             return "";
         }
@@ -317,13 +451,17 @@ namespace hex::pl {
         }
 
         void createEntry(prv::Provider* &provider) override {
-            u64 data = 0;
-            provider->read(this->getOffset(), &data, this->getSize());
-            data = hex::changeEndianess(data, this->getSize(), this->getEndian());
+            const auto &value = this->getDisplayValue(provider, [&, this] {
+                u64 data = 0;
+                provider->readCached(this->getOffset(), &data, this->getSize());
+                data = hex::changeEndianess(data, this->getSize(), this->getEndian());
+
+                return hex::format("*(0x{:X})", data);
+            });
 
             ImGui::TableNextRow();
             ImGui::TableNextColumn();
-            bool open = ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap);
+            ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_AllowItemOverlap);
             this->drawCommentTooltip();
             ImGui::TableNextColumn();
             ImGui::ColorButton("color", ImColor(this->getColor()), ImGuiColorEditFlags_NoTooltip, ImVec2(ImGui::GetColumnWidth(), ImGui::GetTextLineHeight()));
@@ -334,15 +472,12 @@ namespace hex::pl {
             ImGui::TableNextColumn();
             ImGui::TextColored(ImColor(0xFF9BC64D), "%s", this->getFormattedName().c_str());
             ImGui::TableNextColumn();
-            ImGui::Text("*(0x%llX)", data);
-
-            if (open) {
-                this->m_pointedAt->createEntry(provider);
-
-                ImGui::TreePop();
-            }
+            ImGui::Text("%s", value.c_str());
         }
 
+        [[nodiscard]] u64 getChildCount() const override { return 1; }
+        [[nodiscard]] PatternData* getChild(u64 index) const override { return this->m_pointedAt; }
+
         std::optional<u32> highlightBytes(size_t offset) override {
             if (offset >= this->getOffset() && offset < (this->getOffset() + this->getSize()))
                 return this->getColor();
@@ -352,16 +487,13 @@ namespace hex::pl {
                 return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
-                auto ownAddresses = PatternData::getHighlightedAddresses();
-                auto pointedToAddresses = this->m_pointedAt->getHighlightedAddresses();
-
-                ownAddresses.merge(pointedToAddresses);
-                this->m_highlightedAddresses = ownAddresses;
+        std::vector<HighlightedRange> getHighlightedRanges() override {
+            if (this->m_highlightedRanges.empty()) {
+                this->m_highlightedRanges = PatternData::getHighlightedRanges();
+                this->addHighlightedRanges(this->m_pointedAt);
             }
 
-            return this->m_highlightedAddresses;
+            return this->m_highlightedRanges;
         }
         [[nodiscard]] std::string getFormattedName() const override {
             std::string result = this->m_pointedAt->getFormattedName() + "* : ";
@@ -404,11 +536,13 @@ namespace hex::pl {
         }
 
         void createEntry(prv::Provider* &provider) override {
-            u128 data = 0;
-            provider->read(this->getOffset(), &data, this->getSize());
-            data = hex::changeEndianess(data, this->getSize(), this->getEndian());
+            this->createDefaultEntry(provider, [&, this] {
+                u128 data = 0;
+                provider->readCached(this->getOffset(), &data, this->getSize());
+                data = hex::changeEndianess(data, this->getSize(), this->getEndian());
 
-            this->createDefaultEntry(hex::format("{:d} (0x{:0{}X})", data, data, this->getSize() * 2), data);
+                return std::pair<std::string, Token::Literal>{ hex::format("{:d} (0x{:0{}X})", data, data, this->getSize() * 2), data };
+            });
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -435,12 +569,14 @@ namespace hex::pl {
         }
 
        void createEntry(prv::Provider* &provider) override {
-            s128 data = 0;
-            provider->read(this->getOffset(), &data, this->getSize());
-            data = hex::changeEndianess(data, this->getSize(), this->getEndian());
+            this->createDefaultEntry(provider, [&, this] {
+                s128 data = 0;
+                provider->readCached(this->getOffset(), &data, this->getSize());
+                data = hex::changeEndianess(data, this->getSize(), this->getEndian());
 
-            data = hex::signExtend(this->getSize() * 8, data);
-            this->createDefaultEntry(hex::format("{:d} (0x{:0{}X})", data, data, 1 * 2), data);
+                data = hex::signExtend(this->getSize() * 8, data);
+                return std::pair<std::string, Token::Literal>{ hex::format("{:d} (0x{:0{}X})", data, data, 1 * 2), data };
+            });
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -467,19 +603,24 @@ namespace hex::pl {
         }
 
         void createEntry(prv::Provider* &provider) override {
-            if (this->getSize() == 4) {
-                u32 data = 0;
-                provider->read(this->getOffset(), &data, 4);
-                data = hex::changeEndianess(data, 4, this->getEndian());
+            if (this->getSize() != 4 && this->getSize() != 8)
+                return;
 
-                this->createDefaultEntry(hex::format("{:e} (0x{:0{}X})", *reinterpret_cast<float*>(&data), data, this->getSize() * 2), *reinterpret_cast<float*>(&data));
-            } else if (this->getSize() == 8) {
-                u64 data = 0;
-                provider->read(this->getOffset(), &data, 8);
-                data = hex::changeEndianess(data, 8, this->getEndian());
+            this->createDefaultEntry(provider, [&, this] {
+                if (this->getSize() == 4) {
+                    u32 data = 0;
+                    provider->readCached(this->getOffset(), &data, 4);
+                    data = hex::changeEndianess(data, 4, this->getEndian());
 
-                this->createDefaultEntry(hex::format("{:e} (0x{:0{}X})", *reinterpret_cast<double*>(&data), data, this->getSize() * 2), *reinterpret_cast<double*>(&data));
-            }
+                    return std::pair<std::string, Token::Literal>{ hex::format("{:e} (0x{:0{}X})", *reinterpret_cast<float*>(&data), data, this->getSize() * 2), *reinterpret_cast<float*>(&data) };
+                } else {
+                    u64 data = 0;
+                    provider->readCached(this->getOffset(), &data, 8);
+                    data = hex::changeEndianess(data, 8, this->getEndian());
+
+                    return std::pair<std::string, Token::Literal>{ hex::format("{:e} (0x{:0{}X})", *reinterpret_cast<double*>(&data), data, this->getSize() * 2), *reinterpret_cast<double*>(&data) };
+                }
+            });
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -503,15 +644,17 @@ namespace hex::pl {
         }
 
         void createEntry(prv::Provider* &provider) override {
-            u8 boolean;
-            provider->read(this->getOffset(), &boolean, 1);
-
-            if (boolean == 0)
-                this->createDefaultEntry("false", false);
-            else if (boolean == 1)
-                this->createDefaultEntry("true", true);
-            else
-                this->createDefaultEntry("true*", true);
+            this->createDefaultEntry(provider, [&, this] {
+                u8 boolean;
+                provider->readCached(this->getOffset(), &boolean, 1);
+
+                if (boolean == 0)
+                    return std::pair<std::string, Token::Literal>{ "false", false };
+                else if (boolean == 1)
+                    return std::pair<std::string, Token::Literal>{ "true", true };
+                else
+                    return std::pair<std::string, Token::Literal>{ "true*", true };
+            });
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -531,10 +674,12 @@ namespace hex::pl {
         }
 
         void createEntry(prv::Provider* &provider) override {
-            char character;
-            provider->read(this->getOffset(), &character, 1);
+            this->createDefaultEntry(provider, [&, this] {
+                char character;
+                provider->readCached(this->getOffset(), &character, 1);
 
-            this->createDefaultEntry(hex::format("'{0}'", character), character);
+                return std::pair<std::string, Token::Literal>{ hex::format("'{0}'", character), character };
+            });
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -554,12 +699,14 @@ namespace hex::pl {
         }
 
         void createEntry(prv::Provider* &provider) override {
-            char16_t character;
-            provider->read(this->getOffset(), &character, 2);
-            character = hex::changeEndianess(character, this->getEndian());
+            this->createDefaultEntry(provider, [&, this] {
+                char16_t character;
+                provider->readCached(this->getOffset(), &character, 2);
+                character = hex::changeEndianess(character, this->getEndian());
 
-            u128 literal = character;
-            this->createDefaultEntry(hex::format("'{0}'", std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>{}.to_bytes(character)), literal);
+                u128 literal = character;
+                return std::pair<std::string, Token::Literal>{ hex::format("'{0}'", std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>{}.to_bytes(character)), literal };
+            });
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -579,10 +726,12 @@ namespace hex::pl {
         }
 
         void createEntry(prv::Provider* &provider) override {
-            std::string buffer(this->getSize(), 0x00);
-            provider->read(this->getOffset(), buffer.data(), this->getSize());
+            this->createDefaultEntry(provider, [&, this] {
+                std::string buffer(this->getSize(), 0x00);
+                provider->readCached(this->getOffset(), buffer.data(), this->getSize());
 
-            this->createDefaultEntry(hex::format("\"{0}\"", makeDisplayable(buffer.data(), this->getSize()).c_str()), buffer);
+                return std::pair<std::string, Token::Literal>{ hex::format("\"{0}\"", makeDisplayable(buffer.data(), this->getSize()).c_str()), buffer };
+            });
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -602,15 +751,17 @@ namespace hex::pl {
         }
 
         void createEntry(prv::Provider* &provider) override {
-            std::u16string buffer(this->getSize(), 0x00);
-            provider->read(this->getOffset(), buffer.data(), this->getSize());
+            this->createDefaultEntry(provider, [&, this] {
+                std::u16string buffer(this->getSize(), 0x00);
+                provider->readCached(this->getOffset(), buffer.data(), this->getSize());
 
-            for (auto &c : buffer)
-                c = hex::changeEndianess(c, 2, this->getEndian());
+                for (auto &c : buffer)
+                    c = hex::changeEndianess(c, 2, this->getEndian());
 
-            auto utf8String = std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>{}.to_bytes(buffer);
+                auto utf8String = std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>{}.to_bytes(buffer);
 
-            this->createDefaultEntry(hex::format("\"{0}\"", utf8String), utf8String);
+                return std::pair<std::string, Token::Literal>{ hex::format("\"{0}\"", utf8String), utf8String };
+            });
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -622,6 +773,9 @@ namespace hex::pl {
 
     class PatternDataDynamicArray : public PatternData {
     public:
+        /* Decodes the entry with the given index at the given offset. Returns nullptr if that's not possible */
+        using EntryDecoder = std::function<PatternData*(u64 index, u64 offset, u32 paletteOffset)>;
+
         PatternDataDynamicArray(u64 offset, size_t size, u32 color = 0)
             : PatternData(offset, size, color) {
         }
@@ -632,11 +786,19 @@ namespace hex::pl {
                 entries.push_back(entry->clone());
 
             this->setEntries(entries);
+
+            this->m_entryOffsets = other.m_entryOffsets;
+            this->m_entryPaletteOffsets = other.m_entryPaletteOffsets;
+            this->m_entryHighlightedRanges = other.m_entryHighlightedRanges;
+            this->m_entryDecoder = other.m_entryDecoder;
         }
 
         ~PatternDataDynamicArray() override {
             for (const auto &entry : this->m_entries)
                 delete entry;
+
+            for (const auto &[index, entry] : this->m_decodedEntries)
+                delete entry;
         }
 
         PatternData* clone() override {
@@ -648,16 +810,28 @@ namespace hex::pl {
                 entry->setOffset(offset + (entry->getOffset() - this->getOffset()));
             }
 
+            for (auto &entryOffset : this->m_entryOffsets)
+                entryOffset = offset + (entryOffset - this->getOffset());
+
+            for (auto &range : this->m_entryHighlightedRanges) {
+                range.start = offset + (range.start - this->getOffset());
+                range.end = offset + (range.end - this->getOffset());
+            }
+
+            std::scoped_lock lock(this->m_decodedEntriesMutex);
+            for (auto &[index, entry] : this->m_decodedEntries)
+                entry->setOffset(offset + (entry->getOffset() - this->getOffset()));
+
             PatternData::setOffset(offset);
         }
 
         void createEntry(prv::Provider* &provider) override {
-            if (this->m_entries.empty())
+            if (this->getEntryCount() == 0)
                 return;
 
             ImGui::TableNextRow();
             ImGui::TableNextColumn();
-            bool open = ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap);
+            ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_AllowItemOverlap);
             this->drawCommentTooltip();
             ImGui::TableNextColumn();
             ImGui::ColorButton("color", ImColor(this->getColor()), ImGuiColorEditFlags_NoTooltip, ImVec2(ImGui::GetColumnWidth(), ImGui::GetTextLineHeight()));
@@ -666,27 +840,54 @@ namespace hex::pl {
             ImGui::TableNextColumn();
             ImGui::Text("0x%04llX", this->getSize());
             ImGui::TableNextColumn();
-            ImGui::TextColored(ImColor(0xFF9BC64D), "%s", this->m_entries[0]->getTypeName().c_str());
+            ImGui::TextColored(ImColor(0xFF9BC64D), "%s", this->getEntryTypeName().c_str());
             ImGui::SameLine(0, 0);
 
             ImGui::TextUnformatted("[");
             ImGui::SameLine(0, 0);
-            ImGui::TextColored(ImColor(0xFF00FF00), "%llu", this->m_entries.size());
+            ImGui::TextColored(ImColor(0xFF00FF00), "%llu", this->getEntryCount());
             ImGui::SameLine(0, 0);
             ImGui::TextUnformatted("]");
 
             ImGui::TableNextColumn();
             ImGui::Text("%s", "{ ... }");
+        }
 
-            if (open) {
-                for (auto &member : this->m_entries)
-                    member->draw(provider);
+        [[nodiscard]] bool hasEntry() const override { return !this->isHidden() && this->getEntryCount() != 0; }
 
-                ImGui::TreePop();
-            }
+        [[nodiscard]] u64 getChildCount() const override { return this->getEntryCount(); }
+        [[nodiscard]] PatternData* getChild(u64 index) const override { return this->getEntry(index); }
+
+        [[nodiscard]] std::optional<u64> findChild(u64 offset) const override {
+            if (offset < this->getOffset() || offset >= this->getOffset() + this->getSize() || this->getEntryCount() == 0)
+                return { };
+
+            // Entries are laid out one after another so the last one starting before the offset contains it
+            u64 index;
+            if (this->isLazy())
+                index = std::distance(this->m_entryOffsets.begin(), std::upper_bound(this->m_entryOffsets.begin(), this->m_entryOffsets.end(), offset));
+            else
+                index = std::distance(this->m_entries.begin(), std::partition_point(this->m_entries.begin(), this->m_entries.end(), [offset](PatternData *entry) { return entry->getOffset() <= offset; }));
+
+            if (index == 0)
+                return { };
+            else
+                return index - 1;
         }
 
         std::optional<u32> highlightBytes(size_t offset) override{
+            if (this->isLazy()) {
+                // Entries are laid out one after another so only the one containing the offset needs to be decoded
+                auto nextEntry = std::upper_bound(this->m_entryOffsets.begin(), this->m_entryOffsets.end(), offset);
+                if (nextEntry == this->m_entryOffsets.begin())
+                    return { };
+
+                if (auto entry = this->getEntry(std::distance(this->m_entryOffsets.begin(), nextEntry) - 1); entry != nullptr)
+                    return entry->highlightBytes(offset);
+                else
+                    return { };
+            }
+
             for (auto &entry : this->m_entries) {
                 if (auto color = entry->highlightBytes(offset); color.has_value())
                     return color.value();
@@ -695,28 +896,80 @@ namespace hex::pl {
             return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
-                for (auto &entry : this->m_entries) {
-                    this->m_highlightedAddresses.merge(entry->getHighlightedAddresses());
-                }
+        std::vector<HighlightedRange> getHighlightedRanges() override {
+            // Entries of lazy arrays aren't decoded for this, their ranges were kept when they got evaluated
+            if (this->isLazy())
+                return this->m_entryHighlightedRanges;
+
+            if (this->m_highlightedRanges.empty()) {
+                for (auto &entry : this->m_entries)
+                    this->addHighlightedRanges(entry);
             }
 
-            return this->m_highlightedAddresses;
+            return this->m_highlightedRanges;
         }
 
-        void clearHighlightedAddresses() override {
+        void clearHighlightedRanges() override {
             for (auto &entry : this->m_entries)
-                entry->clearHighlightedAddresses();
-            PatternData::clearHighlightedAddresses();
+                entry->clearHighlightedRanges();
+
+            std::scoped_lock lock(this->m_decodedEntriesMutex);
+            for (auto &[index, entry] : this->m_decodedEntries)
+                entry->clearHighlightedRanges();
+            PatternData::clearHighlightedRanges();
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
-            return this->m_entries[0]->getTypeName() + "[" + std::to_string(this->m_entries.size()) + "]";
+            return this->getEntryTypeName() + "[" + std::to_string(this->getEntryCount()) + "]";
+        }
+
+        [[nodiscard]] bool isLazy() const {
+            return this->m_entryDecoder != nullptr;
+        }
+
+        [[nodiscard]] u64 getEntryCount() const {
+            return this->isLazy() ? this->m_entryOffsets.size() : this->m_entries.size();
         }
 
-        [[nodiscard]] const std::vector<PatternData*>& getEntries() {
-            return this->m_entries;
+        /* Entries of lazy arrays get decoded the first time they're accessed. Returns nullptr if decoding failed */
+        [[nodiscard]] PatternData* getEntry(u64 index) const {
+            if (!this->isLazy())
+                return this->m_entries[index];
+
+            if (auto entry = this->findDecodedEntry(index); entry != nullptr)
+                return entry;
+
+            // Decoding can take a while, another thread might have decoded the same entry in the meantime
+            auto entry = this->decodeEntry(index);
+            if (entry == nullptr)
+                return nullptr;
+
+            std::scoped_lock lock(this->m_decodedEntriesMutex);
+            auto [decodedEntry, inserted] = this->m_decodedEntries.emplace(index, entry);
+            if (!inserted)
+                delete entry;
+
+            return decodedEntry->second;
+        }
+
+        /* Calls the callback with every entry in order. Entries of lazy arrays that haven't been decoded yet are only decoded temporarily */
+        void forEachEntry(const std::function<void(u64, PatternData*)> &callback) const {
+            if (!this->isLazy()) {
+                for (u64 i = 0; i < this->m_entries.size(); i++)
+                    callback(i, this->m_entries[i]);
+
+                return;
+            }
+
+            for (u64 i = 0; i < this->m_entryOffsets.size(); i++) {
+                if (auto entry = this->findDecodedEntry(i); entry != nullptr)
+                    callback(i, entry);
+                else {
+                    auto decodedEntry = this->decodeEntry(i);
+                    callback(i, decodedEntry);
+                    delete decodedEntry;
+                }
+            }
         }
 
         void setEntries(const std::vector<PatternData*> &entries) {
@@ -728,16 +981,25 @@ namespace hex::pl {
             }
         }
 
+        /* Only remembers where the entries are located and which ranges they highlight. They're decoded again using the decoder once they're needed */
+        void setLazyEntries(std::vector<u64> entryOffsets, std::vector<u8> entryPaletteOffsets, std::vector<HighlightedRange> entryHighlightedRanges, EntryDecoder decoder) {
+            this->m_entryOffsets = std::move(entryOffsets);
+            this->m_entryPaletteOffsets = std::move(entryPaletteOffsets);
+            this->m_entryHighlightedRanges = std::move(entryHighlightedRanges);
+            this->m_entryDecoder = std::move(decoder);
+        }
+
         [[nodiscard]] bool operator==(const PatternData &other) const override {
             if (!areCommonPropertiesEqual<decltype(*this)>(other))
                 return false;
 
             auto &otherArray = *static_cast<const PatternDataDynamicArray*>(&other);
-            if (this->m_entries.size() != otherArray.m_entries.size())
+            if (this->getEntryCount() != otherArray.getEntryCount())
                 return false;
 
-            for (u64 i = 0; i < this->m_entries.size(); i++) {
-                if (*this->m_entries[i] != *otherArray.m_entries[i])
+            for (u64 i = 0; i < this->getEntryCount(); i++) {
+                auto entry = this->getEntry(i), otherEntry = otherArray.getEntry(i);
+                if (entry == nullptr || otherEntry == nullptr || *entry != *otherEntry)
                     return false;
             }
 
@@ -745,7 +1007,41 @@ namespace hex::pl {
         }
 
     private:
+        [[nodiscard]] PatternData* findDecodedEntry(u64 index) const {
+            std::scoped_lock lock(this->m_decodedEntriesMutex);
+
+            if (auto entry = this->m_decodedEntries.find(index); entry != this->m_decodedEntries.end())
+                return entry->second;
+            else
+                return nullptr;
+        }
+
+        [[nodiscard]] PatternData* decodeEntry(u64 index) const {
+            auto entry = this->m_entryDecoder(index, this->m_entryOffsets[index], this->m_entryPaletteOffsets[index]);
+            if (entry != nullptr)
+                entry->setParent(const_cast<PatternDataDynamicArray*>(this));
+
+            return entry;
+        }
+
+        [[nodiscard]] std::string getEntryTypeName() const {
+            if (this->getEntryCount() == 0)
+                return this->getTypeName();
+            else if (auto entry = this->getEntry(0); entry != nullptr)
+                return entry->getTypeName();
+            else
+                return this->getTypeName();
+        }
+
         std::vector<PatternData*> m_entries;
+
+        std::vector<u64> m_entryOffsets;
+        std::vector<u8> m_entryPaletteOffsets;
+        std::vector<HighlightedRange> m_entryHighlightedRanges;
+        EntryDecoder m_entryDecoder;
+        /* Entries can be decoded from multiple threads at once, decoded ones stay around until the array is deleted */
+        mutable std::mutex m_decodedEntriesMutex;
+        mutable std::map<u64, PatternData*> m_decodedEntries;
     };
 
     class PatternDataStaticArray : public PatternData {
@@ -760,6 +1056,11 @@ namespace hex::pl {
 
         ~PatternDataStaticArray() override {
             delete this->m_template;
+
+            for (const auto &[index, entry] : this->m_createdEntries)
+                delete entry;
+            for (const auto &[index, entry] : this->m_drawnEntries)
+                delete entry.pattern;
         }
 
         PatternData* clone() override {
@@ -772,7 +1073,7 @@ namespace hex::pl {
 
             ImGui::TableNextRow();
             ImGui::TableNextColumn();
-            bool open = ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap);
+            ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_AllowItemOverlap);
             this->drawCommentTooltip();
             ImGui::TableNextColumn();
             ImGui::ColorButton("color", ImColor(this->getColor()), ImGuiColorEditFlags_NoTooltip, ImVec2(ImGui::GetColumnWidth(), ImGui::GetTextLineHeight()));
@@ -792,18 +1093,75 @@ namespace hex::pl {
 
             ImGui::TableNextColumn();
             ImGui::Text("%s", "{ ... }");
+        }
 
-            if (open) {
-                auto entry = this->m_template->clone();
-                for (u64 index = 0; index < this->m_entryCount; index++) {
-                    entry->setVariableName(hex::format("[{0}]", index));
-                    entry->setOffset(this->getOffset() + index * this->m_template->getSize());
-                    entry->draw(provider);
+        [[nodiscard]] bool hasEntry() const override { return !this->isHidden() && this->m_entryCount != 0; }
+
+        [[nodiscard]] u64 getChildCount() const override { return this->m_entryCount; }
+
+        /* Entries only exist once they've been asked for. Ones handed out here stay around until the array gets deleted */
+        [[nodiscard]] PatternData* getChild(u64 index) const override {
+            if (auto entry = this->m_createdEntries.find(index); entry != this->m_createdEntries.end())
+                return entry->second;
+
+            // Entries that were only drawn so far aren't referenced from anywhere else and can simply be taken over
+            PatternData *entry;
+            if (auto drawnEntry = this->m_drawnEntries.find(index); drawnEntry != this->m_drawnEntries.end()) {
+                entry = drawnEntry->second.pattern;
+                this->m_drawnEntries.erase(drawnEntry);
+            } else {
+                entry = this->instantiateEntry(index);
+            }
+
+            return this->m_createdEntries.emplace(index, entry).first->second;
+        }
+
+        /* Entries that are only drawn never leave the array so only the most recently drawn ones are kept for their formatted values */
+        void drawChild(prv::Provider* &provider, u64 index) override {
+            if (index >= this->m_entryCount) {
+                ImGui::TableNextRow();
+                return;
+            }
+
+            if (auto entry = this->m_createdEntries.find(index); entry != this->m_createdEntries.end()) {
+                entry->second->draw(provider);
+                return;
+            }
+
+            this->m_drawnEntryUseCount++;
+
+            auto drawnEntry = this->m_drawnEntries.find(index);
+            if (drawnEntry == this->m_drawnEntries.end()) {
+                if (this->m_drawnEntries.size() >= MaxDrawnEntries) {
+                    auto leastRecentlyUsed = std::min_element(this->m_drawnEntries.begin(), this->m_drawnEntries.end(), [](const auto &left, const auto &right) {
+                        return left.second.lastUse < right.second.lastUse;
+                    });
+
+                    delete leastRecentlyUsed->second.pattern;
+                    this->m_drawnEntries.erase(leastRecentlyUsed);
                 }
-                delete entry;
 
-                ImGui::TreePop();
+                drawnEntry = this->m_drawnEntries.emplace(index, DrawnEntry { this->instantiateEntry(index), 0 }).first;
             }
+
+            drawnEntry->second.lastUse = this->m_drawnEntryUseCount;
+            drawnEntry->second.pattern->draw(provider);
+        }
+
+        [[nodiscard]] std::optional<u64> findChild(u64 offset) const override {
+            if (offset < this->getOffset() || offset >= this->getOffset() + this->getSize() || this->m_template->getSize() == 0)
+                return { };
+
+            return std::min<u64>((offset - this->getOffset()) / this->m_template->getSize(), this->m_entryCount - 1);
+        }
+
+        void setOffset(u64 offset) override {
+            for (auto &[index, entry] : this->m_createdEntries)
+                entry->setOffset(offset + (entry->getOffset() - this->getOffset()));
+            for (auto &[index, entry] : this->m_drawnEntries)
+                entry.pattern->setOffset(offset + (entry.pattern->getOffset() - this->getOffset()));
+
+            PatternData::setOffset(offset);
         }
 
         std::optional<u32> highlightBytes(size_t offset) override{
@@ -820,25 +1178,32 @@ namespace hex::pl {
             return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
+        std::vector<HighlightedRange> getHighlightedRanges() override {
+            if (this->m_highlightedRanges.empty()) {
                 auto entry = this->m_template->clone();
+                entry->setOffset(this->getOffset());
 
-                for (u64 address = this->getOffset(); address < this->getOffset() + this->getSize(); address += this->m_template->getSize()) {
-                    entry->setOffset(address);
-                    entry->clearHighlightedAddresses();
-                    this->m_highlightedAddresses.merge(entry->getHighlightedAddresses());
+                // Entries that are highlighted in a single colour from start to end collapse into one range spanning the whole array
+                auto entryRanges = entry->getHighlightedRanges();
+                if (entryRanges.size() == 1 && entryRanges.front().start == entry->getOffset() && entryRanges.front().end == entry->getOffset() + entry->getSize()) {
+                    this->m_highlightedRanges.push_back({ this->getOffset(), this->getOffset() + this->getSize(), entryRanges.front().color });
+                } else {
+                    for (u64 address = this->getOffset(); address < this->getOffset() + this->getSize(); address += this->m_template->getSize()) {
+                        entry->setOffset(address);
+                        entry->clearHighlightedRanges();
+                        this->addHighlightedRanges(entry);
+                    }
                 }
 
                 delete entry;
             }
 
-            return this->m_highlightedAddresses;
+            return this->m_highlightedRanges;
         }
 
-        void clearHighlightedAddresses() override {
-            this->m_template->clearHighlightedAddresses();
-            PatternData::clearHighlightedAddresses();
+        void clearHighlightedRanges() override {
+            this->m_template->clearHighlightedRanges();
+            PatternData::clearHighlightedRanges();
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -875,8 +1240,26 @@ namespace hex::pl {
         }
 
     private:
+        [[nodiscard]] PatternData* instantiateEntry(u64 index) const {
+            auto entry = this->m_template->clone();
+            entry->setVariableName(hex::format("[{0}]", index));
+            entry->setOffset(this->getOffset() + index * this->m_template->getSize());
+
+            return entry;
+        }
+
+        constexpr static size_t MaxDrawnEntries = 0x400;
+
+        struct DrawnEntry {
+            PatternData *pattern;
+            u64 lastUse;
+        };
+
         PatternData *m_template;
         size_t m_entryCount;
+        mutable std::map<u64, PatternData*> m_createdEntries;
+        mutable std::map<u64, DrawnEntry> m_drawnEntries;
+        u64 m_drawnEntryUseCount = 0;
     };
 
     class PatternDataStruct : public PatternData {
@@ -885,8 +1268,10 @@ namespace hex::pl {
         }
 
         PatternDataStruct(const PatternDataStruct &other) : PatternData(other) {
-            for (const auto &member : other.m_members)
+            for (const auto &member : other.m_members) {
                 this->m_members.push_back(member->clone());
+                this->m_members.back()->setParent(this);
+            }
             this->m_sortedMembers = this->m_members;
         }
 
@@ -910,7 +1295,7 @@ namespace hex::pl {
         void createEntry(prv::Provider* &provider) override {
             ImGui::TableNextRow();
             ImGui::TableNextColumn();
-            bool open = ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth);
+            ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_NoTreePushOnOpen);
             this->drawCommentTooltip();
             ImGui::TableNextColumn();
             ImGui::TableNextColumn();
@@ -921,16 +1306,11 @@ namespace hex::pl {
             ImGui::TextColored(ImColor(0xFFD69C56), "struct"); ImGui::SameLine(); ImGui::Text("%s", this->getTypeName().c_str());
             ImGui::TableNextColumn();
             ImGui::Text("%s", "{ ... }");
-
-            if (open) {
-                for (auto &member : this->m_sortedMembers)
-                    member->draw(provider);
-
-                ImGui::TreePop();
-            }
-
         }
 
+        [[nodiscard]] u64 getChildCount() const override { return this->m_sortedMembers.size(); }
+        [[nodiscard]] PatternData* getChild(u64 index) const override { return this->m_sortedMembers[index]; }
+
         std::optional<u32> highlightBytes(size_t offset) override{
             for (auto &member : this->m_members) {
                 if (auto color = member->highlightBytes(offset); color.has_value())
@@ -940,28 +1320,27 @@ namespace hex::pl {
             return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
-                for (auto &member : this->m_members) {
-                    this->m_highlightedAddresses.merge(member->getHighlightedAddresses());
-                }
+        std::vector<HighlightedRange> getHighlightedRanges() override {
+            if (this->m_highlightedRanges.empty()) {
+                for (auto &member : this->m_members)
+                    this->addHighlightedRanges(member);
             }
 
-            return this->m_highlightedAddresses;
+            return this->m_highlightedRanges;
         }
 
-        void clearHighlightedAddresses() override {
+        void clearHighlightedRanges() override {
             for (auto &member : this->m_members)
-                member->clearHighlightedAddresses();
-            PatternData::clearHighlightedAddresses();
+                member->clearHighlightedRanges();
+            PatternData::clearHighlightedRanges();
         }
 
         void sort(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider) override {
-            this->m_sortedMembers = this->m_members;
+            if (!this->m_sortState.update(sortSpecs, provider, this->getOffset(), this->getSize()))
+                return;
 
-            std::sort(this->m_sortedMembers.begin(), this->m_sortedMembers.end(), [&sortSpecs, &provider](PatternData *left, PatternData *right) {
-                return PatternData::sortPatternDataTable(sortSpecs, provider, left, right);
-            });
+            this->m_sortedMembers = this->m_members;
+            PatternData::sortPatterns(sortSpecs, provider, this->m_sortedMembers);
 
             for (auto &member : this->m_members)
                 member->sort(sortSpecs, provider);
@@ -986,6 +1365,7 @@ namespace hex::pl {
             }
 
             this->m_sortedMembers = this->m_members;
+            this->m_sortState.reset();
         }
 
         [[nodiscard]] bool operator==(const PatternData &other) const override {
@@ -1007,6 +1387,7 @@ namespace hex::pl {
     private:
         std::vector<PatternData*> m_members;
         std::vector<PatternData*> m_sortedMembers;
+        SortState m_sortState;
     };
 
     class PatternDataUnion : public PatternData {
@@ -1016,8 +1397,10 @@ namespace hex::pl {
         }
 
         PatternDataUnion(const PatternDataUnion &other) : PatternData(other) {
-            for (const auto &member : other.m_members)
+            for (const auto &member : other.m_members) {
                 this->m_members.push_back(member->clone());
+                this->m_members.back()->setParent(this);
+            }
             this->m_sortedMembers = this->m_members;
         }
 
@@ -1041,7 +1424,7 @@ namespace hex::pl {
         void createEntry(prv::Provider* &provider) override {
             ImGui::TableNextRow();
             ImGui::TableNextColumn();
-            bool open = ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap);
+            ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_AllowItemOverlap);
             this->drawCommentTooltip();
             ImGui::TableNextColumn();
             ImGui::TableNextColumn();
@@ -1053,16 +1436,11 @@ namespace hex::pl {
 
             ImGui::TableNextColumn();
             ImGui::Text("%s", "{ ... }");
-
-            if (open) {
-                for (auto &member : this->m_sortedMembers)
-                    member->draw(provider);
-
-                ImGui::TreePop();
-            }
-
         }
 
+        [[nodiscard]] u64 getChildCount() const override { return this->m_sortedMembers.size(); }
+        [[nodiscard]] PatternData* getChild(u64 index) const override { return this->m_sortedMembers[index]; }
+
         std::optional<u32> highlightBytes(size_t offset) override{
             for (auto &member : this->m_members) {
                 if (auto color = member->highlightBytes(offset); color.has_value())
@@ -1072,28 +1450,27 @@ namespace hex::pl {
             return { };
         }
 
-        std::map<u64, u32> getHighlightedAddresses() override {
-            if (this->m_highlightedAddresses.empty()) {
-                for (auto &member : this->m_members) {
-                    this->m_highlightedAddresses.merge(member->getHighlightedAddresses());
-                }
+        std::vector<HighlightedRange> getHighlightedRanges() override {
+            if (this->m_highlightedRanges.empty()) {
+                for (auto &member : this->m_members)
+                    this->addHighlightedRanges(member);
             }
 
-            return this->m_highlightedAddresses;
+            return this->m_highlightedRanges;
         }
 
-        void clearHighlightedAddresses() override {
+        void clearHighlightedRanges() override {
             for (auto &member : this->m_members)
-                member->clearHighlightedAddresses();
-            PatternData::clearHighlightedAddresses();
+                member->clearHighlightedRanges();
+            PatternData::clearHighlightedRanges();
         }
 
         void sort(ImGuiTableSortSpecs *sortSpecs, prv::Provider *provider) override {
-            this->m_sortedMembers = this->m_members;
+            if (!this->m_sortState.update(sortSpecs, provider, this->getOffset(), this->getSize()))
+                return;
 
-            std::sort(this->m_sortedMembers.begin(), this->m_sortedMembers.end(), [&sortSpecs, &provider](PatternData *left, PatternData *right) {
-                return PatternData::sortPatternDataTable(sortSpecs, provider, left, right);
-            });
+            this->m_sortedMembers = this->m_members;
+            PatternData::sortPatterns(sortSpecs, provider, this->m_sortedMembers);
 
             for (auto &member : this->m_members)
                 member->sort(sortSpecs, provider);
@@ -1117,6 +1494,7 @@ namespace hex::pl {
             }
 
             this->m_sortedMembers = this->m_members;
+            this->m_sortState.reset();
         }
 
         [[nodiscard]] bool operator==(const PatternData &other) const override {
@@ -1138,6 +1516,7 @@ namespace hex::pl {
     private:
         std::vector<PatternData*> m_members;
         std::vector<PatternData*> m_sortedMembers;
+        SortState m_sortState;
     };
 
     class PatternDataEnum : public PatternData {
@@ -1151,33 +1530,37 @@ namespace hex::pl {
         }
 
         void createEntry(prv::Provider* &provider) override {
-            u64 value = 0;
-            provider->read(this->getOffset(), &value, this->getSize());
-            value = hex::changeEndianess(value, this->getSize(), this->getEndian());
-
-            std::string valueString = PatternData::getTypeName() + "::";
-
-            bool foundValue = false;
-            for (auto &[entryValueLiteral, entryName] : this->m_enumValues) {
-                bool matches = std::visit(overloaded {
-                    [&, name = entryName](auto &&entryValue) {
-                        if (value == entryValue) {
-                            valueString += name;
-                            foundValue = true;
-                            return true;
-                        }
-
-                        return false;
-                    },
-                    [](std::string) { return false; },
-                    [](PatternData*) { return false; }
-                }, entryValueLiteral);
-                if (matches)
-                    break;
-            }
+            const auto &displayValue = this->getDisplayValue(provider, [&, this] {
+                u64 value = 0;
+                provider->readCached(this->getOffset(), &value, this->getSize());
+                value = hex::changeEndianess(value, this->getSize(), this->getEndian());
+
+                std::string valueString = PatternData::getTypeName() + "::";
+
+                bool foundValue = false;
+                for (auto &[entryValueLiteral, entryName] : this->m_enumValues) {
+                    bool matches = std::visit(overloaded {
+                        [&, name = entryName](auto &&entryValue) {
+                            if (value == entryValue) {
+                                valueString += name;
+                                foundValue = true;
+                                return true;
+                            }
+
+                            return false;
+                        },
+                        [](std::string) { return false; },
+                        [](PatternData*) { return false; }
+                    }, entryValueLiteral);
+                    if (matches)
+                        break;
+                }
 
-            if (!foundValue)
-                valueString += "???";
+                if (!foundValue)
+                    valueString += "???";
+
+                return hex::format("{} (0x{:0{}X})", valueString.c_str(), value, this->getSize() * 2);
+            });
 
             ImGui::TableNextRow();
             ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap);
@@ -1197,7 +1580,7 @@ namespace hex::pl {
             ImGui::TableNextColumn();
             ImGui::TextColored(ImColor(0xFFD69C56), "enum"); ImGui::SameLine(); ImGui::Text("%s", PatternData::getTypeName().c_str());
             ImGui::TableNextColumn();
-            ImGui::Text("%s", hex::format("{} (0x{:0{}X})", valueString.c_str(), value, this->getSize() * 2).c_str());
+            ImGui::Text("%s", displayValue.c_str());
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
@@ -1245,11 +1628,7 @@ namespace hex::pl {
         }
 
         void createEntry(prv::Provider* &provider) override {
-            std::vector<u8> value(this->getParent()->getSize(), 0);
-            provider->read(this->getParent()->getOffset(), &value[0], value.size());
-
-            if (this->getParent()->getEndian() == std::endian::little)
-                std::reverse(value.begin(), value.end());
+            const auto &displayValue = this->getValueString(provider);
 
             ImGui::TableNextRow();
             ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap);
@@ -1270,19 +1649,26 @@ namespace hex::pl {
             ImGui::TableNextColumn();
             ImGui::TextColored(ImColor(0xFF9BC64D), "bits");
             ImGui::TableNextColumn();
-            {
-                u8 numBytes = (this->m_bitSize / 8) + 1;
-
-                u64 extractedValue = hex::extract(this->m_bitOffset + (this->m_bitSize - 1), this->m_bitOffset, value);
-                ImGui::Text("%llu (0x%llX)", extractedValue, extractedValue);
-            }
-
+            ImGui::Text("%s", displayValue.c_str());
         }
 
         [[nodiscard]] std::string getFormattedName() const override {
             return "bits";
         }
 
+        [[nodiscard]] const std::string& getValueString(prv::Provider *provider) {
+            return this->getDisplayValue(provider, [&, this] {
+                std::vector<u8> value(this->getParent()->getSize(), 0);
+                provider->readCached(this->getParent()->getOffset(), &value[0], value.size());
+
+                if (this->getParent()->getEndian() == std::endian::little)
+                    std::reverse(value.begin(), value.end());
+
+                u64 extractedValue = hex::extract(this->m_bitOffset + (this->m_bitSize - 1), this->m_bitOffset, value);
+                return hex::format("{0} (0x{0:X})", extractedValue);
+            });
+        }
+
         [[nodiscard]] u8 getBitOffset() const {
             return this->m_bitOffset;
         }
@@ -1299,6 +1685,12 @@ namespace hex::pl {
             return this->m_bitOffset == otherBitfieldField.m_bitOffset && this->m_bitSize == otherBitfieldField.m_bitSize;
         }
 
+    protected:
+        // Fields have no size of their own, their value gets extracted from the whole bitfield
+        [[nodiscard]] std::pair<u64, size_t> getValueRegion() const override {
+            return { this->getParent()->getOffset(), this->getParent()->getSize() };
+        }
+
     private:
         u8 m_bitOffset, m_bitSize;
     };
@@ -1310,8 +1702,10 @@ namespace hex::pl {
         }
 
         PatternDataBitfield(const PatternDataBitfield &other) : PatternData(other) {
-            for (auto &field : other.m_fields)
+            for (auto &field : other.m_fields) {
                 this->m_fields.push_back(field->clone());
+                this->m_fields.back()->setParent(this);
+            }
         }
 
         ~PatternDataBitfield() override {
@@ -1324,15 +1718,24 @@ namespace hex::pl {
         }
 
         void createEntry(prv::Provider* &provider) override {
-            std::vector<u8> value(this->getSize(), 0);
-            provider->read(this->getOffset(), &value[0], value.size());
+            const auto &valueString = this->getDisplayValue(provider, [&, this] {
+                std::vector<u8> value(this->getSize(), 0);
+                provider->readCached(this->getOffset(), &value[0], value.size());
 
-            if (this->m_endian == std::endian::little)
-                std::reverse(value.begin(), value.end());
+                if (this->m_endian == std::endian::little)
+                    std::reverse(value.begin(), value.end());
+
+                std::string valueString = "{ ";
+                for (auto i : value)
+                    valueString += hex::format("{0:02X} ", i);
+                valueString += "}";
+
+                return valueString;
+            });
 
             ImGui::TableNextRow();
             ImGui::TableNextColumn();
-            bool open = ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_AllowItemOverlap);
+            ImGui::TreeNodeEx(this->getDisplayName().c_str(), ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_AllowItemOverlap);
             this->drawCommentTooltip();
             ImGui::TableNextColumn();
             ImGui::TableNextColumn();
@@ -1342,24 +1745,12 @@ namespace hex::pl {
             ImGui::TableNextColumn();
             ImGui::TextColored(ImColor(0xFFD69C56), "bitfield"); ImGui::SameLine(); ImGui::Text("%s", PatternData::getTypeName().c_str());
             ImGui::TableNextColumn();
-
-            std::string valueString = "{ ";
-            for (auto i : value)
-                valueString += hex::format("{0:02X} ", i);
-            valueString += "}";
-
             ImGui::TextUnformatted(valueString.c_str());
-
-            if (open) {
-
-                for (auto &field : this->m_fields)
-                    field->draw(provider);
-
-                ImGui::TreePop();
-            }
-
         }
 
+        [[nodiscard]] u64 getChildCount() const override { return this->m_fields.size(); }
+        [[nodiscard]] PatternData* getChild(u64 index) const override { return this->m_fields[index]; }
+
         [[nodiscard]] std::string getFormattedName() const override {
             return "bitfield " + PatternData::getTypeName();
         }
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <hex.hpp>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace hex { class File; }
+namespace hex::prv { class Provider; }
+
+namespace hex::pl {
+
+    class PatternData;
+
+    /* Writes the values of evaluated patterns to a file. Values are written out while walking the patterns and the data */
+    /* they're decoded from is read in large windows so neither depends on how many patterns get exported               */
+    class PatternExporter {
+    public:
+        enum class Format {
+            JSON,
+            CSV,
+            Binary
+        };
+
+        PatternExporter(prv::Provider *provider, Format format);
+
+        bool exportToFile(const std::vector<PatternData*> &patterns, const std::string &path);
+
+        /* Safe to run on another thread as long as nothing else touches the patterns. Stops and fails once cancelled gets set */
+        bool exportToFile(const std::vector<PatternData*> &patterns, const std::string &path, const std::atomic<bool> &cancelled);
+
+        [[nodiscard]] static const char* getFileExtension(Format format);
+
+    private:
+        struct Value {
+            std::string text;
+            bool quoted;
+        };
+
+        void exportJSON(PatternData *pattern, u32 indent);
+        void exportCSV(PatternData *pattern, const std::string &path);
+        void exportBinary(PatternData *pattern);
+
+        void exportValueArrayJSON(PatternData *templ, u64 offset, u64 entryCount, u32 indent);
+        void exportValueArrayCSV(PatternData *templ, u64 offset, u64 entryCount, const std::string &path);
+        void writeCSVRow(const std::string &path, PatternData *pattern, u64 offset, size_t size);
+
+        [[nodiscard]] Value formatValue(PatternData *pattern, const u8 *data) const;
+        void writeValue(PatternData *pattern, u64 offset);
+        void writeValue(const Value &value);
+        void writeLargeString(PatternData *pattern, u64 offset);
+
+        [[nodiscard]] const u8* readData(u64 offset, size_t size);
+        void writeData(u64 offset, size_t size);
+
+        void write(const std::string &string);
+        void flush();
+        [[nodiscard]] bool hasFailed() const;
+
+        prv::Provider *m_provider;
+        Format m_format;
+        u64 m_dataStart;
+
+        File *m_file = nullptr;
+        std::string m_outputBuffer;
+        bool m_writeFailed = false;
+        const std::atomic<bool> *m_cancelled = nullptr;
+
+        std::vector<u8> m_window;
+        u64 m_windowAddress = 0;
+        bool m_windowValid = false;
+    };
+
+}
@@ -3,6 +3,7 @@
 #include <hex.hpp>
 
 #include <bit>
+#include <map>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -20,6 +21,7 @@ namespace hex::pl {
     class Validator;
     class Evaluator;
     class PatternData;
+    class Arena;
 
     class ASTNode;
 
@@ -31,9 +33,17 @@ namespace hex::pl {
         std::optional<std::vector<PatternData*>> executeString(prv::Provider *provider, const std::string &string);
         std::optional<std::vector<PatternData*>> executeFile(prv::Provider *provider, const std::string &path);
 
+        /* Cancels a running evaluation and reports how far it got. Both can be called from any thread */
+        void abort();
+        [[nodiscard]] float getProgress() const;
+
         const std::vector<std::pair<LogConsole::Level, std::string>>& getConsoleLog();
         const std::optional<std::pair<u32, std::string>>& getError();
 
+        /* Base address the last pattern asked for through the base_address pragma. Running a pattern never changes the   */
+        /* provider, it's up to the caller to apply it there if the patterns should line up with the provider's addresses */
+        [[nodiscard]] const std::optional<u64>& getBaseAddress() const;
+
     private:
         Preprocessor *m_preprocessor;
         Lexer *m_lexer;
@@ -42,11 +52,19 @@ namespace hex::pl {
         Evaluator *m_evaluator;
 
         std::vector<ASTNode*> m_currAST;
+        std::map<u64, std::vector<ASTNode*>> m_cachedASTs;
+
+        Arena *m_astArena;
+        Arena *m_patternArena;
 
         prv::Provider *m_provider = nullptr;
+        std::optional<u64> m_baseAddress;
         std::endian m_defaultEndian = std::endian::native;
         u32 m_evalDepth;
         u32 m_arrayLimit;
+        u32 m_timeLimit;
+        u64 m_patternLimit;
+        u64 m_memoryLimit;
 
         std::optional<std::pair<u32, std::string>> m_currError;
     };
@@ -8,6 +8,7 @@
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace hex::pl {
 
@@ -29,11 +30,25 @@ namespace hex::pl {
             throw PreprocessorError(lineNumber, "Preprocessor: " + error);
         }
 
+        std::string preprocessInclude(const std::string &path, const std::string &code);
+
         std::unordered_map<std::string, std::function<bool(std::string)>> m_pragmaHandlers;
 
         std::set<std::tuple<std::string, std::string, u32>> m_defines;
         std::set<std::tuple<std::string, std::string, u32>> m_pragmas;
 
+        /* Included files are only preprocessed again once their content or the content of one of their own includes changed */
+        struct CachedInclude {
+            size_t contentHash;
+            std::string output;
+            std::set<std::tuple<std::string, std::string, u32>> defines;
+            std::set<std::tuple<std::string, std::string, u32>> pragmas;
+            std::vector<std::pair<std::string, size_t>> includes;
+        };
+
+        std::unordered_map<std::string, CachedInclude> m_includeCache;
+        std::vector<std::pair<std::string, size_t>> m_includedFiles;
+
         std::pair<u32, std::string> m_error;
     };
 
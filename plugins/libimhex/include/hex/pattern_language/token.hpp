@@ -114,17 +114,19 @@ namespace hex::pl {
             EndOfProgram
         };
 
+        /* Refers to a name interned by the lexer, copying it never copies the string itself */
         struct Identifier {
-            explicit Identifier(std::string identifier) : m_identifier(std::move(identifier)) { }
+            explicit Identifier(const std::string &identifier) : m_identifier(&identifier) { }
+            explicit Identifier(std::string &&identifier) = delete;
 
             [[nodiscard]]
-            const std::string &get() const { return this->m_identifier; }
+            const std::string &get() const { return *this->m_identifier; }
 
-            auto operator<=>(const Identifier&) const = default;
-            bool operator==(const Identifier&) const = default;
+            auto operator<=>(const Identifier &other) const { return this->get() <=> other.get(); }
+            bool operator==(const Identifier &other) const { return this->m_identifier == other.m_identifier || this->get() == other.get(); }
 
         private:
-            std::string m_identifier;
+            const std::string *m_identifier;
         };
 
         using Literal = std::variant<char, bool, u128, s128, double, std::string, PatternData*>;
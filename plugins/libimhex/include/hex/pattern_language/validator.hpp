@@ -2,12 +2,14 @@
 
 #include <hex.hpp>
 
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
-namespace hex::pl {
+#include <hex/pattern_language/ast_node.hpp>
 
-    class ASTNode;
+namespace hex::pl {
 
     class Validator {
     public:
@@ -15,11 +17,21 @@ namespace hex::pl {
 
         bool validate(const std::vector<ASTNode*>& ast);
 
+        /* Finds all types whose size and member offsets don't depend on the data they're placed on and stores their layout */
+        /* in their type declaration. Arrays of these types get created from a single template instead of entry by entry    */
+        void analyzeLayouts(const std::vector<ASTNode*> &ast);
+
         const std::pair<u32, std::string>& getError() { return this->m_error; }
 
     private:
         std::pair<u32, std::string> m_error;
 
+        using StaticLayout = ASTNodeTypeDecl::StaticLayout;
+        std::unordered_map<const ASTNode*, std::optional<StaticLayout>> m_layouts;
+
+        std::optional<StaticLayout> analyzeType(ASTNode *type);
+        std::optional<std::vector<u64>> analyzeMember(ASTNode *member);
+
         using ValidatorError = std::pair<u32, std::string>;
 
         [[noreturn]] void throwValidateError(std::string_view error, u32 lineNumber) const {
@@ -2,8 +2,14 @@
 
 #include <hex.hpp>
 
+#include <array>
+#include <atomic>
+#include <deque>
+#include <limits>
 #include <map>
+#include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
@@ -15,10 +21,14 @@ namespace hex::prv {
     class Provider {
     public:
         constexpr static size_t PageSize = 0x1000'0000;
+        constexpr static size_t CacheBlockSize = 0x1'0000;
 
         Provider();
         virtual ~Provider();
 
+        /* Unique among all providers ever created, unlike their address which gets reused once one has been deleted */
+        [[nodiscard]] u64 getID() const;
+
         virtual bool isAvailable() const = 0;
         virtual bool isReadable() const = 0;
         virtual bool isWritable() const = 0;
@@ -27,6 +37,16 @@ namespace hex::prv {
 
         virtual void read(u64 offset, void *buffer, size_t size, bool overlays = true);
         virtual void readRelative(u64 offset, void *buffer, size_t size, bool overlays = true);
+
+        /* Same as read() but goes through a small cache of aligned blocks. Meant for the many tiny reads patterns */
+        /* do, the cache gets dropped whenever the data changes                                                   */
+        void readCached(u64 offset, void *buffer, size_t size);
+
+        /* Reads from anywhere within the data no matter which page is currently selected. Offset 0 is the first byte of the */
+        /* data, patches get applied unless asked not to but overlays never do. Providers whose data can span multiple pages */
+        /* need to override this. Safe to call from other threads while the data gets changed                                */
+        virtual void readUnpaged(u64 offset, void *buffer, size_t size, bool withPatches = true);
+
         virtual void write(u64 offset, const void *buffer, size_t size);
         virtual void writeRelative(u64 offset, const void *buffer, size_t size);
 
@@ -69,13 +89,56 @@ namespace hex::prv {
         bool canUndo() const;
         bool canRedo() const;
 
+        /* Changes whenever the data returned by read() might have changed */
+        [[nodiscard]] u64 getDataVersion() const;
+        void markDataChanged();
+        void markDataChanged(u64 offset, size_t size);
+
+        /* Whether any data in the given region might have changed since the given data version */
+        [[nodiscard]] bool hasDataChanged(u64 offset, size_t size, u64 sinceVersion) const;
+
     protected:
+        /* Held shared by reads that may come from other threads and exclusively while the data or the patches change */
+        std::shared_mutex m_dataMutex;
+
         u32 m_currPage = 0;
         u64 m_baseAddress = 0;
 
+        std::atomic<u64> m_dataVersion = 0;
+
         u32 m_patchTreeOffset = 0;
         std::vector<std::map<u64, u8>> m_patches;
         std::list<Overlay*> m_overlays;
+
+    private:
+        const u64 m_id;
+
+        constexpr static size_t MaxTrackedDataChanges = 0x100;
+
+        struct DataChange {
+            u64 version;
+            u64 offset;
+            size_t size;
+        };
+
+        std::deque<DataChange> m_dataChanges;
+        u64 m_trackedSinceVersion = 0;
+
+        constexpr static size_t CacheBlockCount = 16;
+
+        struct CachedBlock {
+            u64 address;
+            u64 lastUse;
+            std::vector<u8> data;
+        };
+
+        /* Also guards the tracked data changes as those get looked at from other threads too */
+        mutable std::mutex m_cacheMutex;
+        std::array<CachedBlock, CacheBlockCount> m_cachedBlocks = { };
+        u64 m_cacheVersion = std::numeric_limits<u64>::max(), m_cacheUseCount = 0;
+        u64 m_cacheBaseAddress = 0, m_cacheDataSize = 0;
+
+        const CachedBlock& getCachedBlock(u64 address);
     };
 
 }
\ No newline at end of file
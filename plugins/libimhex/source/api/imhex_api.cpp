@@ -65,6 +65,9 @@ namespace hex {
     }
 
     void ImHexApi::Provider::remove(prv::Provider *provider) {
+        // Give everything that still uses the provider in the background a chance to stop first
+        EventManager::post<EventProviderDeleted>(provider);
+
         auto &providers = SharedData::providers;
 
         auto it = std::find(providers.begin(), providers.end(), provider);
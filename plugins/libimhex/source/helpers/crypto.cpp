@@ -13,8 +13,16 @@
 #include <mbedtls/aes.h>
 #include <mbedtls/cipher.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <mutex>
 #include <span>
+#include <string_view>
+#include <thread>
 
 #if MBEDTLS_VERSION_MAJOR <= 2
 
@@ -334,6 +342,966 @@ namespace hex::crypt {
     }
 
 
+    namespace {
+
+        template<typename T>
+        T readLittleEndian(const u8 *data) {
+            T value;
+            std::memcpy(&value, data, sizeof(T));
+            return changeEndianess(value, std::endian::little);
+        }
+
+        template<typename T>
+        void writeBigEndian(u8 *data, T value) {
+            value = changeEndianess(value, std::endian::big);
+            std::memcpy(data, &value, sizeof(T));
+        }
+
+        template<typename T>
+        constexpr T rotateLeft(T value, u32 amount) {
+            return (value << amount) | (value >> (sizeof(T) * 8 - amount));
+        }
+
+        template<typename T>
+        constexpr T rotateRight(T value, u32 amount) {
+            return (value >> amount) | (value << (sizeof(T) * 8 - amount));
+        }
+
+        /* xxHash3 */
+
+        constexpr u32 XXH3Prime32_1 = 0x9E3779B1U;
+        constexpr u32 XXH3Prime32_2 = 0x85EBCA77U;
+        constexpr u32 XXH3Prime32_3 = 0xC2B2AE3DU;
+        constexpr u64 XXH3Prime64_1 = 0x9E3779B185EBCA87ULL;
+        constexpr u64 XXH3Prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+        constexpr u64 XXH3Prime64_3 = 0x165667B19E3779F9ULL;
+        constexpr u64 XXH3Prime64_4 = 0x85EBCA77C2B2AE63ULL;
+        constexpr u64 XXH3Prime64_5 = 0x27D4EB2F165667C5ULL;
+        constexpr u64 XXH3PrimeMx1  = 0x165667919E3779F9ULL;
+        constexpr u64 XXH3PrimeMx2  = 0x9FB21C651E98DF25ULL;
+
+        constexpr size_t XXH3StripeSize        = 64;
+        constexpr size_t XXH3SecretConsumeRate = 8;
+        constexpr size_t XXH3MidSizeMax        = 240;
+        constexpr size_t XXH3MidSizeStart      = 3;
+        constexpr size_t XXH3MidSizeLast       = 17;
+        constexpr size_t XXH3SecretSizeMin     = 136;
+        constexpr size_t XXH3LastAccStart      = 7;
+        constexpr size_t XXH3MergeAccsStart    = 11;
+        constexpr size_t XXH3BufferSize        = 256;
+
+        constexpr std::array<u8, 192> XXH3Secret = {
+            0xB8, 0xFE, 0x6C, 0x39, 0x23, 0xA4, 0x4B, 0xBE, 0x7C, 0x01, 0x81, 0x2C, 0xF7, 0x21, 0xAD, 0x1C,
+            0xDE, 0xD4, 0x6D, 0xE9, 0x83, 0x90, 0x97, 0xDB, 0x72, 0x40, 0xA4, 0xA4, 0xB7, 0xB3, 0x67, 0x1F,
+            0xCB, 0x79, 0xE6, 0x4E, 0xCC, 0xC0, 0xE5, 0x78, 0x82, 0x5A, 0xD0, 0x7D, 0xCC, 0xFF, 0x72, 0x21,
+            0xB8, 0x08, 0x46, 0x74, 0xF7, 0x43, 0x24, 0x8E, 0xE0, 0x35, 0x90, 0xE6, 0x81, 0x3A, 0x26, 0x4C,
+            0x3C, 0x28, 0x52, 0xBB, 0x91, 0xC3, 0x00, 0xCB, 0x88, 0xD0, 0x65, 0x8B, 0x1B, 0x53, 0x2E, 0xA3,
+            0x71, 0x64, 0x48, 0x97, 0xA2, 0x0D, 0xF9, 0x4E, 0x38, 0x19, 0xEF, 0x46, 0xA9, 0xDE, 0xAC, 0xD8,
+            0xA8, 0xFA, 0x76, 0x3F, 0xE3, 0x9C, 0x34, 0x3F, 0xF9, 0xDC, 0xBB, 0xC7, 0xC7, 0x0B, 0x4F, 0x1D,
+            0x8A, 0x51, 0xE0, 0x4B, 0xCD, 0xB4, 0x59, 0x31, 0xC8, 0x9F, 0x7E, 0xC9, 0xD9, 0x78, 0x73, 0x64,
+            0xEA, 0xC5, 0xAC, 0x83, 0x34, 0xD3, 0xEB, 0xC3, 0xC5, 0x81, 0xA0, 0xFF, 0xFA, 0x13, 0x63, 0xEB,
+            0x17, 0x0D, 0xDD, 0x51, 0xB7, 0xF0, 0xDA, 0x49, 0xD3, 0x16, 0x55, 0x26, 0x29, 0xD4, 0x68, 0x9E,
+            0x2B, 0x16, 0xBE, 0x58, 0x7D, 0x47, 0xA1, 0xFC, 0x8F, 0xF8, 0xB8, 0xD1, 0x7A, 0xD0, 0x31, 0xCE,
+            0x45, 0xCB, 0x3A, 0x8F, 0x95, 0x16, 0x04, 0x28, 0xAF, 0xD7, 0xFB, 0xCA, 0xBB, 0x4B, 0x40, 0x7E,
+        };
+
+        constexpr size_t XXH3StripesPerBlock = (XXH3Secret.size() - XXH3StripeSize) / XXH3SecretConsumeRate;
+
+        struct XXH128Result {
+            u64 low, high;
+        };
+
+        XXH128Result xxh3Multiply128(u64 lhs, u64 rhs) {
+            u128 product = u128(lhs) * u128(rhs);
+            return { u64(product), u64(product >> 64) };
+        }
+
+        u64 xxh3MultiplyFold64(u64 lhs, u64 rhs) {
+            auto product = xxh3Multiply128(lhs, rhs);
+            return product.low ^ product.high;
+        }
+
+        u64 xxh64Avalanche(u64 hash) {
+            hash ^= hash >> 33;
+            hash *= XXH3Prime64_2;
+            hash ^= hash >> 29;
+            hash *= XXH3Prime64_3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+        u64 xxh3Avalanche(u64 hash) {
+            hash ^= hash >> 37;
+            hash *= XXH3PrimeMx1;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+        u64 xxh3RRMXMX(u64 hash, u64 length) {
+            hash ^= rotateLeft(hash, 49) ^ rotateLeft(hash, 24);
+            hash *= XXH3PrimeMx2;
+            hash ^= (hash >> 35) + length;
+            hash *= XXH3PrimeMx2;
+            hash ^= hash >> 28;
+            return hash;
+        }
+
+        u64 xxh3Mix16(const u8 *input, const u8 *secret, u64 seed) {
+            return xxh3MultiplyFold64(readLittleEndian<u64>(input) ^ (readLittleEndian<u64>(secret) + seed),
+                                      readLittleEndian<u64>(input + 8) ^ (readLittleEndian<u64>(secret + 8) - seed));
+        }
+
+        XXH128Result xxh3Mix32(XXH128Result acc, const u8 *input1, const u8 *input2, const u8 *secret, u64 seed) {
+            acc.low  += xxh3Mix16(input1, secret, seed);
+            acc.low  ^= readLittleEndian<u64>(input2) + readLittleEndian<u64>(input2 + 8);
+            acc.high += xxh3Mix16(input2, secret + 16, seed);
+            acc.high ^= readLittleEndian<u64>(input1) + readLittleEndian<u64>(input1 + 8);
+            return acc;
+        }
+
+        u64 xxh3Short64(const u8 *input, size_t length) {
+            const u8 *secret = XXH3Secret.data();
+
+            if (length == 0) {
+                return xxh64Avalanche(readLittleEndian<u64>(secret + 56) ^ readLittleEndian<u64>(secret + 64));
+            } else if (length <= 3) {
+                u32 combined = (u32(input[0]) << 16) | (u32(input[length >> 1]) << 24) | u32(input[length - 1]) | (u32(length) << 8);
+                u64 bitflip = readLittleEndian<u32>(secret) ^ readLittleEndian<u32>(secret + 4);
+                return xxh64Avalanche(u64(combined) ^ bitflip);
+            } else if (length <= 8) {
+                u64 bitflip = readLittleEndian<u64>(secret + 8) ^ readLittleEndian<u64>(secret + 16);
+                u64 input64 = readLittleEndian<u32>(input + length - 4) + (u64(readLittleEndian<u32>(input)) << 32);
+                return xxh3RRMXMX(input64 ^ bitflip, length);
+            } else if (length <= 16) {
+                u64 bitflip1 = readLittleEndian<u64>(secret + 24) ^ readLittleEndian<u64>(secret + 32);
+                u64 bitflip2 = readLittleEndian<u64>(secret + 40) ^ readLittleEndian<u64>(secret + 48);
+                u64 inputLow  = readLittleEndian<u64>(input) ^ bitflip1;
+                u64 inputHigh = readLittleEndian<u64>(input + length - 8) ^ bitflip2;
+                u64 acc = length + __builtin_bswap64(inputLow) + inputHigh + xxh3MultiplyFold64(inputLow, inputHigh);
+                return xxh3Avalanche(acc);
+            } else if (length <= 128) {
+                u64 acc = length * XXH3Prime64_1;
+                if (length > 32) {
+                    if (length > 64) {
+                        if (length > 96) {
+                            acc += xxh3Mix16(input + 48, secret + 96, 0);
+                            acc += xxh3Mix16(input + length - 64, secret + 112, 0);
+                        }
+                        acc += xxh3Mix16(input + 32, secret + 64, 0);
+                        acc += xxh3Mix16(input + length - 48, secret + 80, 0);
+                    }
+                    acc += xxh3Mix16(input + 16, secret + 32, 0);
+                    acc += xxh3Mix16(input + length - 32, secret + 48, 0);
+                }
+                acc += xxh3Mix16(input, secret, 0);
+                acc += xxh3Mix16(input + length - 16, secret + 16, 0);
+                return xxh3Avalanche(acc);
+            } else {
+                u64 acc = length * XXH3Prime64_1;
+                size_t rounds = length / 16;
+                for (size_t i = 0; i < 8; i++)
+                    acc += xxh3Mix16(input + 16 * i, secret + 16 * i, 0);
+                acc = xxh3Avalanche(acc);
+                for (size_t i = 8; i < rounds; i++)
+                    acc += xxh3Mix16(input + 16 * i, secret + 16 * (i - 8) + XXH3MidSizeStart, 0);
+                acc += xxh3Mix16(input + length - 16, secret + XXH3SecretSizeMin - XXH3MidSizeLast, 0);
+                return xxh3Avalanche(acc);
+            }
+        }
+
+        XXH128Result xxh3Short128(const u8 *input, size_t length) {
+            const u8 *secret = XXH3Secret.data();
+
+            if (length == 0) {
+                return {
+                    xxh64Avalanche(readLittleEndian<u64>(secret + 64) ^ readLittleEndian<u64>(secret + 72)),
+                    xxh64Avalanche(readLittleEndian<u64>(secret + 80) ^ readLittleEndian<u64>(secret + 88))
+                };
+            } else if (length <= 3) {
+                u32 combinedLow  = (u32(input[0]) << 16) | (u32(input[length >> 1]) << 24) | u32(input[length - 1]) | (u32(length) << 8);
+                u32 combinedHigh = rotateLeft(__builtin_bswap32(combinedLow), 13);
+                u64 bitflipLow  = readLittleEndian<u32>(secret) ^ readLittleEndian<u32>(secret + 4);
+                u64 bitflipHigh = readLittleEndian<u32>(secret + 8) ^ readLittleEndian<u32>(secret + 12);
+                return { xxh64Avalanche(u64(combinedLow) ^ bitflipLow), xxh64Avalanche(u64(combinedHigh) ^ bitflipHigh) };
+            } else if (length <= 8) {
+                u64 input64 = readLittleEndian<u32>(input) + (u64(readLittleEndian<u32>(input + length - 4)) << 32);
+                u64 bitflip = readLittleEndian<u64>(secret + 16) ^ readLittleEndian<u64>(secret + 24);
+                auto product = xxh3Multiply128(input64 ^ bitflip, XXH3Prime64_1 + (length << 2));
+                product.high += product.low << 1;
+                product.low  ^= product.high >> 3;
+                product.low  ^= product.low >> 35;
+                product.low  *= XXH3PrimeMx2;
+                product.low  ^= product.low >> 28;
+                product.high  = xxh3Avalanche(product.high);
+                return product;
+            } else if (length <= 16) {
+                u64 bitflipLow  = readLittleEndian<u64>(secret + 32) ^ readLittleEndian<u64>(secret + 40);
+                u64 bitflipHigh = readLittleEndian<u64>(secret + 48) ^ readLittleEndian<u64>(secret + 56);
+                u64 inputLow  = readLittleEndian<u64>(input);
+                u64 inputHigh = readLittleEndian<u64>(input + length - 8);
+                auto product = xxh3Multiply128(inputLow ^ inputHigh ^ bitflipLow, XXH3Prime64_1);
+                product.low += u64(length - 1) << 54;
+                inputHigh ^= bitflipHigh;
+                product.high += inputHigh + u64(u32(inputHigh)) * (XXH3Prime32_2 - 1);
+                product.low ^= __builtin_bswap64(product.high);
+                auto result = xxh3Multiply128(product.low, XXH3Prime64_2);
+                result.high += product.high * XXH3Prime64_2;
+                return { xxh3Avalanche(result.low), xxh3Avalanche(result.high) };
+            } else {
+                XXH128Result acc = { length * XXH3Prime64_1, 0 };
+                if (length <= 128) {
+                    if (length > 32) {
+                        if (length > 64) {
+                            if (length > 96)
+                                acc = xxh3Mix32(acc, input + 48, input + length - 64, secret + 96, 0);
+                            acc = xxh3Mix32(acc, input + 32, input + length - 48, secret + 64, 0);
+                        }
+                        acc = xxh3Mix32(acc, input + 16, input + length - 32, secret + 32, 0);
+                    }
+                    acc = xxh3Mix32(acc, input, input + length - 16, secret, 0);
+                } else {
+                    size_t rounds = length / 32;
+                    for (size_t i = 0; i < 4; i++)
+                        acc = xxh3Mix32(acc, input + 32 * i, input + 32 * i + 16, secret + 32 * i, 0);
+                    acc.low  = xxh3Avalanche(acc.low);
+                    acc.high = xxh3Avalanche(acc.high);
+                    for (size_t i = 4; i < rounds; i++)
+                        acc = xxh3Mix32(acc, input + 32 * i, input + 32 * i + 16, secret + XXH3MidSizeStart + 32 * (i - 4), 0);
+                    acc = xxh3Mix32(acc, input + length - 16, input + length - 32, secret + XXH3SecretSizeMin - XXH3MidSizeLast - 16, 0);
+                }
+
+                u64 low  = acc.low + acc.high;
+                u64 high = acc.low * XXH3Prime64_1 + acc.high * XXH3Prime64_4 + length * XXH3Prime64_2;
+                return { xxh3Avalanche(low), 0 - xxh3Avalanche(high) };
+            }
+        }
+
+        /* Streaming xxHash3 state for inputs that don't fit into memory. Stripes are only consumed once it's */
+        /* known that more input follows them since the last stripe is always hashed separately on finalization */
+        class XXH3State {
+        public:
+            void update(const u8 *input, size_t length) {
+                this->m_totalLength += length;
+
+                if (this->m_bufferedSize + length <= XXH3BufferSize) {
+                    std::memcpy(this->m_buffer.data() + this->m_bufferedSize, input, length);
+                    this->m_bufferedSize += length;
+                    return;
+                }
+
+                if (this->m_bufferedSize > 0) {
+                    size_t fillSize = XXH3BufferSize - this->m_bufferedSize;
+                    std::memcpy(this->m_buffer.data() + this->m_bufferedSize, input, fillSize);
+                    input  += fillSize;
+                    length -= fillSize;
+
+                    this->consumeStripes(this->m_buffer.data(), XXH3BufferSize / XXH3StripeSize);
+                    std::memcpy(this->m_lastStripe.data(), this->m_buffer.data() + XXH3BufferSize - XXH3StripeSize, XXH3StripeSize);
+                    this->m_bufferedSize = 0;
+                }
+
+                if (length > XXH3BufferSize) {
+                    do {
+                        this->consumeStripes(input, XXH3BufferSize / XXH3StripeSize);
+                        input  += XXH3BufferSize;
+                        length -= XXH3BufferSize;
+                    } while (length > XXH3BufferSize);
+
+                    std::memcpy(this->m_lastStripe.data(), input - XXH3StripeSize, XXH3StripeSize);
+                }
+
+                std::memcpy(this->m_buffer.data(), input, length);
+                this->m_bufferedSize = length;
+            }
+
+            u64 digest64() const {
+                if (this->m_totalLength <= XXH3MidSizeMax)
+                    return xxh3Short64(this->m_buffer.data(), this->m_totalLength);
+
+                auto acc = this->finalizeAccumulators();
+                return mergeAccumulators(acc, XXH3Secret.data() + XXH3MergeAccsStart, this->m_totalLength * XXH3Prime64_1);
+            }
+
+            XXH128Result digest128() const {
+                if (this->m_totalLength <= XXH3MidSizeMax)
+                    return xxh3Short128(this->m_buffer.data(), this->m_totalLength);
+
+                auto acc = this->finalizeAccumulators();
+                return {
+                    mergeAccumulators(acc, XXH3Secret.data() + XXH3MergeAccsStart, this->m_totalLength * XXH3Prime64_1),
+                    mergeAccumulators(acc, XXH3Secret.data() + XXH3Secret.size() - XXH3StripeSize - XXH3MergeAccsStart, ~(this->m_totalLength * XXH3Prime64_2))
+                };
+            }
+
+        private:
+            using Accumulators = std::array<u64, 8>;
+
+            static void accumulateStripe(Accumulators &acc, const u8 *input, const u8 *secret) {
+                for (size_t i = 0; i < acc.size(); i++) {
+                    u64 value = readLittleEndian<u64>(input + 8 * i);
+                    u64 key   = value ^ readLittleEndian<u64>(secret + 8 * i);
+                    acc[i ^ 1] += value;
+                    acc[i]     += u64(u32(key)) * (key >> 32);
+                }
+            }
+
+            static void scrambleAccumulators(Accumulators &acc, const u8 *secret) {
+                for (size_t i = 0; i < acc.size(); i++) {
+                    u64 value = acc[i];
+                    value ^= value >> 47;
+                    value ^= readLittleEndian<u64>(secret + 8 * i);
+                    value *= XXH3Prime32_1;
+                    acc[i] = value;
+                }
+            }
+
+            static u64 mergeAccumulators(const Accumulators &acc, const u8 *secret, u64 start) {
+                u64 result = start;
+                for (size_t i = 0; i < 4; i++)
+                    result += xxh3MultiplyFold64(acc[2 * i] ^ readLittleEndian<u64>(secret + 16 * i), acc[2 * i + 1] ^ readLittleEndian<u64>(secret + 16 * i + 8));
+
+                return xxh3Avalanche(result);
+            }
+
+            static void consumeStripes(Accumulators &acc, size_t &stripesInBlock, const u8 *input, size_t stripeCount) {
+                for (size_t stripe = 0; stripe < stripeCount; stripe++) {
+                    accumulateStripe(acc, input + stripe * XXH3StripeSize, XXH3Secret.data() + stripesInBlock * XXH3SecretConsumeRate);
+
+                    if (++stripesInBlock == XXH3StripesPerBlock) {
+                        scrambleAccumulators(acc, XXH3Secret.data() + XXH3Secret.size() - XXH3StripeSize);
+                        stripesInBlock = 0;
+                    }
+                }
+            }
+
+            void consumeStripes(const u8 *input, size_t stripeCount) {
+                consumeStripes(this->m_acc, this->m_stripesInBlock, input, stripeCount);
+            }
+
+            Accumulators finalizeAccumulators() const {
+                auto acc = this->m_acc;
+                auto stripesInBlock = this->m_stripesInBlock;
+
+                consumeStripes(acc, stripesInBlock, this->m_buffer.data(), (this->m_bufferedSize - 1) / XXH3StripeSize);
+
+                std::array<u8, XXH3StripeSize> lastStripe;
+                if (this->m_bufferedSize >= XXH3StripeSize) {
+                    std::memcpy(lastStripe.data(), this->m_buffer.data() + this->m_bufferedSize - XXH3StripeSize, XXH3StripeSize);
+                } else {
+                    size_t carrySize = XXH3StripeSize - this->m_bufferedSize;
+                    std::memcpy(lastStripe.data(), this->m_lastStripe.data() + this->m_bufferedSize, carrySize);
+                    std::memcpy(lastStripe.data() + carrySize, this->m_buffer.data(), this->m_bufferedSize);
+                }
+
+                accumulateStripe(acc, lastStripe.data(), XXH3Secret.data() + XXH3Secret.size() - XXH3StripeSize - XXH3LastAccStart);
+
+                return acc;
+            }
+
+            Accumulators m_acc = { XXH3Prime32_3, XXH3Prime64_1, XXH3Prime64_2, XXH3Prime64_3, XXH3Prime64_4, XXH3Prime32_2, XXH3Prime64_5, XXH3Prime32_1 };
+            size_t m_stripesInBlock = 0;
+            u64 m_totalLength = 0;
+
+            std::array<u8, XXH3BufferSize> m_buffer = { 0 };
+            size_t m_bufferedSize = 0;
+            std::array<u8, XXH3StripeSize> m_lastStripe = { 0 };
+        };
+
+        std::array<u8, 16> xxh3ToBytes(XXH128Result result) {
+            std::array<u8, 16> bytes = { 0 };
+            writeBigEndian(bytes.data(), result.high);
+            writeBigEndian(bytes.data() + 8, result.low);
+            return bytes;
+        }
+
+        template<typename T>
+        void hashProviderRegion(prv::Provider* &data, u64 offset, size_t size, T &&callback) {
+            std::vector<u8> buffer(std::min<size_t>(size, 0x10000));
+            for (u64 bufferOffset = 0; bufferOffset < size; bufferOffset += buffer.size()) {
+                const u64 readSize = std::min(u64(buffer.size()), size - bufferOffset);
+                data->read(offset + bufferOffset, buffer.data(), readSize);
+                callback(buffer.data(), readSize);
+            }
+        }
+
+        /* BLAKE3 */
+
+        constexpr size_t Blake3BlockSize = 64;
+        constexpr size_t Blake3ChunkSize = 1024;
+
+        /* Number of bytes hashed by a single worker thread. Has to be a power of two multiple of the chunk size */
+        constexpr size_t Blake3SubtreeSize = 0x10'0000;
+
+        constexpr std::array<u32, 8> Blake3IV = { 0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19 };
+        constexpr std::array<u8, 16> Blake3MessagePermutation = { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 };
+
+        enum Blake3Flags : u32 {
+            ChunkStart  = 1 << 0,
+            ChunkEnd    = 1 << 1,
+            Parent      = 1 << 2,
+            Root        = 1 << 3
+        };
+
+        using Blake3ChainingValue = std::array<u32, 8>;
+
+        void blake3G(std::array<u32, 16> &state, size_t a, size_t b, size_t c, size_t d, u32 x, u32 y) {
+            state[a] = state[a] + state[b] + x;
+            state[d] = rotateRight(state[d] ^ state[a], 16);
+            state[c] = state[c] + state[d];
+            state[b] = rotateRight(state[b] ^ state[c], 12);
+            state[a] = state[a] + state[b] + y;
+            state[d] = rotateRight(state[d] ^ state[a], 8);
+            state[c] = state[c] + state[d];
+            state[b] = rotateRight(state[b] ^ state[c], 7);
+        }
+
+        std::array<u32, 16> blake3Compress(const Blake3ChainingValue &chainingValue, const std::array<u8, Blake3BlockSize> &block, u64 counter, u32 blockLength, u32 flags) {
+            std::array<u32, 16> message;
+            for (size_t i = 0; i < message.size(); i++)
+                message[i] = readLittleEndian<u32>(block.data() + 4 * i);
+
+            std::array<u32, 16> state = {
+                chainingValue[0], chainingValue[1], chainingValue[2], chainingValue[3],
+                chainingValue[4], chainingValue[5], chainingValue[6], chainingValue[7],
+                Blake3IV[0], Blake3IV[1], Blake3IV[2], Blake3IV[3],
+                u32(counter), u32(counter >> 32), blockLength, flags
+            };
+
+            for (u8 round = 0; round < 7; round++) {
+                blake3G(state, 0, 4,  8, 12, message[0],  message[1]);
+                blake3G(state, 1, 5,  9, 13, message[2],  message[3]);
+                blake3G(state, 2, 6, 10, 14, message[4],  message[5]);
+                blake3G(state, 3, 7, 11, 15, message[6],  message[7]);
+                blake3G(state, 0, 5, 10, 15, message[8],  message[9]);
+                blake3G(state, 1, 6, 11, 12, message[10], message[11]);
+                blake3G(state, 2, 7,  8, 13, message[12], message[13]);
+                blake3G(state, 3, 4,  9, 14, message[14], message[15]);
+
+                std::array<u32, 16> permuted;
+                for (size_t i = 0; i < permuted.size(); i++)
+                    permuted[i] = message[Blake3MessagePermutation[i]];
+                message = permuted;
+            }
+
+            for (size_t i = 0; i < 8; i++) {
+                state[i] ^= state[i + 8];
+                state[i + 8] ^= chainingValue[i];
+            }
+
+            return state;
+        }
+
+        /* A node whose final compression is deferred until it's known whether it's the root of the tree */
+        struct Blake3Output {
+            Blake3ChainingValue chainingValue;
+            std::array<u8, Blake3BlockSize> block;
+            u64 counter;
+            u32 blockLength;
+            u32 flags;
+
+            [[nodiscard]] Blake3ChainingValue getChainingValue() const {
+                auto state = blake3Compress(this->chainingValue, this->block, this->counter, this->blockLength, this->flags);
+
+                Blake3ChainingValue result;
+                std::copy_n(state.begin(), result.size(), result.begin());
+                return result;
+            }
+
+            [[nodiscard]] std::array<u8, 32> getRootHash() const {
+                auto state = blake3Compress(this->chainingValue, this->block, 0, this->blockLength, this->flags | Blake3Flags::Root);
+
+                std::array<u8, 32> result = { 0 };
+                for (size_t i = 0; i < 8; i++) {
+                    u32 word = changeEndianess(state[i], std::endian::little);
+                    std::memcpy(result.data() + 4 * i, &word, sizeof(word));
+                }
+                return result;
+            }
+        };
+
+        Blake3Output blake3ChunkOutput(const u8 *input, size_t length, u64 chunkCounter) {
+            Blake3Output output = { Blake3IV, { 0 }, chunkCounter, 0, Blake3Flags::ChunkStart };
+
+            while (length > Blake3BlockSize) {
+                std::memcpy(output.block.data(), input, Blake3BlockSize);
+                auto state = blake3Compress(output.chainingValue, output.block, chunkCounter, Blake3BlockSize, output.flags);
+                std::copy_n(state.begin(), output.chainingValue.size(), output.chainingValue.begin());
+                output.flags &= ~Blake3Flags::ChunkStart;
+
+                input  += Blake3BlockSize;
+                length -= Blake3BlockSize;
+            }
+
+            output.block = { 0 };
+            std::memcpy(output.block.data(), input, length);
+            output.blockLength = length;
+            output.flags |= Blake3Flags::ChunkEnd;
+
+            return output;
+        }
+
+        Blake3Output blake3ParentOutput(const Blake3ChainingValue &left, const Blake3ChainingValue &right) {
+            Blake3Output output = { Blake3IV, { 0 }, 0, Blake3BlockSize, Blake3Flags::Parent };
+
+            for (size_t i = 0; i < 8; i++) {
+                u32 leftWord  = changeEndianess(left[i], std::endian::little);
+                u32 rightWord = changeEndianess(right[i], std::endian::little);
+                std::memcpy(output.block.data() + 4 * i, &leftWord, sizeof(u32));
+                std::memcpy(output.block.data() + 32 + 4 * i, &rightWord, sizeof(u32));
+            }
+
+            return output;
+        }
+
+        /* The left subtree always holds the largest power of two number of chunks that leaves at least one byte for the right one */
+        size_t blake3LeftSubtreeSize(size_t length) {
+            size_t chunks = (length - 1) / Blake3ChunkSize;
+            return std::bit_floor(chunks) * Blake3ChunkSize;
+        }
+
+        Blake3Output blake3SubtreeOutput(const u8 *input, size_t length, u64 chunkCounter) {
+            if (length <= Blake3ChunkSize)
+                return blake3ChunkOutput(input, length, chunkCounter);
+
+            size_t leftSize = blake3LeftSubtreeSize(length);
+            auto left  = blake3SubtreeOutput(input, leftSize, chunkCounter).getChainingValue();
+            auto right = blake3SubtreeOutput(input + leftSize, length - leftSize, chunkCounter + leftSize / Blake3ChunkSize).getChainingValue();
+
+            return blake3ParentOutput(left, right);
+        }
+
+        /* Merges the chaining values of equally sized subtrees following the same left-balanced split as the in-memory tree */
+        Blake3Output blake3MergeSubtrees(const Blake3ChainingValue *chainingValues, size_t count) {
+            size_t leftCount = std::bit_floor(count - 1);
+
+            auto left  = leftCount == 1 ? chainingValues[0] : blake3MergeSubtrees(chainingValues, leftCount).getChainingValue();
+            auto right = (count - leftCount) == 1 ? chainingValues[leftCount] : blake3MergeSubtrees(chainingValues + leftCount, count - leftCount).getChainingValue();
+
+            return blake3ParentOutput(left, right);
+        }
+
+    }
+
+    u64 xxh3_64(prv::Provider* &data, u64 offset, size_t size) {
+        XXH3State state;
+        hashProviderRegion(data, offset, size, [&state](const u8 *buffer, size_t bufferSize) {
+            state.update(buffer, bufferSize);
+        });
+
+        return state.digest64();
+    }
+
+    std::array<u8, 16> xxh3_128(prv::Provider* &data, u64 offset, size_t size) {
+        XXH3State state;
+        hashProviderRegion(data, offset, size, [&state](const u8 *buffer, size_t bufferSize) {
+            state.update(buffer, bufferSize);
+        });
+
+        return xxh3ToBytes(state.digest128());
+    }
+
+    std::array<u8, 32> blake3(prv::Provider* &data, u64 offset, size_t size) {
+        if (size <= Blake3SubtreeSize) {
+            std::vector<u8> buffer(size);
+            data->read(offset, buffer.data(), buffer.size());
+
+            return blake3SubtreeOutput(buffer.data(), buffer.size(), 0).getRootHash();
+        }
+
+        /* Split the input into equally sized subtrees, hash them on all available cores and merge their chaining values afterwards */
+        const size_t subtreeCount = (size + Blake3SubtreeSize - 1) / Blake3SubtreeSize;
+        std::vector<Blake3ChainingValue> chainingValues(subtreeCount);
+
+        // Providers can't be read from multiple threads at once so only the hashing itself runs in parallel
+        std::mutex readMutex;
+
+        std::atomic<size_t> nextSubtree = 0;
+        auto worker = [&] {
+            std::vector<u8> buffer(Blake3SubtreeSize);
+
+            for (size_t subtree = nextSubtree++; subtree < subtreeCount; subtree = nextSubtree++) {
+                const u64 subtreeOffset = subtree * Blake3SubtreeSize;
+                const size_t subtreeSize = std::min<u64>(Blake3SubtreeSize, size - subtreeOffset);
+
+                {
+                    std::scoped_lock lock(readMutex);
+                    data->read(offset + subtreeOffset, buffer.data(), subtreeSize);
+                }
+
+                chainingValues[subtree] = blake3SubtreeOutput(buffer.data(), subtreeSize, subtreeOffset / Blake3ChunkSize).getChainingValue();
+            }
+        };
+
+        const size_t threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, subtreeCount);
+
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < threadCount; i++)
+            threads.emplace_back(worker);
+
+        worker();
+
+        for (auto &thread : threads)
+            thread.join();
+
+        return blake3MergeSubtrees(chainingValues.data(), chainingValues.size()).getRootHash();
+    }
+
+    u64 xxh3_64(const std::vector<u8> &data) {
+        XXH3State state;
+        state.update(data.data(), data.size());
+
+        return state.digest64();
+    }
+
+    std::array<u8, 16> xxh3_128(const std::vector<u8> &data) {
+        XXH3State state;
+        state.update(data.data(), data.size());
+
+        return xxh3ToBytes(state.digest128());
+    }
+
+    std::array<u8, 32> blake3(const std::vector<u8> &data) {
+        return blake3SubtreeOutput(data.data(), data.size(), 0).getRootHash();
+    }
+
+    namespace {
+
+        /* Context triggered piecewise hashing as implemented by ssdeep. A rolling hash over the last few bytes decides */
+        /* where the input gets split into pieces and every piece contributes one character to the signature.           */
+        /* All candidate block sizes are tracked at once so the input only needs to be walked a single time            */
+
+        constexpr size_t SsdeepRollingWindow    = 7;
+        constexpr size_t SsdeepMinBlockSize     = 3;
+        constexpr size_t SsdeepSignatureLength  = 64;
+        constexpr size_t SsdeepBlockHashCount   = 31;
+        constexpr u32 SsdeepHashPrime           = 0x01000193;
+        constexpr u32 SsdeepHashInit            = 0x28021967;
+
+        constexpr std::string_view SsdeepBase64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        constexpr u64 ssdeepBlockSize(size_t index) {
+            return u64(SsdeepMinBlockSize) << index;
+        }
+
+        class SsdeepState {
+        public:
+            explicit SsdeepState(u64 totalSize) : m_totalSize(totalSize) {
+                this->m_blockHashes[0].hash = this->m_blockHashes[0].halfHash = SsdeepHashInit;
+            }
+
+            void update(const u8 *input, size_t length) {
+                for (size_t i = 0; i < length; i++)
+                    this->step(input[i]);
+            }
+
+            [[nodiscard]] std::string digest() const {
+                size_t index = this->m_blockHashStart;
+                const u32 rollingHash = this->getRollingHash();
+
+                while (ssdeepBlockSize(index) * SsdeepSignatureLength < this->m_totalSize) {
+                    index++;
+                    if (index >= SsdeepBlockHashCount)
+                        return "";
+                }
+
+                while (index >= this->m_blockHashEnd)
+                    index--;
+                while (index > this->m_blockHashStart && this->m_blockHashes[index].length < SsdeepSignatureLength / 2)
+                    index--;
+
+                std::string result = std::to_string(ssdeepBlockSize(index)) + ":";
+
+                {
+                    const auto &blockHash = this->m_blockHashes[index];
+                    result.append(blockHash.digest.data(), blockHash.length);
+
+                    if (rollingHash != 0)
+                        result += SsdeepBase64[blockHash.hash % 64];
+                    else if (blockHash.digest[blockHash.length] != '\0')
+                        result += blockHash.digest[blockHash.length];
+                }
+
+                result += ':';
+
+                if (index < this->m_blockHashEnd - 1) {
+                    const auto &blockHash = this->m_blockHashes[index + 1];
+                    result.append(blockHash.digest.data(), std::min(blockHash.length, SsdeepSignatureLength / 2 - 1));
+
+                    if (rollingHash != 0)
+                        result += SsdeepBase64[blockHash.halfHash % 64];
+                    else if (blockHash.halfDigest != '\0')
+                        result += blockHash.halfDigest;
+                } else if (rollingHash != 0) {
+                    result += SsdeepBase64[this->m_blockHashes[index].hash % 64];
+                }
+
+                return result;
+            }
+
+        private:
+            struct BlockHash {
+                u32 hash = 0, halfHash = 0;
+                std::array<char, SsdeepSignatureLength> digest = { 0 };
+                char halfDigest = '\0';
+                size_t length = 0;
+            };
+
+            static u32 sumHash(u8 c, u32 hash) {
+                return (hash * SsdeepHashPrime) ^ c;
+            }
+
+            [[nodiscard]] u32 getRollingHash() const {
+                return this->m_rollingHash[0] + this->m_rollingHash[1] + this->m_rollingHash[2];
+            }
+
+            void rollHash(u8 c) {
+                this->m_rollingHash[1] -= this->m_rollingHash[0];
+                this->m_rollingHash[1] += SsdeepRollingWindow * c;
+
+                this->m_rollingHash[0] += c;
+                this->m_rollingHash[0] -= this->m_window[this->m_windowPosition % SsdeepRollingWindow];
+
+                this->m_window[this->m_windowPosition % SsdeepRollingWindow] = c;
+                this->m_windowPosition++;
+
+                this->m_rollingHash[2] <<= 5;
+                this->m_rollingHash[2] ^= c;
+            }
+
+            void tryForkBlockHash() {
+                if (this->m_blockHashEnd >= SsdeepBlockHashCount)
+                    return;
+
+                auto &previous = this->m_blockHashes[this->m_blockHashEnd - 1];
+                auto &next = this->m_blockHashes[this->m_blockHashEnd];
+
+                next.hash       = previous.hash;
+                next.halfHash   = previous.halfHash;
+                next.digest[0]  = '\0';
+                next.halfDigest = '\0';
+                next.length     = 0;
+
+                this->m_blockHashEnd++;
+            }
+
+            void tryReduceBlockHash() {
+                if (this->m_blockHashEnd - this->m_blockHashStart < 2)
+                    return;
+
+                if (ssdeepBlockSize(this->m_blockHashStart) * SsdeepSignatureLength >= this->m_totalSize)
+                    return;
+
+                if (this->m_blockHashes[this->m_blockHashStart + 1].length < SsdeepSignatureLength / 2)
+                    return;
+
+                this->m_blockHashStart++;
+            }
+
+            void step(u8 c) {
+                this->rollHash(c);
+                const u32 rollingHash = this->getRollingHash();
+
+                for (size_t i = this->m_blockHashStart; i < this->m_blockHashEnd; i++) {
+                    auto &blockHash = this->m_blockHashes[i];
+                    blockHash.hash     = sumHash(c, blockHash.hash);
+                    blockHash.halfHash = sumHash(c, blockHash.halfHash);
+                }
+
+                for (size_t i = this->m_blockHashStart; i < this->m_blockHashEnd; i++) {
+                    // If the trigger doesn't fire for this block size it won't fire for any of the bigger ones either
+                    if (rollingHash % ssdeepBlockSize(i) != ssdeepBlockSize(i) - 1)
+                        break;
+
+                    if (this->m_blockHashes[i].length == 0)
+                        this->tryForkBlockHash();
+
+                    auto &blockHash = this->m_blockHashes[i];
+                    blockHash.digest[blockHash.length] = SsdeepBase64[blockHash.hash % 64];
+                    blockHash.halfDigest = SsdeepBase64[blockHash.halfHash % 64];
+
+                    if (blockHash.length < SsdeepSignatureLength - 1) {
+                        // Only start a new piece if there's space left in the signature, otherwise the tail gets merged into the last character
+                        blockHash.length++;
+                        blockHash.digest[blockHash.length] = '\0';
+                        blockHash.hash = SsdeepHashInit;
+
+                        if (blockHash.length < SsdeepSignatureLength / 2) {
+                            blockHash.halfHash = SsdeepHashInit;
+                            blockHash.halfDigest = '\0';
+                        }
+                    } else {
+                        this->tryReduceBlockHash();
+                    }
+                }
+            }
+
+            u64 m_totalSize;
+
+            std::array<BlockHash, SsdeepBlockHashCount> m_blockHashes;
+            size_t m_blockHashStart = 0, m_blockHashEnd = 1;
+
+            std::array<u8, SsdeepRollingWindow> m_window = { 0 };
+            u32 m_windowPosition = 0;
+            std::array<u32, 3> m_rollingHash = { 0 };
+        };
+
+        /* Runs of more than three identical characters carry little information and would skew the score */
+        std::string ssdeepEliminateSequences(std::string_view signature) {
+            std::string result;
+
+            for (size_t i = 0; i < signature.size(); i++) {
+                if (i >= 3 && signature[i] == signature[i - 1] && signature[i] == signature[i - 2] && signature[i] == signature[i - 3])
+                    continue;
+
+                result += signature[i];
+            }
+
+            return result;
+        }
+
+        bool ssdeepHasCommonSubstring(const std::string &lhs, const std::string &rhs) {
+            if (lhs.size() < SsdeepRollingWindow || rhs.size() < SsdeepRollingWindow)
+                return false;
+
+            for (size_t i = 0; i <= lhs.size() - SsdeepRollingWindow; i++) {
+                if (rhs.find(std::string_view(lhs).substr(i, SsdeepRollingWindow)) != std::string::npos)
+                    return true;
+            }
+
+            return false;
+        }
+
+        size_t ssdeepEditDistance(const std::string &lhs, const std::string &rhs) {
+            std::vector<size_t> previous(rhs.size() + 1), current(rhs.size() + 1);
+
+            for (size_t i = 0; i <= rhs.size(); i++)
+                previous[i] = i;
+
+            for (size_t i = 0; i < lhs.size(); i++) {
+                current[0] = i + 1;
+
+                for (size_t j = 0; j < rhs.size(); j++) {
+                    const size_t insertCost  = previous[j + 1] + 1;
+                    const size_t removeCost  = current[j] + 1;
+                    const size_t replaceCost = previous[j] + (lhs[i] == rhs[j] ? 0 : 2);
+
+                    current[j + 1] = std::min({ insertCost, removeCost, replaceCost });
+                }
+
+                std::swap(previous, current);
+            }
+
+            return previous[rhs.size()];
+        }
+
+        u32 ssdeepScoreStrings(const std::string &lhs, const std::string &rhs, u64 blockSize) {
+            if (lhs.size() > SsdeepSignatureLength || rhs.size() > SsdeepSignatureLength)
+                return 0;
+
+            if (!ssdeepHasCommonSubstring(lhs, rhs))
+                return 0;
+
+            u64 score = ssdeepEditDistance(lhs, rhs);
+            score = (score * SsdeepSignatureLength) / (lhs.size() + rhs.size());
+            score = (100 * score) / SsdeepSignatureLength;
+
+            if (score >= 100)
+                return 0;
+
+            score = 100 - score;
+
+            // Small block sizes produce short signatures that match way too easily, cap their score
+            const u64 matchSizeLimit = blockSize / SsdeepMinBlockSize * std::min(lhs.size(), rhs.size());
+            if (blockSize < (99 + SsdeepRollingWindow) / SsdeepRollingWindow * SsdeepMinBlockSize && score > matchSizeLimit)
+                score = matchSizeLimit;
+
+            return score;
+        }
+
+        struct SsdeepSignature {
+            u64 blockSize;
+            std::string first, second;
+        };
+
+        std::optional<SsdeepSignature> ssdeepParseSignature(const std::string &signature) {
+            const auto firstSeparator = signature.find(':');
+            if (firstSeparator == std::string::npos)
+                return { };
+
+            const auto secondSeparator = signature.find(':', firstSeparator + 1);
+            if (secondSeparator == std::string::npos)
+                return { };
+
+            u64 blockSize = 0;
+            auto [end, error] = std::from_chars(signature.data(), signature.data() + firstSeparator, blockSize);
+            if (error != std::errc() || end != signature.data() + firstSeparator)
+                return { };
+
+            return SsdeepSignature {
+                blockSize,
+                ssdeepEliminateSequences(std::string_view(signature).substr(firstSeparator + 1, secondSeparator - firstSeparator - 1)),
+                ssdeepEliminateSequences(std::string_view(signature).substr(secondSeparator + 1))
+            };
+        }
+
+    }
+
+    std::string ssdeep(prv::Provider* &data, u64 offset, size_t size) {
+        SsdeepState state(size);
+        hashProviderRegion(data, offset, size, [&state](const u8 *buffer, size_t bufferSize) {
+            state.update(buffer, bufferSize);
+        });
+
+        return state.digest();
+    }
+
+    std::string ssdeep(prv::Provider* &data) {
+        const size_t size = data->getActualSize();
+
+        // Covers every page of the data, not just the one that's currently selected
+        SsdeepState state(size);
+        std::vector<u8> buffer(std::min<size_t>(size, 0x10000));
+        for (u64 offset = 0; offset < size; offset += buffer.size()) {
+            const u64 readSize = std::min(u64(buffer.size()), size - offset);
+            data->readUnpaged(offset, buffer.data(), readSize);
+            state.update(buffer.data(), readSize);
+        }
+
+        return state.digest();
+    }
+
+    std::string ssdeep(const std::vector<u8> &data) {
+        SsdeepState state(data.size());
+        state.update(data.data(), data.size());
+
+        return state.digest();
+    }
+
+    std::optional<u8> ssdeepCompare(const std::string &lhs, const std::string &rhs) {
+        auto lhsSignature = ssdeepParseSignature(lhs);
+        auto rhsSignature = ssdeepParseSignature(rhs);
+
+        if (!lhsSignature.has_value() || !rhsSignature.has_value())
+            return { };
+
+        const auto &[lhsBlockSize, lhsFirst, lhsSecond] = lhsSignature.value();
+        const auto &[rhsBlockSize, rhsFirst, rhsSecond] = rhsSignature.value();
+
+        // Signatures can only be compared if their block sizes are the same or one apart
+        if (lhsBlockSize == rhsBlockSize) {
+            if (lhsFirst == rhsFirst && lhsSecond == rhsSecond)
+                return 100;
+
+            return std::max(ssdeepScoreStrings(lhsFirst, rhsFirst, lhsBlockSize), ssdeepScoreStrings(lhsSecond, rhsSecond, lhsBlockSize * 2));
+        } else if (lhsBlockSize * 2 == rhsBlockSize) {
+            return ssdeepScoreStrings(lhsSecond, rhsFirst, rhsBlockSize);
+        } else if (rhsBlockSize * 2 == lhsBlockSize) {
+            return ssdeepScoreStrings(lhsFirst, rhsSecond, lhsBlockSize);
+        } else {
+            return 0;
+        }
+    }
+
     std::vector<u8> decode64(const std::vector<u8> &input) {
         size_t outputSize = (3 * input.size()) / 4;
         std::vector<u8> output(outputSize + 1, 0x00);
@@ -1,5 +1,6 @@
 #include <hex/helpers/file.hpp>
 #include <unistd.h>
+#include <cstring>
 
 namespace hex {
 
@@ -57,25 +58,29 @@ namespace hex {
     std::string File::readString(size_t numBytes) {
         if (!isValid()) return { };
 
-        return reinterpret_cast<char*>(readBytes(numBytes).data());
+        // The read bytes aren't null terminated so the string can't just be built from the data pointer
+        auto bytes = readBytes(numBytes);
+        auto string = reinterpret_cast<const char*>(bytes.data());
+
+        return { string, ::strnlen(string, bytes.size()) };
     }
 
-    void File::write(const u8 *buffer, size_t size) {
-        if (!isValid()) return;
+    bool File::write(const u8 *buffer, size_t size) {
+        if (!isValid()) return false;
 
-        fwrite(buffer, size, 1, this->m_file);
+        return fwrite(buffer, 1, size, this->m_file) == size;
     }
 
-    void File::write(const std::vector<u8> &bytes) {
-        if (!isValid()) return;
+    bool File::write(const std::vector<u8> &bytes) {
+        if (!isValid()) return false;
 
-        fwrite(bytes.data(), 1, bytes.size(), this->m_file);
+        return fwrite(bytes.data(), 1, bytes.size(), this->m_file) == bytes.size();
     }
 
-    void File::write(const std::string &string) {
-        if (!isValid()) return;
+    bool File::write(const std::string &string) {
+        if (!isValid()) return false;
 
-        fwrite(string.data(), string.size(), 1, this->m_file);
+        return fwrite(string.data(), 1, string.size(), this->m_file) == string.size();
     }
 
     size_t File::getSize() const {
@@ -95,8 +100,10 @@ namespace hex {
         ftruncate64(fileno(this->m_file), size);
     }
 
-    void File::flush() {
-        fflush(this->m_file);
+    bool File::flush() {
+        if (!isValid()) return false;
+
+        return fflush(this->m_file) == 0;
     }
 
     void File::remove() {
@@ -16,7 +16,7 @@ namespace hex {
     std::vector<View*> SharedData::views;
     std::vector<ContentRegistry::Tools::Entry> SharedData::toolsEntries;
     std::vector<ContentRegistry::DataInspector::Entry> SharedData::dataInspectorEntries;
-    u32 SharedData::patternPaletteOffset;
+    thread_local u32 SharedData::patternPaletteOffset;
     std::string SharedData::popupMessage;
     std::list<ImHexApi::Bookmarks::Entry> SharedData::bookmarkEntries;
     std::vector<pl::PatternData*> SharedData::patternData;
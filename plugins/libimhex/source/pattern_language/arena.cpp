@@ -0,0 +1,167 @@
+#include <hex/pattern_language/arena.hpp>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace hex::pl {
+
+    namespace {
+
+        constexpr size_t Granularity    = 16;
+        constexpr size_t SizeClassCount = 64;
+        constexpr size_t BlockSize      = 0x10'0000;
+
+    }
+
+    struct Arena::State {
+        // One reference is held by the arena itself, every live allocation holds another one
+        std::atomic<size_t> references = 1;
+
+        std::vector<std::unique_ptr<u8[]>> blocks;
+        u8 *current = nullptr, *end = nullptr;
+
+        std::array<void*, SizeClassCount> freeLists = { };
+
+        // Memory freed from other threads than the one the arena is active on. It only ever gets pushed to from there
+        // and taken over as a whole by the owning thread, so a lock-free stack is enough
+        std::atomic<void*> remoteFrees = nullptr;
+
+        void release() {
+            if (--this->references == 0)
+                delete this;
+        }
+
+        void collectRemoteFrees();
+    };
+
+    namespace {
+
+        /* Placed in front of every allocation so it can find its way back to where it came from */
+        struct alignas(Granularity) AllocationHeader {
+            void *state;
+            size_t sizeClass;
+        };
+
+        thread_local void *currentState = nullptr;
+
+    }
+
+    void Arena::State::collectRemoteFrees() {
+        auto entry = this->remoteFrees.exchange(nullptr, std::memory_order_acquire);
+
+        // Freed allocations keep their size class, only the state pointer got replaced by the link to the next one
+        while (entry != nullptr) {
+            auto next = *static_cast<void**>(entry);
+
+            auto &freeList = this->freeLists[static_cast<AllocationHeader*>(entry)->sizeClass];
+            *static_cast<void**>(entry) = freeList;
+            freeList = entry;
+
+            entry = next;
+        }
+    }
+
+    Arena::Arena() : m_state(new State()) {
+
+    }
+
+    Arena::~Arena() {
+        this->m_state->release();
+    }
+
+    void Arena::reset() {
+        if (this->m_state->references == 1) {
+            this->m_state->blocks.clear();
+            this->m_state->current = this->m_state->end = nullptr;
+            this->m_state->freeLists.fill(nullptr);
+            this->m_state->remoteFrees = nullptr;
+            return;
+        }
+
+        // Objects of the previous generation are still alive, they keep its memory around until the last of them is gone
+        this->m_state->release();
+        this->m_state = new State();
+    }
+
+    size_t Arena::getAllocationCount() const {
+        return this->m_state->references - 1;
+    }
+
+    size_t Arena::getMemoryUsage() const {
+        return this->m_state->blocks.size() * BlockSize;
+    }
+
+    void* Arena::allocate(size_t size) {
+        const size_t sizeClass = (sizeof(AllocationHeader) + size + Granularity - 1) / Granularity;
+        auto state = static_cast<State*>(currentState);
+
+        AllocationHeader *header;
+        if (state == nullptr || sizeClass >= SizeClassCount) {
+            header = static_cast<AllocationHeader*>(::operator new(sizeClass * Granularity));
+            header->state = nullptr;
+        } else {
+            auto &freeList = state->freeLists[sizeClass];
+            if (freeList == nullptr && state->remoteFrees.load(std::memory_order_relaxed) != nullptr)
+                state->collectRemoteFrees();
+
+            if (freeList != nullptr) {
+                header = static_cast<AllocationHeader*>(freeList);
+                freeList = *static_cast<void**>(freeList);
+            } else {
+                if (state->current + sizeClass * Granularity > state->end) {
+                    state->blocks.emplace_back(new u8[BlockSize]);
+                    state->current = state->blocks.back().get();
+                    state->end = state->current + BlockSize;
+                }
+
+                header = reinterpret_cast<AllocationHeader*>(state->current);
+                state->current += sizeClass * Granularity;
+            }
+
+            header->state = state;
+            state->references++;
+        }
+
+        header->sizeClass = sizeClass;
+
+        return header + 1;
+    }
+
+    void Arena::deallocate(void *pointer) {
+        if (pointer == nullptr)
+            return;
+
+        auto header = static_cast<AllocationHeader*>(pointer) - 1;
+        auto state = static_cast<State*>(header->state);
+
+        if (state == nullptr) {
+            ::operator delete(header);
+            return;
+        }
+
+        if (state == currentState) {
+            auto &freeList = state->freeLists[header->sizeClass];
+            *reinterpret_cast<void**>(header) = freeList;
+            freeList = header;
+        } else {
+            auto &remoteFrees = state->remoteFrees;
+            auto next = remoteFrees.load(std::memory_order_relaxed);
+            do {
+                *reinterpret_cast<void**>(header) = next;
+            } while (!remoteFrees.compare_exchange_weak(next, header, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        state->release();
+    }
+
+    Arena::Scope::Scope(Arena &arena) : m_previous(static_cast<State*>(currentState)) {
+        currentState = arena.m_state;
+    }
+
+    Arena::Scope::~Scope() {
+        currentState = this->m_previous;
+    }
+
+}
@@ -0,0 +1,187 @@
+#include <hex/pattern_language/bytecode.hpp>
+
+#include <hex/pattern_language/ast_node.hpp>
+#include <hex/pattern_language/evaluator.hpp>
+
+#include <iterator>
+
+namespace hex::pl {
+
+    Bytecode Compiler::compile(const ASTNode *expression, const Evaluator *evaluator) {
+        Bytecode bytecode;
+        compileNode(bytecode, expression, evaluator);
+
+        return bytecode;
+    }
+
+    void Compiler::compileNode(Bytecode &bytecode, const ASTNode *node, const Evaluator *evaluator) {
+        auto &instructions = bytecode.instructions;
+        const auto startInstruction = instructions.size();
+
+        if (auto literal = dynamic_cast<const ASTNodeLiteral*>(node)) {
+            bytecode.constants.push_back(literal->getValue());
+            instructions.push_back({ OpCode::PushConstant, u32(bytecode.constants.size() - 1), node });
+        } else if (auto rvalue = dynamic_cast<const ASTNodeRValue*>(node)) {
+            if (rvalue->isPlaceholder())
+                instructions.push_back({ OpCode::PushOffset, 0, node });
+            else
+                instructions.push_back({ OpCode::LoadRValue, 0, node });
+        } else if (auto mathematicalExpression = dynamic_cast<const ASTNodeMathematicalExpression*>(node)) {
+            if (mathematicalExpression->getLeftOperand() == nullptr || mathematicalExpression->getRightOperand() == nullptr)
+                LogConsole::abortEvaluation("attempted to use void expression in mathematical expression", node);
+
+            compileNode(bytecode, mathematicalExpression->getLeftOperand(), evaluator);
+            compileNode(bytecode, mathematicalExpression->getRightOperand(), evaluator);
+            instructions.push_back({ OpCode::Operation, 0, node });
+
+            tryFoldConstants(bytecode, startInstruction, 2);
+        } else if (auto ternaryExpression = dynamic_cast<const ASTNodeTernaryExpression*>(node)) {
+            if (ternaryExpression->getFirstOperand() == nullptr || ternaryExpression->getSecondOperand() == nullptr || ternaryExpression->getThirdOperand() == nullptr)
+                LogConsole::abortEvaluation("attempted to use void expression in mathematical expression", node);
+
+            // All operands are always evaluated as their types need to match
+            compileNode(bytecode, ternaryExpression->getFirstOperand(), evaluator);
+            compileNode(bytecode, ternaryExpression->getSecondOperand(), evaluator);
+            compileNode(bytecode, ternaryExpression->getThirdOperand(), evaluator);
+            instructions.push_back({ OpCode::Select, 0, node });
+
+            tryFoldConstants(bytecode, startInstruction, 3);
+        } else if (auto castExpression = dynamic_cast<const ASTNodeCast*>(node)) {
+            compileNode(bytecode, castExpression->getValue(), evaluator);
+            instructions.push_back({ OpCode::Cast, 0, node });
+        } else if (dynamic_cast<const ASTNodeTypeOperator*>(node)) {
+            instructions.push_back({ OpCode::TypeOperator, 0, node });
+        } else if (auto functionCall = dynamic_cast<const ASTNodeFunctionCall*>(node)) {
+            for (auto param : functionCall->getParams())
+                compileNode(bytecode, param, evaluator);
+            instructions.push_back({ OpCode::Call, evaluator->findFunction(functionCall->getFunctionName()), node });
+        } else {
+            instructions.push_back({ OpCode::Evaluate, 0, node });
+        }
+    }
+
+    void Compiler::tryFoldConstants(Bytecode &bytecode, size_t startInstruction, u32 operandCount) {
+        auto &instructions = bytecode.instructions;
+        auto &constants = bytecode.constants;
+
+        // Operands that were constants themselves have been folded already and are the last constants in the list
+        if (instructions.size() - startInstruction != operandCount + 1)
+            return;
+
+        for (u32 i = 0; i < operandCount; i++) {
+            const auto &instruction = instructions[startInstruction + i];
+            if (instruction.opCode != OpCode::PushConstant || instruction.operand != constants.size() - operandCount + i)
+                return;
+        }
+
+        Bytecode constantExpression;
+        constantExpression.constants.assign(constants.end() - operandCount, constants.end());
+        for (u32 i = 0; i < operandCount; i++)
+            constantExpression.instructions.push_back({ OpCode::PushConstant, i, instructions[startInstruction + i].node });
+        constantExpression.instructions.push_back(instructions.back());
+
+        Token::Literal result;
+        try {
+            result = VirtualMachine().execute(constantExpression, nullptr);
+        } catch (const LogConsole::EvaluateError&) {
+            // Invalid expressions like divisions by zero still need to error out once they actually get evaluated
+            return;
+        }
+
+        auto node = instructions.back().node;
+
+        instructions.resize(startInstruction);
+        constants.resize(constants.size() - operandCount);
+
+        constants.push_back(std::move(result));
+        instructions.push_back({ OpCode::PushConstant, u32(constants.size() - 1), node });
+    }
+
+    Token::Literal VirtualMachine::execute(const Bytecode &bytecode, Evaluator *evaluator) {
+        auto &stack = this->m_stack;
+
+        const auto stackBase = stack.size();
+        ON_SCOPE_EXIT { stack.resize(stackBase); };
+
+        for (const auto &instruction : bytecode.instructions) {
+            switch (instruction.opCode) {
+                case OpCode::PushConstant:
+                    stack.push_back(bytecode.constants[instruction.operand]);
+                    break;
+                case OpCode::PushOffset:
+                    stack.emplace_back(u128(evaluator->dataOffset()));
+                    break;
+                case OpCode::LoadRValue: {
+                    auto value = static_cast<const ASTNodeRValue*>(instruction.node)->getValue(evaluator);
+                    stack.push_back(std::move(value));
+                    break;
+                }
+                case OpCode::TypeOperator: {
+                    auto value = static_cast<const ASTNodeTypeOperator*>(instruction.node)->getValue(evaluator);
+                    stack.push_back(std::move(value));
+                    break;
+                }
+                case OpCode::Operation: {
+                    auto right = std::move(stack.back());
+                    stack.pop_back();
+
+                    auto &left = stack.back();
+                    left = static_cast<const ASTNodeMathematicalExpression*>(instruction.node)->apply(left, right);
+                    break;
+                }
+                case OpCode::Select: {
+                    auto third = std::move(stack.back());
+                    stack.pop_back();
+                    auto second = std::move(stack.back());
+                    stack.pop_back();
+
+                    auto &first = stack.back();
+                    first = static_cast<const ASTNodeTernaryExpression*>(instruction.node)->apply(first, second, third);
+                    break;
+                }
+                case OpCode::Cast: {
+                    auto value = std::move(stack.back());
+                    stack.pop_back();
+
+                    auto result = static_cast<const ASTNodeCast*>(instruction.node)->cast(evaluator, value);
+                    stack.push_back(std::move(result));
+                    break;
+                }
+                case OpCode::Call: {
+                    auto functionCall = static_cast<const ASTNodeFunctionCall*>(instruction.node);
+                    const auto paramCount = functionCall->getParams().size();
+
+                    // Parameters get moved out of the stack as the called function might execute expressions itself
+                    std::vector<Token::Literal> params(std::make_move_iterator(stack.end() - paramCount), std::make_move_iterator(stack.end()));
+                    stack.resize(stack.size() - paramCount);
+
+                    // Functions defined after the expression got compiled can only be looked up now
+                    auto functionIndex = instruction.operand;
+                    if (functionIndex == Evaluator::NoFunction)
+                        functionIndex = evaluator->findFunction(functionCall->getFunctionName());
+
+                    auto result = functionCall->call(evaluator, functionIndex, params);
+                    if (!result.has_value())
+                        LogConsole::abortEvaluation(hex::format("function '{}' does not return a value", functionCall->getFunctionName()), functionCall);
+
+                    stack.push_back(std::move(result.value()));
+                    break;
+                }
+                case OpCode::Evaluate: {
+                    auto result = instruction.node->evaluate(evaluator);
+                    ON_SCOPE_EXIT { delete result; };
+
+                    auto literal = dynamic_cast<ASTNodeLiteral*>(result);
+                    if (literal == nullptr)
+                        LogConsole::abortEvaluation("expression does not evaluate to a value", instruction.node);
+
+                    stack.push_back(literal->getValue());
+                    break;
+                }
+            }
+        }
+
+        return std::move(stack.back());
+    }
+
+}
@@ -1,8 +1,31 @@
 #include <hex/pattern_language/evaluator.hpp>
 #include <hex/pattern_language/ast_node.hpp>
 
+#include <hex/providers/provider.hpp>
+
 namespace hex::pl {
 
+    Evaluator::Evaluator() : m_decodingContext(std::make_shared<DecodingContext>()) {
+        this->m_decodingContext->evaluator = this;
+    }
+
+    Evaluator::~Evaluator() {
+        {
+            std::scoped_lock lock(this->m_decodingContext->mutex);
+            this->m_decodingContext->evaluator = nullptr;
+        }
+
+        for (auto &func : this->m_customFunctionDefinitions)
+            delete func;
+
+        Arena::Scope scope(this->m_placementArena);
+
+        for (auto &[key, placement] : this->m_placementCache) {
+            for (auto &pattern : placement.patterns)
+                delete pattern;
+        }
+    }
+
     void Evaluator::createVariable(const std::string &name, ASTNode *type) {
         auto &variables = *this->getScope(0).scope;
         for (auto &variable : variables) {
@@ -77,10 +100,137 @@ namespace hex::pl {
         this->getStack().back() = castedLiteral;
     }
 
+    Token::Literal Evaluator::evaluateExpression(const ASTNode *expression) {
+        auto compiledExpression = this->m_compiledExpressions.find(expression);
+        if (compiledExpression == this->m_compiledExpressions.end())
+            compiledExpression = this->m_compiledExpressions.emplace(expression, Compiler::compile(expression, this)).first;
+
+        return this->m_virtualMachine.execute(compiledExpression->second, this);
+    }
+
+    float Evaluator::getProgress() const {
+        const auto size = this->m_progressSize.load(std::memory_order_relaxed);
+        if (size == 0)
+            return 0;
+
+        return std::min(1.0F, float(this->m_progressOffset.load(std::memory_order_relaxed)) / size);
+    }
+
+    void Evaluator::checkLimits() {
+        if (this->m_timeLimit != 0 && std::chrono::steady_clock::now() - this->m_evaluationStart > std::chrono::seconds(this->m_timeLimit))
+            LogConsole::abortEvaluation(hex::format("evaluation took longer than set limit of {}s", this->m_timeLimit));
+
+        if (this->m_patternArena == nullptr)
+            return;
+
+        if (this->m_patternLimit != 0 && this->m_patternArena->getAllocationCount() > this->m_patternLimit)
+            LogConsole::abortEvaluation(hex::format("pattern count exceeded set limit of {}", this->m_patternLimit));
+
+        if (this->m_memoryLimit != 0 && this->m_patternArena->getMemoryUsage() > this->m_memoryLimit)
+            LogConsole::abortEvaluation(hex::format("memory usage exceeded set limit of {} bytes", this->m_memoryLimit));
+    }
+
+    void Evaluator::readData(u64 address, void *buffer, size_t size) {
+        this->m_provider->readCached(address - this->m_dataBaseAddress + this->m_provider->getBaseAddress(), buffer, size);
+    }
+
+    bool Evaluator::isEvaluationCached(u64 evaluationId) const {
+        return std::any_of(this->m_placementCache.begin(), this->m_placementCache.end(), [evaluationId](const auto &entry) {
+            return entry.second.createdIn == evaluationId;
+        });
+    }
+
+    std::vector<PatternData*> Evaluator::createPlacement(ASTNode *node) {
+        auto placementHash = this->m_placementHashes.find(node);
+        if (placementHash == this->m_placementHashes.end() || this->m_provider == nullptr)
+            return node->createPatterns(this);
+
+        const auto &[hash, dependsOnOffset, dependencies] = placementHash->second;
+
+        // Besides its code, a placement depends on where it starts, the data, the palette, the settings and the variables it reads
+        u64 key = hash;
+        hashCombine(key, dependsOnOffset ? this->m_currOffset : 0);
+        hashCombine(key, this->m_provider->getID());
+        hashCombine(key, this->m_provider->getDataVersion());
+        hashCombine(key, this->m_dataBaseAddress);
+        hashCombine(key, SharedData::patternPaletteOffset);
+        hashCombine(key, static_cast<u64>(this->m_defaultEndian));
+        hashCombine(key, this->m_evalDepth);
+        hashCombine(key, this->m_arrayLimit);
+        hashCombine(key, this->m_patternLimit);
+        hashCombine(key, this->m_memoryLimit);
+        std::vector<u64> dependencyKeys;
+        for (auto dependency : dependencies) {
+            if (auto dependencyKey = this->m_placementKeys.find(dependency); dependencyKey != this->m_placementKeys.end())
+                dependencyKeys.push_back(dependencyKey->second);
+        }
+
+        std::sort(dependencyKeys.begin(), dependencyKeys.end());
+        for (auto dependencyKey : dependencyKeys)
+            hashCombine(key, dependencyKey);
+
+        this->m_placementKeys[node] = key;
+
+        if (auto cachedPlacement = this->m_placementCache.find(key); cachedPlacement != this->m_placementCache.end()) {
+            auto &placement = cachedPlacement->second;
+            placement.usedIn = this->m_evaluationId;
+
+            this->m_console.replay(placement.log);
+            this->m_currOffset = placement.endOffset;
+            SharedData::patternPaletteOffset = placement.endPaletteOffset;
+
+            std::vector<PatternData*> patterns;
+            for (auto &pattern : placement.patterns)
+                patterns.push_back(pattern->clone());
+
+            return patterns;
+        }
+
+        const auto &log = this->m_console.getLog();
+        auto logSize = log.size();
+
+        auto patterns = node->createPatterns(this);
+
+        CachedPlacement placement = { { }, this->m_currOffset, SharedData::patternPaletteOffset, { log.begin() + logSize, log.end() }, this->m_evaluationId, this->m_evaluationId };
+        {
+            // The cached copies outlive this evaluation so they can't come from the arena the returned patterns live in
+            Arena::Scope scope(this->m_placementArena);
+            for (auto &pattern : patterns)
+                placement.patterns.push_back(pattern->clone());
+        }
+
+        this->m_placementCache.emplace(key, std::move(placement));
+
+        return patterns;
+    }
+
     std::optional<std::vector<PatternData*>> Evaluator::evaluate(const std::vector<ASTNode*> &ast) {
+        std::scoped_lock decodingLock(this->m_decodingContext->mutex);
+
+        this->m_evaluationId++;
+        this->m_decodingContext->decodableEvaluations.insert(this->m_evaluationId);
+        this->m_placementKeys.clear();
+
+        this->m_running = true;
+        this->m_abortCheckCount = 0;
+        this->m_evaluationStart = std::chrono::steady_clock::now();
+        this->m_progressOffset = 0;
+        this->m_progressSize = this->m_provider != nullptr ? this->m_provider->getActualSize() : 0;
+        ON_SCOPE_EXIT { this->m_running = false; };
+
         this->m_stack.clear();
+        this->m_compiledExpressions.clear();
         this->m_customFunctions.clear();
         this->m_scopes.clear();
+        this->m_lowestAccessedScope = std::numeric_limits<u64>::max();
+
+        // Bind the builtin functions once so calls don't have to look through the registry anymore
+        this->m_functions.clear();
+        this->m_functionIndices.clear();
+        for (const auto &[name, function] : ContentRegistry::PatternLanguageFunctions::getEntries()) {
+            this->m_functionIndices.emplace(name, this->m_functions.size());
+            this->m_functions.push_back(function);
+        }
 
         for (auto &func : this->m_customFunctionDefinitions)
             delete func;
@@ -89,16 +239,19 @@ namespace hex::pl {
         std::vector<PatternData*> patterns;
 
         try {
+            // Aborting while the code was still being parsed stops the evaluation right away
+            this->handleAbort();
+
             pushScope(nullptr, patterns);
             for (auto node : ast) {
                 if (dynamic_cast<ASTNodeTypeDecl*>(node)) {
                     ;// Don't create patterns from type declarations
                 } else if (dynamic_cast<ASTNodeFunctionCall*>(node)) {
-                    delete node->evaluate(this);
+                    (void)node->execute(this);
                 } else if (dynamic_cast<ASTNodeFunctionDefinition*>(node)) {
                     this->m_customFunctionDefinitions.push_back(node->evaluate(this));
                 } else {
-                    auto newPatterns = node->createPatterns(this);
+                    auto newPatterns = this->createPlacement(node);
                     patterns.insert(patterns.end(), newPatterns.begin(), newPatterns.end());
                 }
 
@@ -117,6 +270,22 @@ namespace hex::pl {
             return std::nullopt;
         }
 
+        // Results that weren't reused this time most likely belong to code that has been changed
+        {
+            Arena::Scope scope(this->m_placementArena);
+
+            std::erase_if(this->m_placementCache, [this](auto &entry) {
+                auto &[key, placement] = entry;
+                if (placement.usedIn == this->m_evaluationId)
+                    return false;
+
+                for (auto &pattern : placement.patterns)
+                    delete pattern;
+
+                return true;
+            });
+        }
+
         return patterns;
     }
 
@@ -1,8 +1,10 @@
 #include <hex/pattern_language/lexer.hpp>
 
 #include <algorithm>
-#include <functional>
+#include <array>
 #include <optional>
+#include <span>
+#include <string_view>
 #include <vector>
 
 namespace hex::pl {
@@ -10,32 +12,57 @@ namespace hex::pl {
 #define TOKEN(type, value) Token::Type::type, Token::type::value, lineNumber
 #define VALUE_TOKEN(type, value) Token::Type::type, value, lineNumber
 
-    std::string matchTillInvalid(const char* characters, std::function<bool(char)> predicate) {
-        std::string ret;
+    enum CharacterClass : u8 {
+        Space           = 1 << 0,
+        IdentifierStart = 1 << 1,
+        IdentifierPart  = 1 << 2,
+        Digit           = 1 << 3,
+        IntegerLiteral  = 1 << 4
+    };
+
+    constexpr static auto CharacterClasses = [] {
+        std::array<u8, 256> classes = { };
+
+        for (u32 c = 0; c < classes.size(); c++) {
+            if (c == ' ' || (c >= '\t' && c <= '\r'))
+                classes[c] |= Space;
+            if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'))
+                classes[c] |= IdentifierStart | IdentifierPart;
+            if (c >= '0' && c <= '9')
+                classes[c] |= Digit | IdentifierPart | IntegerLiteral;
+            if (c == '_')
+                classes[c] |= IdentifierPart;
+            if ((c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f') || c == '.' || c == 'x' || c == 'U' || c == 'L')
+                classes[c] |= IntegerLiteral;
+        }
 
-        while (*characters != 0x00) {
-            ret += *characters;
-            characters++;
+        return classes;
+    }();
 
-            if (!predicate(*characters))
-                break;
-        }
+    constexpr static bool isCharacterClass(char c, u8 characterClass) {
+        return (CharacterClasses[static_cast<u8>(c)] & characterClass) != 0;
+    }
 
-        return ret;
+    size_t matchCharacterClass(std::string_view string, u8 characterClass) {
+        size_t length = 0;
+        while (length < string.length() && isCharacterClass(string[length], characterClass))
+            length++;
+
+        return length;
     }
 
-    size_t getIntegerLiteralLength(const std::string &string) {
-        return string.find_first_not_of("0123456789ABCDEFabcdef.xUL");
+    size_t getIntegerLiteralLength(std::string_view string) {
+        return matchCharacterClass(string, IntegerLiteral);
     }
 
-    std::optional<Token::Literal> parseIntegerLiteral(const std::string &string) {
+    std::optional<Token::Literal> parseIntegerLiteral(std::string_view string) {
         Token::ValueType type = Token::ValueType::Any;
         Token::Literal result;
 
         u8 base;
 
         auto endPos = getIntegerLiteralLength(string);
-        auto numberData = std::string_view(string).substr(0, endPos);
+        auto numberData = string.substr(0, endPos);
 
         if (numberData.ends_with('U')) {
             type = Token::ValueType::Unsigned128Bit;
@@ -78,7 +105,7 @@ namespace hex::pl {
 
             if (numberData.ends_with('.'))
                 return { };
-        } else if (isdigit(numberData[0])) {
+        } else if (isCharacterClass(numberData[0], Digit)) {
             base = 10;
 
             if (numberData.find_first_not_of("0123456789") != std::string_view::npos)
@@ -97,7 +124,7 @@ namespace hex::pl {
             for (const char& c : numberData) {
                 integer *= base;
 
-                if (isdigit(c))
+                if (isCharacterClass(c, Digit))
                     integer += (c - '0');
                 else if (c >= 'A' && c <= 'F')
                     integer += 10 + (c - 'A');
@@ -125,7 +152,7 @@ namespace hex::pl {
         return { };
     }
 
-    std::optional<std::pair<char, size_t>> getCharacter(const std::string &string) {
+    std::optional<std::pair<char, size_t>> getCharacter(std::string_view string) {
 
         if (string.length() < 1)
             return { };
@@ -176,7 +203,7 @@ namespace hex::pl {
         } else return {{ string[0], 1 }};
     }
 
-    std::optional<std::pair<std::string, size_t>> getStringLiteral(const std::string &string) {
+    std::optional<std::pair<std::string, size_t>> getStringLiteral(std::string_view string) {
         if (!string.starts_with('\"'))
             return { };
 
@@ -201,7 +228,7 @@ namespace hex::pl {
         return {{ result, size + 1 }};
     }
 
-    std::optional<std::pair<char, size_t>> getCharacterLiteral(const std::string &string) {
+    std::optional<std::pair<char, size_t>> getCharacterLiteral(std::string_view string) {
         if (string.empty())
             return { };
 
@@ -222,23 +249,158 @@ namespace hex::pl {
         return {{ c, charSize + 2 }};
     }
 
+    Lexer::Lexer() {
+        constexpr u32 lineNumber = 0;
+
+        auto addSymbol = [this](const char *name, Token token) {
+            this->m_symbols.emplace(name, std::move(token));
+        };
+
+        // Reserved keywords
+        addSymbol("struct",     Token(TOKEN(Keyword, Struct)));
+        addSymbol("union",      Token(TOKEN(Keyword, Union)));
+        addSymbol("using",      Token(TOKEN(Keyword, Using)));
+        addSymbol("enum",       Token(TOKEN(Keyword, Enum)));
+        addSymbol("bitfield",   Token(TOKEN(Keyword, Bitfield)));
+        addSymbol("be",         Token(TOKEN(Keyword, BigEndian)));
+        addSymbol("le",         Token(TOKEN(Keyword, LittleEndian)));
+        addSymbol("if",         Token(TOKEN(Keyword, If)));
+        addSymbol("else",       Token(TOKEN(Keyword, Else)));
+        addSymbol("false",      Token(VALUE_TOKEN(Integer, Token::Literal(false))));
+        addSymbol("true",       Token(VALUE_TOKEN(Integer, Token::Literal(true))));
+        addSymbol("parent",     Token(TOKEN(Keyword, Parent)));
+        addSymbol("this",       Token(TOKEN(Keyword, This)));
+        addSymbol("while",      Token(TOKEN(Keyword, While)));
+        addSymbol("fn",         Token(TOKEN(Keyword, Function)));
+        addSymbol("return",     Token(TOKEN(Keyword, Return)));
+        addSymbol("namespace",  Token(TOKEN(Keyword, Namespace)));
+
+        // Built-in types
+        addSymbol("u8",         Token(TOKEN(ValueType, Unsigned8Bit)));
+        addSymbol("s8",         Token(TOKEN(ValueType, Signed8Bit)));
+        addSymbol("u16",        Token(TOKEN(ValueType, Unsigned16Bit)));
+        addSymbol("s16",        Token(TOKEN(ValueType, Signed16Bit)));
+        addSymbol("u32",        Token(TOKEN(ValueType, Unsigned32Bit)));
+        addSymbol("s32",        Token(TOKEN(ValueType, Signed32Bit)));
+        addSymbol("u64",        Token(TOKEN(ValueType, Unsigned64Bit)));
+        addSymbol("s64",        Token(TOKEN(ValueType, Signed64Bit)));
+        addSymbol("u128",       Token(TOKEN(ValueType, Unsigned128Bit)));
+        addSymbol("s128",       Token(TOKEN(ValueType, Signed128Bit)));
+        addSymbol("float",      Token(TOKEN(ValueType, Float)));
+        addSymbol("double",     Token(TOKEN(ValueType, Double)));
+        addSymbol("char",       Token(TOKEN(ValueType, Character)));
+        addSymbol("char16",     Token(TOKEN(ValueType, Character16)));
+        addSymbol("bool",       Token(TOKEN(ValueType, Boolean)));
+        addSymbol("str",        Token(TOKEN(ValueType, String)));
+        addSymbol("padding",    Token(TOKEN(ValueType, Padding)));
+    }
+
+    const Token& Lexer::getSymbol(std::string_view name) {
+        auto symbol = this->m_symbols.find(name);
+
+        // If it's not a keyword or a builtin type, it has to be an identifier
+        if (symbol == this->m_symbols.end()) {
+            constexpr u32 lineNumber = 0;
+
+            symbol = this->m_symbols.emplace(name, Token(TOKEN(Separator, EndOfProgram))).first;
+            symbol->second = Token(VALUE_TOKEN(Identifier, Token::Identifier(symbol->first)));
+        }
+
+        return symbol->second;
+    }
+
+    const Lexer::CachedLine* Lexer::findCachedLine(size_t hash, std::string_view line) const {
+        auto cachedLine = std::lower_bound(this->m_lineCache.begin(), this->m_lineCache.end(), hash, [](const CachedLine &cachedLine, size_t hash) {
+            return cachedLine.hash < hash;
+        });
+
+        for (; cachedLine != this->m_lineCache.end() && cachedLine->hash == hash; cachedLine++) {
+            if (std::string_view(this->m_cachedCode).substr(cachedLine->codeOffset, cachedLine->codeSize) == line)
+                return &*cachedLine;
+        }
+
+        return nullptr;
+    }
+
     std::optional<std::vector<Token>> Lexer::lex(const std::string& code) {
         std::vector<Token> tokens;
         u32 offset = 0;
 
+        // Tokens are big, growing the vector token by token ends up moving all of them around multiple times
+        tokens.reserve(std::max<size_t>(this->m_cachedTokens.size(), code.length() / 4));
+
         u32 lineNumber = 1;
 
+        decltype(this->m_lineCache) lineCache;
+        bool startOfLine = true;
+        size_t lineStart = 0, lineEnd = std::string::npos, lineFirstToken = 0, lineHash = 0;
+
         try {
 
             while (offset < code.length()) {
+                if (startOfLine) {
+                    startOfLine = false;
+
+                    lineStart = offset;
+                    lineEnd = code.find('\n', offset);
+                    lineFirstToken = tokens.size();
+
+                    if (lineEnd != std::string::npos) {
+                        std::string_view line(&code[lineStart], lineEnd - lineStart);
+                        lineHash = std::hash<std::string_view>{}(line);
+
+                        if (auto cachedLine = this->findCachedLine(lineHash, line); cachedLine != nullptr) {
+                            auto cachedTokens = this->m_cachedTokens.begin() + cachedLine->firstToken;
+                            for (const auto &token : std::span(cachedTokens, cachedLine->tokenCount)) {
+                                auto &newToken = tokens.emplace_back(token);
+                                newToken.lineNumber = lineNumber;
+                            }
+
+                            offset = lineEnd;
+                            continue;
+                        }
+                    }
+                }
+
                 const char& c = code[offset];
+                std::string_view remaining(&code[offset], code.length() - offset);
 
                 if (c == 0x00)
                     break;
 
-                if (std::isblank(c) || std::isspace(c)) {
-                    if (code[offset] == '\n') lineNumber++;
+                if (isCharacterClass(c, Space)) {
+                    if (code[offset] == '\n') {
+                        // Only lines that didn't have any token reach into the next line can be reused on their own
+                        if (offset == lineEnd && tokens.size() > lineFirstToken)
+                            lineCache.push_back({ lineHash, u32(lineStart), u32(lineEnd - lineStart), u32(lineFirstToken), u32(tokens.size() - lineFirstToken) });
+
+                        lineNumber++;
+                        startOfLine = true;
+                    }
                     offset += 1;
+                } else if (isCharacterClass(c, IdentifierStart)) {
+                    if (remaining.starts_with("addressof")) {
+                        tokens.emplace_back(TOKEN(Operator, AddressOf));
+                        offset += 9;
+                    } else if (remaining.starts_with("sizeof")) {
+                        tokens.emplace_back(TOKEN(Operator, SizeOf));
+                        offset += 6;
+                    } else {
+                        auto identifier = remaining.substr(0, 1 + matchCharacterClass(remaining.substr(1), IdentifierPart));
+
+                        auto &token = tokens.emplace_back(this->getSymbol(identifier));
+                        token.lineNumber = lineNumber;
+
+                        offset += identifier.length();
+                    }
+                } else if (isCharacterClass(c, Digit)) {
+                    auto integer = parseIntegerLiteral(remaining);
+
+                    if (!integer.has_value())
+                        throwLexerError("invalid integer literal", lineNumber);
+
+                    tokens.emplace_back(VALUE_TOKEN(Integer, Token::Literal(integer.value())));
+                    offset += getIntegerLiteralLength(remaining);
                 } else if (c == ';') {
                     tokens.emplace_back(TOKEN(Separator, EndOfExpression));
                     offset += 1;
@@ -266,31 +428,31 @@ namespace hex::pl {
                 } else if (c == '.') {
                     tokens.emplace_back(TOKEN(Separator, Dot));
                     offset += 1;
-                } else if (code.substr(offset, 2) == "::") {
+                } else if (remaining.starts_with("::")) {
                     tokens.emplace_back(TOKEN(Operator, ScopeResolution));
                     offset += 2;
                 } else if (c == '@') {
                     tokens.emplace_back(TOKEN(Operator, AtDeclaration));
                     offset += 1;
-                } else if (code.substr(offset, 2) == "==") {
+                } else if (remaining.starts_with("==")) {
                     tokens.emplace_back(TOKEN(Operator, BoolEquals));
                     offset += 2;
-                } else if (code.substr(offset, 2) == "!=") {
+                } else if (remaining.starts_with("!=")) {
                     tokens.emplace_back(TOKEN(Operator, BoolNotEquals));
                     offset += 2;
-                } else if (code.substr(offset, 2) == ">=") {
+                } else if (remaining.starts_with(">=")) {
                     tokens.emplace_back(TOKEN(Operator, BoolGreaterThanOrEquals));
                     offset += 2;
-                } else if (code.substr(offset, 2) == "<=") {
+                } else if (remaining.starts_with("<=")) {
                     tokens.emplace_back(TOKEN(Operator, BoolLessThanOrEquals));
                     offset += 2;
-                } else if (code.substr(offset, 2) == "&&") {
+                } else if (remaining.starts_with("&&")) {
                     tokens.emplace_back(TOKEN(Operator, BoolAnd));
                     offset += 2;
-                } else if (code.substr(offset, 2) == "||") {
+                } else if (remaining.starts_with("||")) {
                     tokens.emplace_back(TOKEN(Operator, BoolOr));
                     offset += 2;
-                } else if (code.substr(offset, 2) == "^^") {
+                } else if (remaining.starts_with("^^")) {
                     tokens.emplace_back(TOKEN(Operator, BoolXor));
                     offset += 2;
                 } else if (c == '=') {
@@ -314,10 +476,10 @@ namespace hex::pl {
                 } else if (c == '%') {
                     tokens.emplace_back(TOKEN(Operator, Percent));
                     offset += 1;
-                } else if (code.substr(offset, 2) == "<<") {
+                } else if (remaining.starts_with("<<")) {
                     tokens.emplace_back(TOKEN(Operator, ShiftLeft));
                     offset += 2;
-                } else if (code.substr(offset, 2) == ">>") {
+                } else if (remaining.starts_with(">>")) {
                     tokens.emplace_back(TOKEN(Operator, ShiftRight));
                     offset += 2;
                 } else if (c == '>') {
@@ -347,16 +509,8 @@ namespace hex::pl {
                 } else if (c == '$') {
                     tokens.emplace_back(TOKEN(Operator, Dollar));
                     offset += 1;
-                } else if (code.substr(offset, 9) == "addressof") {
-                    tokens.emplace_back(TOKEN(Operator, AddressOf));
-                    offset += 9;
-                }
-                else if (code.substr(offset, 6) == "sizeof") {
-                    tokens.emplace_back(TOKEN(Operator, SizeOf));
-                    offset += 6;
-                }
-                else if (c == '\'') {
-                    auto character = getCharacterLiteral(code.substr(offset));
+                } else if (c == '\'') {
+                    auto character = getCharacterLiteral(remaining);
 
                     if (!character.has_value())
                         throwLexerError("invalid character literal", lineNumber);
@@ -366,7 +520,7 @@ namespace hex::pl {
                     tokens.emplace_back(VALUE_TOKEN(Integer, Token::Literal(c)));
                     offset += charSize;
                 } else if (c == '\"') {
-                    auto string = getStringLiteral(code.substr(offset));
+                    auto string = getStringLiteral(remaining);
 
                     if (!string.has_value())
                         throwLexerError("invalid string literal", lineNumber);
@@ -375,97 +529,6 @@ namespace hex::pl {
 
                     tokens.emplace_back(VALUE_TOKEN(String, Token::Literal(s)));
                     offset += stringSize;
-                } else if (std::isalpha(c)) {
-                    std::string identifier = matchTillInvalid(&code[offset], [](char c) -> bool { return std::isalnum(c) || c == '_'; });
-
-                    // Check for reserved keywords
-
-                    if (identifier == "struct")
-                        tokens.emplace_back(TOKEN(Keyword, Struct));
-                    else if (identifier == "union")
-                        tokens.emplace_back(TOKEN(Keyword, Union));
-                    else if (identifier == "using")
-                        tokens.emplace_back(TOKEN(Keyword, Using));
-                    else if (identifier == "enum")
-                        tokens.emplace_back(TOKEN(Keyword, Enum));
-                    else if (identifier == "bitfield")
-                        tokens.emplace_back(TOKEN(Keyword, Bitfield));
-                    else if (identifier == "be")
-                        tokens.emplace_back(TOKEN(Keyword, BigEndian));
-                    else if (identifier == "le")
-                        tokens.emplace_back(TOKEN(Keyword, LittleEndian));
-                    else if (identifier == "if")
-                        tokens.emplace_back(TOKEN(Keyword, If));
-                    else if (identifier == "else")
-                        tokens.emplace_back(TOKEN(Keyword, Else));
-                    else if (identifier == "false")
-                        tokens.emplace_back(VALUE_TOKEN(Integer, Token::Literal(false)));
-                    else if (identifier == "true")
-                        tokens.emplace_back(VALUE_TOKEN(Integer, Token::Literal(true)));
-                    else if (identifier == "parent")
-                        tokens.emplace_back(TOKEN(Keyword, Parent));
-                    else if (identifier == "this")
-                        tokens.emplace_back(TOKEN(Keyword, This));
-                    else if (identifier == "while")
-                        tokens.emplace_back(TOKEN(Keyword, While));
-                    else if (identifier == "fn")
-                        tokens.emplace_back(TOKEN(Keyword, Function));
-                    else if (identifier == "return")
-                        tokens.emplace_back(TOKEN(Keyword, Return));
-                    else if (identifier == "namespace")
-                        tokens.emplace_back(TOKEN(Keyword, Namespace));
-
-                        // Check for built-in types
-                    else if (identifier == "u8")
-                        tokens.emplace_back(TOKEN(ValueType, Unsigned8Bit));
-                    else if (identifier == "s8")
-                        tokens.emplace_back(TOKEN(ValueType, Signed8Bit));
-                    else if (identifier == "u16")
-                        tokens.emplace_back(TOKEN(ValueType, Unsigned16Bit));
-                    else if (identifier == "s16")
-                        tokens.emplace_back(TOKEN(ValueType, Signed16Bit));
-                    else if (identifier == "u32")
-                        tokens.emplace_back(TOKEN(ValueType, Unsigned32Bit));
-                    else if (identifier == "s32")
-                        tokens.emplace_back(TOKEN(ValueType, Signed32Bit));
-                    else if (identifier == "u64")
-                        tokens.emplace_back(TOKEN(ValueType, Unsigned64Bit));
-                    else if (identifier == "s64")
-                        tokens.emplace_back(TOKEN(ValueType, Signed64Bit));
-                    else if (identifier == "u128")
-                        tokens.emplace_back(TOKEN(ValueType, Unsigned128Bit));
-                    else if (identifier == "s128")
-                        tokens.emplace_back(TOKEN(ValueType, Signed128Bit));
-                    else if (identifier == "float")
-                        tokens.emplace_back(TOKEN(ValueType, Float));
-                    else if (identifier == "double")
-                        tokens.emplace_back(TOKEN(ValueType, Double));
-                    else if (identifier == "char")
-                        tokens.emplace_back(TOKEN(ValueType, Character));
-                    else if (identifier == "char16")
-                        tokens.emplace_back(TOKEN(ValueType, Character16));
-                    else if (identifier == "bool")
-                        tokens.emplace_back(TOKEN(ValueType, Boolean));
-                    else if (identifier == "str")
-                        tokens.emplace_back(TOKEN(ValueType, String));
-                    else if (identifier == "padding")
-                        tokens.emplace_back(TOKEN(ValueType, Padding));
-
-                    // If it's not a keyword and a builtin type, it has to be an identifier
-
-                    else
-                        tokens.emplace_back(VALUE_TOKEN(Identifier, Token::Identifier(identifier)));
-
-                    offset += identifier.length();
-                } else if (std::isdigit(c)) {
-                    auto integer = parseIntegerLiteral(&code[offset]);
-
-                    if (!integer.has_value())
-                        throwLexerError("invalid integer literal", lineNumber);
-
-
-                    tokens.emplace_back(VALUE_TOKEN(Integer, Token::Literal(integer.value())));
-                    offset += getIntegerLiteralLength(&code[offset]);
                 } else
                     throwLexerError("unknown token", lineNumber);
 
@@ -474,9 +537,18 @@ namespace hex::pl {
             tokens.emplace_back(TOKEN(Separator, EndOfProgram));
         } catch (LexerError &e) {
             this->m_error = e;
+
+            // Keep the lines of the last run around, the tokens they refer to are still there
             return { };
         }
 
+        std::sort(lineCache.begin(), lineCache.end(), [](const CachedLine &left, const CachedLine &right) {
+            return left.hash < right.hash;
+        });
+
+        this->m_lineCache = std::move(lineCache);
+        this->m_cachedCode = code;
+        this->m_cachedTokens = tokens;
 
         return tokens;
     }
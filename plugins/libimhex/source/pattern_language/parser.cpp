@@ -1,6 +1,7 @@
 #include <hex/pattern_language/parser.hpp>
 
 #include <optional>
+#include <unordered_set>
 
 #define MATCHES(x) (begin() && x)
 
@@ -1008,6 +1009,7 @@ namespace hex::pl {
 
     // <(parseUsingDeclaration)|(parseVariablePlacement)|(parseStruct)>
     std::vector<ASTNode*> Parser::parseStatements() {
+        auto statementBegin = this->m_curr;
         ASTNode *statement;
 
         if (MATCHES(sequence(KEYWORD_USING, IDENTIFIER, OPERATOR_ASSIGNMENT)))
@@ -1061,14 +1063,141 @@ namespace hex::pl {
             this->m_types.insert({ typeName, typeDecl });
         }
 
+        addStatement(statement, statementBegin);
+
         return { statement };
     }
 
+    namespace {
+
+        std::string getSimpleName(const std::string &name) {
+            if (auto separator = name.rfind("::"); separator != std::string::npos)
+                return name.substr(separator + 2);
+            else
+                return name;
+        }
+
+        u64 hashToken(const Token &token) {
+            u64 hash = static_cast<u64>(token.type);
+            hashCombine(hash, token.value.index());
+
+            std::visit(overloaded {
+                [&](const Token::Literal &literal) {
+                    hashCombine(hash, literal.index());
+                    std::visit(overloaded {
+                        [&](const std::string &value) { hashCombine(hash, std::hash<std::string>{}(value)); },
+                        [&](PatternData * const &value) { hashCombine(hash, reinterpret_cast<u64>(value)); },
+                        [&](double value) { hashCombine(hash, std::bit_cast<u64>(value)); },
+                        [&](auto &&value) {
+                            hashCombine(hash, static_cast<u64>(value));
+                            hashCombine(hash, static_cast<u64>(static_cast<u128>(value) >> 64));
+                        }
+                    }, literal);
+                },
+                [&](const Token::Identifier &identifier) { hashCombine(hash, std::hash<std::string>{}(identifier.get())); },
+                [&](auto &&value) { hashCombine(hash, static_cast<u64>(value)); }
+            }, token.value);
+
+            return hash;
+        }
+
+    }
+
+    void Parser::addStatement(ASTNode *node, TokenIter begin) {
+        // The same code inside of a different namespace declares different types
+        Statement statement = { node, std::hash<std::string>{}(getNamespacePrefixedName("")), { }, { }, false, false };
+
+        for (auto token = begin; token != this->m_curr; token++) {
+            hashCombine(statement.hash, hashToken(*token));
+
+            if (auto identifier = std::get_if<Token::Identifier>(&token->value); identifier != nullptr)
+                statement.referencedNames.push_back(identifier->get());
+            else if (auto literal = std::get_if<Token::Literal>(&token->value); literal != nullptr) {
+                // Functions also get referenced by name from attributes like [[format("name")]]
+                if (auto string = std::get_if<std::string>(literal); string != nullptr)
+                    statement.referencedNames.push_back(getSimpleName(*string));
+            } else if (auto op = std::get_if<Token::Operator>(&token->value); op != nullptr) {
+                if (*op == Token::Operator::Dollar)
+                    statement.readsCurrentOffset = true;
+                else if (*op == Token::Operator::AtDeclaration)
+                    statement.hasPlacementOffset = true;
+            }
+        }
+
+        if (auto typeDecl = dynamic_cast<ASTNodeTypeDecl*>(node); typeDecl != nullptr)
+            statement.declaredNames.push_back(getSimpleName(typeDecl->getName()));
+        else if (auto functionDefinition = dynamic_cast<ASTNodeFunctionDefinition*>(node); functionDefinition != nullptr)
+            statement.declaredNames.push_back(getSimpleName(functionDefinition->getName()));
+        else if (auto variableDecl = dynamic_cast<ASTNodeVariableDecl*>(node); variableDecl != nullptr)
+            statement.declaredNames.push_back(variableDecl->getName());
+        else if (auto arrayVariableDecl = dynamic_cast<ASTNodeArrayVariableDecl*>(node); arrayVariableDecl != nullptr)
+            statement.declaredNames.push_back(arrayVariableDecl->getName());
+        else if (auto pointerVariableDecl = dynamic_cast<ASTNodePointerVariableDecl*>(node); pointerVariableDecl != nullptr)
+            statement.declaredNames.push_back(pointerVariableDecl->getName());
+
+        this->m_statements.push_back(std::move(statement));
+    }
+
+    void Parser::hashPlacements() {
+        auto isPlacement = [](ASTNode *node) {
+            return dynamic_cast<ASTNodeTypeDecl*>(node) == nullptr &&
+                   dynamic_cast<ASTNodeFunctionDefinition*>(node) == nullptr &&
+                   dynamic_cast<ASTNodeFunctionCall*>(node) == nullptr;
+        };
+
+        std::unordered_multimap<std::string, size_t> declarations;
+        for (size_t i = 0; i < this->m_statements.size(); i++) {
+            for (const auto &name : this->m_statements[i].declaredNames)
+                declarations.emplace(name, i);
+        }
+
+        for (size_t i = 0; i < this->m_statements.size(); i++) {
+            const auto &statement = this->m_statements[i];
+            if (!isPlacement(statement.node))
+                continue;
+
+            // Combine the placement with everything it refers to, directly or through other types, functions and variables
+            Evaluator::PlacementHash placementHash = { 0, !statement.hasPlacementOffset, { } };
+            std::vector<u64> hashes;
+            std::unordered_set<size_t> visited;
+            std::vector<size_t> pending = { i };
+
+            while (!pending.empty()) {
+                auto index = pending.back();
+                pending.pop_back();
+
+                if (!visited.insert(index).second)
+                    continue;
+
+                const auto &dependency = this->m_statements[index];
+                hashes.push_back(dependency.hash);
+                placementHash.dependsOnOffset |= dependency.readsCurrentOffset;
+
+                if (index != i && isPlacement(dependency.node))
+                    placementHash.dependencies.push_back(dependency.node);
+
+                for (const auto &name : dependency.referencedNames) {
+                    auto [begin, end] = declarations.equal_range(name);
+                    for (auto declaration = begin; declaration != end; declaration++)
+                        pending.push_back(declaration->second);
+                }
+            }
+
+            std::sort(hashes.begin(), hashes.end());
+            for (auto hash : hashes)
+                hashCombine(placementHash.hash, hash);
+
+            this->m_placementHashes.emplace(statement.node, std::move(placementHash));
+        }
+    }
+
     // <(parseNamespace)...> EndOfProgram
     std::optional<std::vector<ASTNode*>> Parser::parse(const std::vector<Token> &tokens) {
         this->m_curr = tokens.begin();
 
         this->m_types.clear();
+        this->m_statements.clear();
+        this->m_placementHashes.clear();
 
         this->m_currNamespace.clear();
         this->m_currNamespace.emplace_back();
@@ -1079,6 +1208,8 @@ namespace hex::pl {
             if (program.empty() || this->m_curr != tokens.end())
                 throwParseError("program is empty!", -1);
 
+            hashPlacements();
+
             return program;
         } catch (ParseError &e) {
             this->m_error = e;
@@ -0,0 +1,647 @@
+#include <hex/pattern_language/pattern_exporter.hpp>
+
+#include <hex/pattern_language/pattern_data.hpp>
+#include <hex/providers/provider.hpp>
+#include <hex/helpers/file.hpp>
+#include <hex/helpers/fmt.hpp>
+#include <hex/helpers/utils.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <codecvt>
+#include <cstring>
+#include <locale>
+
+namespace hex::pl {
+
+    namespace {
+
+        constexpr size_t WindowSize = 0x10'0000;
+        constexpr size_t FlushSize  = 0x10'0000;
+
+        /* Patterns that get turned into a single value from their own bytes */
+        bool isValuePattern(PatternData *pattern) {
+            return dynamic_cast<PatternDataUnsigned*>(pattern)    != nullptr ||
+                   dynamic_cast<PatternDataSigned*>(pattern)      != nullptr ||
+                   dynamic_cast<PatternDataFloat*>(pattern)       != nullptr ||
+                   dynamic_cast<PatternDataBoolean*>(pattern)     != nullptr ||
+                   dynamic_cast<PatternDataCharacter*>(pattern)   != nullptr ||
+                   dynamic_cast<PatternDataCharacter16*>(pattern) != nullptr ||
+                   dynamic_cast<PatternDataString*>(pattern)      != nullptr ||
+                   dynamic_cast<PatternDataString16*>(pattern)    != nullptr ||
+                   dynamic_cast<PatternDataEnum*>(pattern)        != nullptr;
+        }
+
+        bool isExported(PatternData *pattern) {
+            return pattern != nullptr && !pattern->isHidden() && dynamic_cast<PatternDataPadding*>(pattern) == nullptr;
+        }
+
+        const std::vector<PatternData*>* getMembers(PatternData *pattern) {
+            if (auto structPattern = dynamic_cast<PatternDataStruct*>(pattern); structPattern != nullptr)
+                return &structPattern->getMembers();
+            else if (auto unionPattern = dynamic_cast<PatternDataUnion*>(pattern); unionPattern != nullptr)
+                return &unionPattern->getMembers();
+            else if (auto bitfieldPattern = dynamic_cast<PatternDataBitfield*>(pattern); bitfieldPattern != nullptr)
+                return &bitfieldPattern->getFields();
+            else
+                return nullptr;
+        }
+
+        /* Checks UTF-8 piece by piece so strings don't have to be in memory all at once */
+        class UTF8Validator {
+        public:
+            void feed(const u8 *data, size_t size) {
+                for (size_t i = 0; i < size && this->m_valid; i++) {
+                    const u8 byte = data[i];
+
+                    if (this->m_continuationBytes > 0) {
+                        this->m_valid = (byte & 0xC0) == 0x80;
+                        this->m_continuationBytes--;
+                    }
+                    else if (byte < 0x80)           this->m_continuationBytes = 0;
+                    else if ((byte & 0xE0) == 0xC0) this->m_continuationBytes = 1;
+                    else if ((byte & 0xF0) == 0xE0) this->m_continuationBytes = 2;
+                    else if ((byte & 0xF8) == 0xF0) this->m_continuationBytes = 3;
+                    else this->m_valid = false;
+                }
+            }
+
+            [[nodiscard]] bool isValid() const {
+                return this->m_valid && this->m_continuationBytes == 0;
+            }
+
+        private:
+            bool m_valid = true;
+            u32 m_continuationBytes = 0;
+        };
+
+        bool isValidUTF8(const std::string &string) {
+            UTF8Validator validator;
+            validator.feed(reinterpret_cast<const u8*>(string.data()), string.size());
+
+            return validator.isValid();
+        }
+
+        std::string latin1ToUTF8(const std::string &string) {
+            std::string result;
+            for (u8 byte : string) {
+                if (byte < 0x80)
+                    result += char(byte);
+                else {
+                    result += char(0xC0 | (byte >> 6));
+                    result += char(0x80 | (byte & 0x3F));
+                }
+            }
+
+            return result;
+        }
+
+        /* 8 bit strings are exported as they are if they're valid UTF-8. Anything else gets treated as Latin-1 */
+        std::string toUTF8(std::string string) {
+            if (isValidUTF8(string))
+                return string;
+
+            return latin1ToUTF8(string);
+        }
+
+        std::string toUTF8(const std::u16string &string) {
+            return std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t>("?").to_bytes(string);
+        }
+
+        std::string escapeJSON(const std::string &string) {
+            std::string result;
+            result.reserve(string.size());
+
+            for (char c : string) {
+                switch (c) {
+                    case '"':   result += "\\\""; break;
+                    case '\\':  result += "\\\\"; break;
+                    case '\n':  result += "\\n";  break;
+                    case '\r':  result += "\\r";  break;
+                    case '\t':  result += "\\t";  break;
+                    default:
+                        if (u8(c) < 0x20)
+                            result += hex::format("\\u{:04X}", u8(c));
+                        else
+                            result += c;
+                }
+            }
+
+            return result;
+        }
+
+        std::string escapeCSV(const std::string &string) {
+            if (string.find_first_of(",\"\r\n") == std::string::npos)
+                return string;
+
+            std::string result = "\"";
+            for (char c : string) {
+                if (c == '"')
+                    result += '"';
+                result += c;
+            }
+            result += '"';
+
+            return result;
+        }
+
+    }
+
+    PatternExporter::PatternExporter(prv::Provider *provider, Format format) : m_provider(provider), m_format(format) {
+        // Pattern offsets include the base address, the data gets read independently of the current page
+        if (provider != nullptr)
+            this->m_dataStart = provider->getBaseAddress() - prv::Provider::PageSize * provider->getCurrentPage();
+    }
+
+    bool PatternExporter::exportToFile(const std::vector<PatternData*> &patterns, const std::string &path) {
+        const std::atomic<bool> cancelled = false;
+
+        return this->exportToFile(patterns, path, cancelled);
+    }
+
+    bool PatternExporter::exportToFile(const std::vector<PatternData*> &patterns, const std::string &path, const std::atomic<bool> &cancelled) {
+        if (this->m_provider == nullptr || !this->m_provider->isReadable())
+            return false;
+
+        File file(path, File::Mode::Create);
+        if (!file.isValid())
+            return false;
+
+        this->m_file = &file;
+        this->m_cancelled = &cancelled;
+        ON_SCOPE_EXIT {
+            this->m_file = nullptr;
+            this->m_cancelled = nullptr;
+            this->m_writeFailed = false;
+            this->m_outputBuffer.clear();
+            this->m_window.clear();
+            this->m_windowValid = false;
+        };
+
+        switch (this->m_format) {
+            case Format::JSON: {
+                bool first = true;
+
+                this->write("{");
+                for (auto &pattern : patterns) {
+                    if (!isExported(pattern) || this->hasFailed())
+                        continue;
+
+                    this->write(hex::format("{}    \"{}\": ", first ? "\n" : ",\n", escapeJSON(pattern->getVariableName())));
+                    this->exportJSON(pattern, 1);
+                    first = false;
+                }
+                this->write(first ? " }\n" : "\n}\n");
+                break;
+            }
+            case Format::CSV:
+                this->write("name,type,offset,size,value\n");
+                for (auto &pattern : patterns) {
+                    if (isExported(pattern))
+                        this->exportCSV(pattern, pattern->getVariableName());
+                }
+                break;
+            case Format::Binary:
+                for (auto &pattern : patterns) {
+                    if (isExported(pattern))
+                        this->exportBinary(pattern);
+                }
+                break;
+        }
+
+        this->flush();
+        if (!this->hasFailed() && !file.flush())
+            this->m_writeFailed = true;
+
+        return !this->hasFailed();
+    }
+
+    const char* PatternExporter::getFileExtension(Format format) {
+        switch (format) {
+            case Format::JSON:      return "json";
+            case Format::CSV:       return "csv";
+            case Format::Binary:    return "bin";
+            default:                return "";
+        }
+    }
+
+
+    void PatternExporter::exportJSON(PatternData *pattern, u32 indent) {
+        const std::string indentation(indent * 4, ' '), innerIndentation((indent + 1) * 4, ' ');
+
+        if (this->hasFailed()) {
+            return;
+        } else if (pattern == nullptr) {
+            // Entries of lazy arrays that failed to decode
+            this->write("null");
+        } else if (auto pointerPattern = dynamic_cast<PatternDataPointer*>(pattern); pointerPattern != nullptr) {
+            this->exportJSON(pointerPattern->getPointedAtPattern(), indent);
+        } else if (auto members = getMembers(pattern); members != nullptr) {
+            bool first = true;
+
+            this->write("{");
+            for (auto &member : *members) {
+                if (!isExported(member))
+                    continue;
+
+                this->write(hex::format("{}{}\"{}\": ", first ? "\n" : ",\n", innerIndentation, escapeJSON(member->getVariableName())));
+                this->exportJSON(member, indent + 1);
+                first = false;
+            }
+            this->write(first ? " }" : "\n" + indentation + "}");
+        } else if (auto staticArrayPattern = dynamic_cast<PatternDataStaticArray*>(pattern); staticArrayPattern != nullptr) {
+            auto templ = staticArrayPattern->getTemplate();
+
+            if (isValuePattern(templ)) {
+                this->exportValueArrayJSON(templ, pattern->getOffset(), staticArrayPattern->getEntryCount(), indent);
+                return;
+            }
+
+            // All entries are the same so a single copy of the template gets moved over all of them
+            auto entry = templ->clone();
+            this->write("[");
+            for (u64 i = 0; i < staticArrayPattern->getEntryCount(); i++) {
+                entry->setOffset(pattern->getOffset() + i * templ->getSize());
+
+                this->write((i == 0 ? "\n" : ",\n") + innerIndentation);
+                this->exportJSON(entry, indent + 1);
+            }
+            this->write(staticArrayPattern->getEntryCount() == 0 ? " ]" : "\n" + indentation + "]");
+            delete entry;
+        } else if (auto dynamicArrayPattern = dynamic_cast<PatternDataDynamicArray*>(pattern); dynamicArrayPattern != nullptr) {
+            this->write("[");
+            dynamicArrayPattern->forEachEntry([&, this](u64 index, PatternData *entry) {
+                this->write((index == 0 ? "\n" : ",\n") + innerIndentation);
+                this->exportJSON(entry, indent + 1);
+            });
+            this->write(dynamicArrayPattern->getEntryCount() == 0 ? " ]" : "\n" + indentation + "]");
+        } else {
+            this->writeValue(pattern, pattern->getOffset());
+        }
+    }
+
+    void PatternExporter::exportCSV(PatternData *pattern, const std::string &path) {
+        if (pattern == nullptr || this->hasFailed()) {
+            return;
+        } else if (auto pointerPattern = dynamic_cast<PatternDataPointer*>(pattern); pointerPattern != nullptr) {
+            this->writeCSVRow(path, pattern, pattern->getOffset(), pattern->getSize());
+            this->exportCSV(pointerPattern->getPointedAtPattern(), path + ".*");
+        } else if (auto members = getMembers(pattern); members != nullptr) {
+            for (auto &member : *members) {
+                if (isExported(member))
+                    this->exportCSV(member, path + "." + member->getVariableName());
+            }
+        } else if (auto staticArrayPattern = dynamic_cast<PatternDataStaticArray*>(pattern); staticArrayPattern != nullptr) {
+            auto templ = staticArrayPattern->getTemplate();
+
+            if (isValuePattern(templ)) {
+                this->exportValueArrayCSV(templ, pattern->getOffset(), staticArrayPattern->getEntryCount(), path);
+                return;
+            }
+
+            auto entry = templ->clone();
+            for (u64 i = 0; i < staticArrayPattern->getEntryCount(); i++) {
+                entry->setOffset(pattern->getOffset() + i * templ->getSize());
+                this->exportCSV(entry, hex::format("{}[{}]", path, i));
+            }
+            delete entry;
+        } else if (auto dynamicArrayPattern = dynamic_cast<PatternDataDynamicArray*>(pattern); dynamicArrayPattern != nullptr) {
+            dynamicArrayPattern->forEachEntry([&, this](u64 index, PatternData *entry) {
+                this->exportCSV(entry, hex::format("{}[{}]", path, index));
+            });
+        } else {
+            this->writeCSVRow(path, pattern, pattern->getOffset(), pattern->getSize());
+        }
+    }
+
+    void PatternExporter::exportBinary(PatternData *pattern) {
+        if (pattern == nullptr || this->hasFailed()) {
+            return;
+        } else if (auto structPattern = dynamic_cast<PatternDataStruct*>(pattern); structPattern != nullptr) {
+            for (auto &member : structPattern->getMembers()) {
+                if (isExported(member))
+                    this->exportBinary(member);
+            }
+        } else if (auto staticArrayPattern = dynamic_cast<PatternDataStaticArray*>(pattern); staticArrayPattern != nullptr) {
+            auto templ = staticArrayPattern->getTemplate();
+
+            if (isValuePattern(templ)) {
+                this->writeData(pattern->getOffset(), templ->getSize() * staticArrayPattern->getEntryCount());
+                return;
+            }
+
+            auto entry = templ->clone();
+            for (u64 i = 0; i < staticArrayPattern->getEntryCount(); i++) {
+                entry->setOffset(pattern->getOffset() + i * templ->getSize());
+                this->exportBinary(entry);
+            }
+            delete entry;
+        } else if (auto dynamicArrayPattern = dynamic_cast<PatternDataDynamicArray*>(pattern); dynamicArrayPattern != nullptr) {
+            dynamicArrayPattern->forEachEntry([this](u64, PatternData *entry) {
+                this->exportBinary(entry);
+            });
+        } else {
+            // Unions, bitfields and pointers are written as a whole instead of following what's inside of them
+            this->writeData(pattern->getOffset(), pattern->getSize());
+        }
+    }
+
+
+    void PatternExporter::exportValueArrayJSON(PatternData *templ, u64 offset, u64 entryCount, u32 indent) {
+        const std::string indentation(indent * 4, ' '), innerIndentation((indent + 1) * 4, ' ');
+        const auto entrySize = templ->getSize();
+
+        if (entryCount == 0) {
+            this->write("[ ]");
+            return;
+        }
+
+        // Entries are decoded straight from the data instead of creating a pattern for each of them. Consecutive ones come out of the same window
+        this->write("[");
+        for (u64 i = 0; i < entryCount && !this->hasFailed(); i++) {
+            this->write((i == 0 ? "\n" : ",\n") + innerIndentation);
+            this->writeValue(templ, offset + i * entrySize);
+        }
+        this->write("\n" + indentation + "]");
+    }
+
+    void PatternExporter::exportValueArrayCSV(PatternData *templ, u64 offset, u64 entryCount, const std::string &path) {
+        const auto entrySize = templ->getSize();
+
+        for (u64 i = 0; i < entryCount && !this->hasFailed(); i++)
+            this->writeCSVRow(hex::format("{}[{}]", path, i), templ, offset + i * entrySize, entrySize);
+    }
+
+    void PatternExporter::writeCSVRow(const std::string &path, PatternData *pattern, u64 offset, size_t size) {
+        this->write(hex::format("{},{},0x{:X},{},", escapeCSV(path), escapeCSV(pattern->getFormattedName()), offset, size));
+        this->writeValue(pattern, offset);
+        this->write("\n");
+    }
+
+
+    PatternExporter::Value PatternExporter::formatValue(PatternData *pattern, const u8 *data) const {
+        const auto size = pattern->getSize();
+        const auto endian = pattern->getEndian();
+
+        if (auto fieldPattern = dynamic_cast<PatternDataBitfieldField*>(pattern); fieldPattern != nullptr) {
+            // Fields get passed the bytes of the bitfield they're part of
+            auto parent = fieldPattern->getParent();
+
+            std::vector<u8> value(data, data + parent->getSize());
+            if (value.empty())
+                return { "0", false };
+
+            if (parent->getEndian() == std::endian::little)
+                std::reverse(value.begin(), value.end());
+
+            return { std::to_string(hex::extract(fieldPattern->getBitOffset() + (fieldPattern->getBitSize() - 1), fieldPattern->getBitOffset(), value)), false };
+        } else if (dynamic_cast<PatternDataUnsigned*>(pattern) != nullptr) {
+            u128 value = 0;
+            std::memcpy(&value, data, std::min(size, sizeof(value)));
+            value = hex::changeEndianess(value, size, endian);
+
+            return { hex::format("{}", value), false };
+        } else if (dynamic_cast<PatternDataSigned*>(pattern) != nullptr) {
+            u128 value = 0;
+            std::memcpy(&value, data, std::min(size, sizeof(value)));
+            value = hex::changeEndianess(value, size, endian);
+
+            // Move the sign bit to the top and back again to extend it
+            const auto shift = size < sizeof(value) ? (sizeof(value) - size) * 8 : 0;
+            return { hex::format("{}", s128(value << shift) >> shift), false };
+        } else if (dynamic_cast<PatternDataFloat*>(pattern) != nullptr) {
+            double value;
+            if (size == 4) {
+                u32 bits = 0;
+                std::memcpy(&bits, data, 4);
+                bits = hex::changeEndianess(bits, 4, endian);
+
+                float floatValue;
+                std::memcpy(&floatValue, &bits, 4);
+                value = floatValue;
+            } else if (size == 8) {
+                u64 bits = 0;
+                std::memcpy(&bits, data, 8);
+                bits = hex::changeEndianess(bits, 8, endian);
+
+                std::memcpy(&value, &bits, 8);
+            } else
+                return { "", true };
+
+            // JSON has no way of representing these as numbers
+            if (std::isnan(value))
+                return { "nan", true };
+            else if (std::isinf(value))
+                return { value < 0 ? "-inf" : "inf", true };
+            else if (size == 4)
+                return { hex::format("{}", float(value)), false };
+            else
+                return { hex::format("{}", value), false };
+        } else if (dynamic_cast<PatternDataBoolean*>(pattern) != nullptr) {
+            return { data[0] != 0x00 ? "true" : "false", false };
+        } else if (dynamic_cast<PatternDataCharacter*>(pattern) != nullptr) {
+            return { toUTF8(std::string(1, char(data[0]))), true };
+        } else if (dynamic_cast<PatternDataCharacter16*>(pattern) != nullptr) {
+            char16_t character;
+            std::memcpy(&character, data, 2);
+
+            return { toUTF8(std::u16string(1, hex::changeEndianess(character, endian))), true };
+        } else if (dynamic_cast<PatternDataString*>(pattern) != nullptr) {
+            auto string = reinterpret_cast<const char*>(data);
+
+            return { toUTF8(std::string(string, strnlen(string, size))), true };
+        } else if (dynamic_cast<PatternDataString16*>(pattern) != nullptr) {
+            std::u16string string(size / 2, 0x00);
+            std::memcpy(string.data(), data, string.size() * 2);
+
+            for (auto &c : string)
+                c = hex::changeEndianess(c, endian);
+            string.resize(std::distance(string.begin(), std::find(string.begin(), string.end(), 0x00)));
+
+            return { toUTF8(string), true };
+        } else if (auto enumPattern = dynamic_cast<PatternDataEnum*>(pattern); enumPattern != nullptr) {
+            u64 value = 0;
+            std::memcpy(&value, data, std::min(size, sizeof(value)));
+            value = hex::changeEndianess(value, size, endian);
+
+            for (auto &[entryValueLiteral, entryName] : enumPattern->getEnumValues()) {
+                bool matches = std::visit(overloaded {
+                    [&](auto &&entryValue) { return value == entryValue; },
+                    [](const std::string&) { return false; },
+                    [](PatternData*) { return false; }
+                }, entryValueLiteral);
+
+                if (matches)
+                    return { entryName, true };
+            }
+
+            return { std::to_string(value), false };
+        } else if (dynamic_cast<PatternDataPointer*>(pattern) != nullptr) {
+            u64 value = 0;
+            std::memcpy(&value, data, std::min(size, sizeof(value)));
+            value = hex::changeEndianess(value, size, endian);
+
+            return { hex::format("0x{:X}", value), true };
+        } else {
+            return { "", true };
+        }
+    }
+
+    void PatternExporter::writeValue(PatternData *pattern, u64 offset) {
+        if (auto fieldPattern = dynamic_cast<PatternDataBitfieldField*>(pattern); fieldPattern != nullptr) {
+            auto parent = fieldPattern->getParent();
+            this->writeValue(this->formatValue(pattern, this->readData(parent->getOffset(), parent->getSize())));
+        } else if (pattern->getSize() > WindowSize) {
+            // Only strings get this big, every other value is a few bytes at most
+            this->writeLargeString(pattern, offset);
+        } else {
+            this->writeValue(this->formatValue(pattern, this->readData(offset, pattern->getSize())));
+        }
+    }
+
+    void PatternExporter::writeValue(const Value &value) {
+        if (this->m_format == Format::CSV)
+            this->write(escapeCSV(value.text));
+        else
+            this->write(value.quoted ? "\"" + escapeJSON(value.text) + "\"" : value.text);
+    }
+
+    /* Strings that don't fit into the window are converted and written a window at a time. 8 bit ones need to be looked at */
+    /* twice, first to find out where they end and whether they're valid UTF-8                                              */
+    void PatternExporter::writeLargeString(PatternData *pattern, u64 offset) {
+        const auto escape = [this](const std::string &string) {
+            if (this->m_format == Format::CSV) {
+                std::string result;
+                for (char c : string) {
+                    if (c == '"')
+                        result += '"';
+                    result += c;
+                }
+
+                return result;
+            } else {
+                return escapeJSON(string);
+            }
+        };
+
+        const auto size = pattern->getSize();
+        const auto endian = pattern->getEndian();
+
+        this->write("\"");
+
+        if (dynamic_cast<PatternDataString16*>(pattern) != nullptr) {
+            // Surrogate pairs split between two windows are kept together
+            std::u16string pending;
+            for (u64 chunkOffset = 0; chunkOffset + 1 < size && !this->hasFailed(); chunkOffset += WindowSize) {
+                const auto chunkSize = std::min<u64>(size - chunkOffset, WindowSize) / 2 * 2;
+                const auto data = this->readData(offset + chunkOffset, chunkSize);
+
+                std::u16string string = pending;
+                string.resize(pending.size() + chunkSize / 2);
+                std::memcpy(string.data() + pending.size(), data, chunkSize);
+                pending.clear();
+
+                for (auto &c : string)
+                    c = hex::changeEndianess(c, endian);
+
+                auto end = std::find(string.begin(), string.end(), 0x00);
+                const bool terminated = end != string.end();
+                string.erase(end, string.end());
+
+                if (!terminated && !string.empty() && string.back() >= 0xD800 && string.back() <= 0xDBFF) {
+                    pending = string.back();
+                    string.pop_back();
+                }
+
+                this->write(escape(toUTF8(string)));
+
+                if (terminated)
+                    break;
+            }
+
+            this->write(escape(toUTF8(pending)));
+        } else {
+            u64 length = size;
+            UTF8Validator validator;
+            for (u64 chunkOffset = 0; chunkOffset < size && !this->hasFailed(); chunkOffset += WindowSize) {
+                const auto chunkSize = std::min<u64>(size - chunkOffset, WindowSize);
+                const auto data = this->readData(offset + chunkOffset, chunkSize);
+
+                auto end = static_cast<const u8*>(std::memchr(data, 0x00, chunkSize));
+                validator.feed(data, end != nullptr ? end - data : chunkSize);
+
+                if (end != nullptr) {
+                    length = chunkOffset + (end - data);
+                    break;
+                }
+            }
+
+            const bool validUTF8 = validator.isValid();
+            for (u64 chunkOffset = 0; chunkOffset < length && !this->hasFailed(); chunkOffset += WindowSize) {
+                const auto chunkSize = std::min<u64>(length - chunkOffset, WindowSize);
+                const auto data = reinterpret_cast<const char*>(this->readData(offset + chunkOffset, chunkSize));
+
+                std::string string(data, chunkSize);
+                this->write(escape(validUTF8 ? string : latin1ToUTF8(string)));
+            }
+        }
+
+        this->write("\"");
+    }
+
+
+    /* Never asked for more than WindowSize bytes at once, bigger values get read in pieces */
+    const u8* PatternExporter::readData(u64 offset, size_t size) {
+        if (!this->m_windowValid || offset < this->m_windowAddress || offset + size > this->m_windowAddress + this->m_window.size()) {
+            this->m_window.assign(WindowSize, 0x00);
+            this->m_windowAddress = offset;
+            this->m_windowValid = true;
+
+            // Whatever lies outside of the data stays zeroed
+            const u64 dataStart = this->m_dataStart;
+            const u64 dataEnd = dataStart + this->m_provider->getActualSize();
+            const u64 readStart = std::max<u64>(offset, dataStart);
+            const u64 readEnd = std::min<u64>(offset + this->m_window.size(), dataEnd);
+
+            if (readStart < readEnd)
+                this->m_provider->readUnpaged(readStart - dataStart, this->m_window.data() + (readStart - offset), readEnd - readStart);
+        }
+
+        return this->m_window.data() + (offset - this->m_windowAddress);
+    }
+
+    void PatternExporter::writeData(u64 offset, size_t size) {
+        while (size > 0 && !this->hasFailed()) {
+            const auto chunkSize = std::min(size, WindowSize);
+
+            this->m_outputBuffer.append(reinterpret_cast<const char*>(this->readData(offset, chunkSize)), chunkSize);
+            if (this->m_outputBuffer.size() >= FlushSize)
+                this->flush();
+
+            offset += chunkSize;
+            size -= chunkSize;
+        }
+    }
+
+    void PatternExporter::write(const std::string &string) {
+        if (this->hasFailed())
+            return;
+
+        this->m_outputBuffer += string;
+
+        if (this->m_outputBuffer.size() >= FlushSize)
+            this->flush();
+    }
+
+    void PatternExporter::flush() {
+        if (!this->hasFailed() && !this->m_file->write(this->m_outputBuffer))
+            this->m_writeFailed = true;
+
+        this->m_outputBuffer.clear();
+    }
+
+    bool PatternExporter::hasFailed() const {
+        return this->m_writeFailed || (this->m_cancelled != nullptr && *this->m_cancelled);
+    }
+
+}
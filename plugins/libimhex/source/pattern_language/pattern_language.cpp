@@ -4,6 +4,7 @@
 #include <hex/providers/provider.hpp>
 #include <hex/helpers/logger.hpp>
 
+#include <hex/pattern_language/arena.hpp>
 #include <hex/pattern_language/preprocessor.hpp>
 #include <hex/pattern_language/lexer.hpp>
 #include <hex/pattern_language/parser.hpp>
@@ -23,6 +24,9 @@ namespace hex::pl {
         this->m_validator = new Validator();
         this->m_evaluator = new Evaluator();
 
+        this->m_astArena = new Arena();
+        this->m_patternArena = new Arena();
+
         this->m_preprocessor->addPragmaHandler("endian", [this](std::string value) {
             if (value == "big") {
                 this->m_defaultEndian = std::endian::big;
@@ -57,10 +61,39 @@ namespace hex::pl {
             return true;
         });
 
-        this->m_preprocessor->addPragmaHandler("base_address", [](std::string value) {
-            auto baseAddress = strtoull(value.c_str(), nullptr, 0);
+        this->m_preprocessor->addPragmaHandler("time_limit", [this](std::string value) {
+            auto limit = strtol(value.c_str(), nullptr, 0);
+
+            if (limit < 0)
+                return false;
+
+            this->m_timeLimit = limit;
+            return true;
+        });
+
+        this->m_preprocessor->addPragmaHandler("pattern_limit", [this](std::string value) {
+            auto limit = strtoll(value.c_str(), nullptr, 0);
+
+            if (limit < 0)
+                return false;
+
+            this->m_patternLimit = limit;
+            return true;
+        });
+
+        this->m_preprocessor->addPragmaHandler("memory_limit", [this](std::string value) {
+            auto limit = strtoll(value.c_str(), nullptr, 0);
+
+            if (limit < 0)
+                return false;
+
+            this->m_memoryLimit = limit;
+            return true;
+        });
+
+        this->m_preprocessor->addPragmaHandler("base_address", [this](std::string value) {
+            this->m_baseAddress = strtoull(value.c_str(), nullptr, 0);
 
-            ImHexApi::Provider::get()->setBaseAddress(baseAddress);
             return true;
         });
 
@@ -72,29 +105,79 @@ namespace hex::pl {
         delete this->m_lexer;
         delete this->m_parser;
         delete this->m_validator;
+        delete this->m_evaluator;
+
+        for (auto &node : this->m_currAST)
+            delete node;
+
+        for (auto &[evaluationId, ast] : this->m_cachedASTs) {
+            for (auto &node : ast)
+                delete node;
+        }
+
+        // Patterns that are still in use keep their memory alive until they get deleted
+        delete this->m_astArena;
+        delete this->m_patternArena;
     }
 
 
     std::optional<std::vector<PatternData*>> PatternLanguage::executeString(prv::Provider *provider, const std::string &string) {
+        // Lazy array entries get decoded through the evaluator and the AST, neither can change while that happens
+        const auto &decodingContext = this->m_evaluator->getDecodingContext();
+        std::scoped_lock decodingLock(decodingContext->mutex);
+
+        this->m_evaluator->resetAbort();
         this->m_currError.reset();
         this->m_evaluator->getConsole().clear();
+        this->m_provider = provider;
         this->m_evaluator->setProvider(provider);
+        this->m_baseAddress.reset();
+        this->m_defaultEndian = std::endian::native;
         this->m_evalDepth = 32;
-        this->m_arrayLimit = 0x1000;
-
-        for (auto &node : this->m_currAST)
-            delete node;
+        this->m_arrayLimit = 0x10'0000;
+        this->m_timeLimit = 0;
+        this->m_patternLimit = 0;
+        this->m_memoryLimit = 0;
+
+        // Patterns the evaluator reuses from earlier runs may still refer to the AST they were created from
+        if (!this->m_currAST.empty())
+            this->m_cachedASTs[this->m_evaluator->getEvaluationId()] = std::move(this->m_currAST);
         this->m_currAST.clear();
 
+        std::erase_if(this->m_cachedASTs, [&](auto &entry) {
+            auto &[evaluationId, ast] = entry;
+            if (this->m_evaluator->isEvaluationCached(evaluationId))
+                return false;
+
+            decodingContext->decodableEvaluations.erase(evaluationId);
+            for (auto &node : ast)
+                delete node;
+
+            return true;
+        });
+        this->m_astArena->reset();
+
         auto preprocessedCode = this->m_preprocessor->preprocess(string);
         if (!preprocessedCode.has_value()) {
             this->m_currError = this->m_preprocessor->getError();
             return { };
         }
 
+        // The pragma's base address is where the current page of the data starts, just like the provider's own one
+        if (provider != nullptr) {
+            if (this->m_baseAddress.has_value())
+                this->m_evaluator->setDataBaseAddress(*this->m_baseAddress + prv::Provider::PageSize * provider->getCurrentPage());
+            else
+                this->m_evaluator->setDataBaseAddress(provider->getBaseAddress());
+        }
+
         this->m_evaluator->setDefaultEndian(this->m_defaultEndian);
         this->m_evaluator->setEvaluationDepth(this->m_evalDepth);
         this->m_evaluator->setArrayLimit(this->m_arrayLimit);
+        this->m_evaluator->setTimeLimit(this->m_timeLimit);
+        this->m_evaluator->setPatternLimit(this->m_patternLimit);
+        this->m_evaluator->setMemoryLimit(this->m_memoryLimit);
+        this->m_evaluator->setPatternArena(this->m_patternArena);
 
         auto tokens = this->m_lexer->lex(preprocessedCode.value());
         if (!tokens.has_value()) {
@@ -102,15 +185,26 @@ namespace hex::pl {
             return { };
         }
 
-        auto ast = this->m_parser->parse(tokens.value());
+        auto ast = [&] {
+            Arena::Scope scope(*this->m_astArena);
+            return this->m_parser->parse(tokens.value());
+        }();
+
         if (!ast.has_value()) {
             this->m_currError = this->m_parser->getError();
             return { };
         }
 
         this->m_currAST = ast.value();
+        this->m_validator->analyzeLayouts(ast.value());
+        this->m_evaluator->setPlacementHashes(this->m_parser->getPlacementHashes());
+
+        this->m_patternArena->reset();
+        auto patterns = [&] {
+            Arena::Scope scope(*this->m_patternArena);
+            return this->m_evaluator->evaluate(ast.value());
+        }();
 
-        auto patterns = this->m_evaluator->evaluate(ast.value());
         if (!patterns.has_value()) {
             this->m_currError = this->m_evaluator->getConsole().getLastHardError();
             return { };
@@ -126,6 +220,14 @@ namespace hex::pl {
     }
 
 
+    void PatternLanguage::abort() {
+        this->m_evaluator->abort();
+    }
+
+    float PatternLanguage::getProgress() const {
+        return this->m_evaluator->getProgress();
+    }
+
     const std::vector<std::pair<LogConsole::Level, std::string>>& PatternLanguage::getConsoleLog() {
         return this->m_evaluator->getConsole().getLog();
     }
@@ -134,4 +236,8 @@ namespace hex::pl {
         return this->m_currError;
     }
 
+    const std::optional<u64>& PatternLanguage::getBaseAddress() const {
+        return this->m_baseAddress;
+    }
+
 }
\ No newline at end of file
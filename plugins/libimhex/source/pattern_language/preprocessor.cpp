@@ -19,6 +19,7 @@ namespace hex::pl {
         if (initialRun) {
             this->m_defines.clear();
             this->m_pragmas.clear();
+            this->m_includedFiles.clear();
         }
 
         std::string output;
@@ -68,16 +69,7 @@ namespace hex::pl {
                         if (!file.isValid())
                             throwPreprocessorError(hex::format("{0}: No such file or directory", includeFile.c_str()), lineNumber);
 
-                        auto preprocessedInclude = this->preprocess(file.readString(), false);
-                        if (!preprocessedInclude.has_value())
-                            throw this->m_error;
-
-                        auto content = preprocessedInclude.value();
-
-                        std::replace(content.begin(), content.end(), '\n', ' ');
-                        std::replace(content.begin(), content.end(), '\r', ' ');
-
-                        output += content;
+                        output += this->preprocessInclude(includeFile, file.readString());
                     } else if (code.substr(offset, 6) == "define") {
                         offset += 6;
 
@@ -208,6 +200,55 @@ namespace hex::pl {
         return output;
     }
 
+    std::string Preprocessor::preprocessInclude(const std::string &path, const std::string &code) {
+        const auto contentHash = std::hash<std::string>{}(code);
+
+        auto isUpToDate = [](const CachedInclude &cachedInclude) {
+            return std::all_of(cachedInclude.includes.begin(), cachedInclude.includes.end(), [](const auto &include) {
+                const auto &[includePath, includeHash] = include;
+
+                File file(includePath, File::Mode::Read);
+                return file.isValid() && std::hash<std::string>{}(file.readString()) == includeHash;
+            });
+        };
+
+        auto cachedInclude = this->m_includeCache.find(path);
+        if (cachedInclude == this->m_includeCache.end() || cachedInclude->second.contentHash != contentHash || !isUpToDate(cachedInclude->second)) {
+            // Preprocess the include on its own to find out which defines, pragmas and includes it brings in
+            auto defines = std::move(this->m_defines);
+            auto pragmas = std::move(this->m_pragmas);
+            auto includedFiles = std::move(this->m_includedFiles);
+            this->m_defines.clear();
+            this->m_pragmas.clear();
+            this->m_includedFiles.clear();
+
+            auto preprocessedInclude = this->preprocess(code, false);
+            if (!preprocessedInclude.has_value())
+                throw this->m_error;
+
+            auto content = preprocessedInclude.value();
+
+            std::replace(content.begin(), content.end(), '\n', ' ');
+            std::replace(content.begin(), content.end(), '\r', ' ');
+
+            CachedInclude newCachedInclude = { contentHash, std::move(content), std::move(this->m_defines), std::move(this->m_pragmas), std::move(this->m_includedFiles) };
+            cachedInclude = this->m_includeCache.insert_or_assign(path, std::move(newCachedInclude)).first;
+
+            this->m_defines = std::move(defines);
+            this->m_pragmas = std::move(pragmas);
+            this->m_includedFiles = std::move(includedFiles);
+        }
+
+        const auto &[hash, output, defines, pragmas, includes] = cachedInclude->second;
+
+        this->m_defines.insert(defines.begin(), defines.end());
+        this->m_pragmas.insert(pragmas.begin(), pragmas.end());
+        this->m_includedFiles.emplace_back(path, contentHash);
+        this->m_includedFiles.insert(this->m_includedFiles.end(), includes.begin(), includes.end());
+
+        return output;
+    }
+
     void Preprocessor::addPragmaHandler(const std::string &pragmaType, const std::function<bool(const std::string&)> &function) {
         if (!this->m_pragmaHandlers.contains(pragmaType))
             this->m_pragmaHandlers.emplace(pragmaType, function);
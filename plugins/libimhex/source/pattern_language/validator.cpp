@@ -4,11 +4,51 @@
 
 #include <hex/helpers/fmt.hpp>
 
+#include <algorithm>
 #include <unordered_set>
+#include <utility>
 #include <string>
 
 namespace hex::pl {
 
+    /* Value of an expression that consists of nothing but literals */
+    std::optional<Token::Literal> evaluateConstant(const ASTNode *node) {
+        try {
+            if (auto literalNode = dynamic_cast<const ASTNodeLiteral*>(node); literalNode != nullptr) {
+                return literalNode->getValue();
+            } else if (auto expressionNode = dynamic_cast<const ASTNodeMathematicalExpression*>(node); expressionNode != nullptr) {
+                auto left = evaluateConstant(expressionNode->getLeftOperand());
+                auto right = evaluateConstant(expressionNode->getRightOperand());
+
+                if (left.has_value() && right.has_value())
+                    return expressionNode->apply(*left, *right);
+            } else if (auto ternaryNode = dynamic_cast<const ASTNodeTernaryExpression*>(node); ternaryNode != nullptr) {
+                auto first = evaluateConstant(ternaryNode->getFirstOperand());
+                auto second = evaluateConstant(ternaryNode->getSecondOperand());
+                auto third = evaluateConstant(ternaryNode->getThirdOperand());
+
+                if (first.has_value() && second.has_value() && third.has_value())
+                    return ternaryNode->apply(*first, *second, *third);
+            }
+        } catch (const LogConsole::EvaluateError&) {
+            // Expressions that would fail to evaluate are left for the evaluator to report
+        } catch (const std::string&) { }
+
+        return std::nullopt;
+    }
+
+    std::optional<u128> evaluateConstantInteger(const ASTNode *node) {
+        auto value = evaluateConstant(node);
+        if (!value.has_value())
+            return std::nullopt;
+
+        return std::visit(overloaded {
+            [](const std::string&) -> std::optional<u128> { return std::nullopt; },
+            [](PatternData * const &) -> std::optional<u128> { return std::nullopt; },
+            [](auto &&value) -> std::optional<u128> { return u128(value); }
+        }, std::as_const(value.value()));
+    }
+
     Validator::Validator() {
 
     }
@@ -52,4 +92,150 @@ namespace hex::pl {
 
         return true;
     }
+
+    void Validator::analyzeLayouts(const std::vector<ASTNode*> &ast) {
+        // The nodes are gone after this run, their addresses might be used for entirely different ones next time
+        this->m_layouts.clear();
+        ON_SCOPE_EXIT { this->m_layouts.clear(); };
+
+        for (const auto &node : ast) {
+            if (dynamic_cast<ASTNodeTypeDecl*>(node) != nullptr)
+                (void)this->analyzeType(node);
+            else
+                (void)this->analyzeMember(node);
+        }
+    }
+
+    std::optional<Validator::StaticLayout> Validator::analyzeType(ASTNode *type) {
+        if (auto cachedLayout = this->m_layouts.find(type); cachedLayout != this->m_layouts.end())
+            return cachedLayout->second;
+
+        std::optional<StaticLayout> layout;
+
+        if (auto typeDeclNode = dynamic_cast<ASTNodeTypeDecl*>(type); typeDeclNode != nullptr) {
+            if (typeDeclNode->getType() != nullptr)
+                layout = this->analyzeType(typeDeclNode->getType());
+
+            typeDeclNode->setStaticLayout(layout);
+        } else if (auto builtinTypeNode = dynamic_cast<ASTNodeBuiltinType*>(type); builtinTypeNode != nullptr) {
+            if (builtinTypeNode->getType() != Token::ValueType::String)
+                layout = StaticLayout { Token::getTypeSize(builtinTypeNode->getType()), { } };
+        } else if (auto structNode = dynamic_cast<ASTNodeStruct*>(type); structNode != nullptr) {
+            StaticLayout structLayout = { 0, { } };
+            bool isStatic = true;
+
+            // Members are still looked at once the struct turned out to not be static, they might contain static types themselves
+            for (const auto &member : structNode->getMembers()) {
+                auto memberSizes = this->analyzeMember(member);
+                if (!memberSizes.has_value()) {
+                    isStatic = false;
+                    continue;
+                }
+
+                for (auto memberSize : *memberSizes) {
+                    structLayout.memberOffsets.push_back(structLayout.size);
+                    structLayout.size += memberSize;
+                }
+            }
+
+            if (isStatic)
+                layout = std::move(structLayout);
+        } else if (auto unionNode = dynamic_cast<ASTNodeUnion*>(type); unionNode != nullptr) {
+            StaticLayout unionLayout = { 0, { } };
+            bool isStatic = true;
+
+            for (const auto &member : unionNode->getMembers()) {
+                auto memberSizes = this->analyzeMember(member);
+                if (!memberSizes.has_value()) {
+                    isStatic = false;
+                    continue;
+                }
+
+                for (auto memberSize : *memberSizes) {
+                    unionLayout.memberOffsets.push_back(0);
+                    unionLayout.size = std::max(unionLayout.size, memberSize);
+                }
+            }
+
+            if (isStatic)
+                layout = std::move(unionLayout);
+        } else if (auto enumNode = dynamic_cast<ASTNodeEnum*>(type); enumNode != nullptr) {
+            auto underlyingLayout = this->analyzeType(enumNode->getUnderlyingType());
+
+            bool constantEntries = std::all_of(enumNode->getEntries().begin(), enumNode->getEntries().end(), [](const auto &entry) {
+                return evaluateConstant(entry.second).has_value();
+            });
+
+            if (underlyingLayout.has_value() && constantEntries)
+                layout = StaticLayout { underlyingLayout->size, { } };
+        } else if (auto bitfieldNode = dynamic_cast<ASTNodeBitfield*>(type); bitfieldNode != nullptr) {
+            StaticLayout bitfieldLayout = { 0, { } };
+            u64 bitSize = 0;
+            bool isStatic = true;
+
+            for (const auto &[name, fieldSize] : bitfieldNode->getEntries()) {
+                auto fieldBitSize = evaluateConstantInteger(fieldSize);
+                if (!fieldBitSize.has_value()) {
+                    isStatic = false;
+                    break;
+                }
+
+                bitfieldLayout.memberOffsets.push_back(0);
+                bitSize += static_cast<u8>(*fieldBitSize);
+            }
+
+            bitfieldLayout.size = (bitSize + 7) / 8;
+
+            if (isStatic)
+                layout = std::move(bitfieldLayout);
+        }
+
+        this->m_layouts.emplace(type, layout);
+
+        return layout;
+    }
+
+    /* Sizes of the patterns a member creates or nothing if they depend on the data */
+    std::optional<std::vector<u64>> Validator::analyzeMember(ASTNode *member) {
+        if (auto variableDeclNode = dynamic_cast<ASTNodeVariableDecl*>(member); variableDeclNode != nullptr) {
+            auto layout = this->analyzeType(variableDeclNode->getType());
+
+            if (layout.has_value() && variableDeclNode->getPlacementOffset() == nullptr)
+                return std::vector<u64> { layout->size };
+        } else if (auto arrayVariableDeclNode = dynamic_cast<ASTNodeArrayVariableDecl*>(member); arrayVariableDeclNode != nullptr) {
+            auto layout = this->analyzeType(arrayVariableDeclNode->getType());
+
+            std::optional<u128> entryCount;
+            if (arrayVariableDeclNode->getSize() != nullptr)
+                entryCount = evaluateConstantInteger(arrayVariableDeclNode->getSize());
+
+            if (layout.has_value() && entryCount.has_value() && arrayVariableDeclNode->getPlacementOffset() == nullptr)
+                return std::vector<u64> { static_cast<u64>(layout->size * *entryCount) };
+        } else if (auto pointerVariableDeclNode = dynamic_cast<ASTNodePointerVariableDecl*>(member); pointerVariableDeclNode != nullptr) {
+            // Where a pointer points to always depends on the data
+            (void)this->analyzeType(pointerVariableDeclNode->getType());
+        } else if (auto multiVariableDeclNode = dynamic_cast<ASTNodeMultiVariableDecl*>(member); multiVariableDeclNode != nullptr) {
+            std::vector<u64> sizes;
+            bool isStatic = true;
+
+            for (const auto &variable : multiVariableDeclNode->getVariables()) {
+                auto variableSizes = this->analyzeMember(variable);
+                if (variableSizes.has_value())
+                    sizes.insert(sizes.end(), variableSizes->begin(), variableSizes->end());
+                else
+                    isStatic = false;
+            }
+
+            if (isStatic)
+                return sizes;
+        } else if (auto conditionalNode = dynamic_cast<ASTNodeConditionalStatement*>(member); conditionalNode != nullptr) {
+            for (const auto &statement : conditionalNode->getTrueBody())
+                (void)this->analyzeMember(statement);
+            for (const auto &statement : conditionalNode->getFalseBody())
+                (void)this->analyzeMember(statement);
+        }
+
+        return std::nullopt;
+    }
+
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <hex.hpp>
 
+#include <atomic>
 #include <cmath>
 #include <cstring>
 #include <map>
@@ -10,7 +11,9 @@
 
 namespace hex::prv {
 
-    Provider::Provider() {
+    static std::atomic<u64> nextProviderID = 0;
+
+    Provider::Provider() : m_id(nextProviderID++) {
         this->m_patches.emplace_back();
     }
 
@@ -19,6 +22,10 @@ namespace hex::prv {
             this->deleteOverlay(overlay);
     }
 
+    u64 Provider::getID() const {
+        return this->m_id;
+    }
+
     void Provider::read(u64 offset, void *buffer, size_t size, bool overlays) {
         this->readRaw(offset, buffer, size);
     }
@@ -27,8 +34,88 @@ namespace hex::prv {
         this->read(offset + this->getBaseAddress(), buffer, size);
     }
 
+    void Provider::readCached(u64 offset, void *buffer, size_t size) {
+        std::shared_lock dataLock(this->m_dataMutex);
+        std::unique_lock lock(this->m_cacheMutex);
+
+        if (this->m_cacheVersion != this->m_dataVersion) {
+            for (auto &block : this->m_cachedBlocks)
+                block.data.clear();
+
+            this->m_cacheVersion = this->m_dataVersion;
+            this->m_cacheBaseAddress = this->getBaseAddress();
+            this->m_cacheDataSize = this->getSize();
+        }
+
+        const auto baseAddress = this->m_cacheBaseAddress;
+        const auto dataSize = this->m_cacheDataSize;
+
+        // Bigger reads and ones that don't lie within the data entirely don't gain anything from being cached
+        if (size > CacheBlockSize || offset < baseAddress || offset - baseAddress > dataSize || size > dataSize - (offset - baseAddress)) {
+            lock.unlock();
+            this->read(offset, buffer, size);
+            return;
+        }
+
+        auto output = static_cast<u8*>(buffer);
+        while (size > 0) {
+            const auto blockAddress = baseAddress + (offset - baseAddress) / CacheBlockSize * CacheBlockSize;
+            const auto &block = this->getCachedBlock(blockAddress);
+
+            const auto blockOffset = offset - blockAddress;
+            const auto copySize = std::min<u64>(size, block.data.size() - blockOffset);
+            std::memcpy(output, block.data.data() + blockOffset, copySize);
+
+            output += copySize;
+            offset += copySize;
+            size   -= copySize;
+        }
+    }
+
+    void Provider::readUnpaged(u64 offset, void *buffer, size_t size, bool withPatches) {
+        std::shared_lock lock(this->m_dataMutex);
+
+        // Only the current page can be reached through read(), anything outside of it reads as zeros
+        std::memset(buffer, 0x00, size);
+
+        const u64 pageStart = PageSize * this->m_currPage, pageEnd = pageStart + this->getSize();
+        const u64 start = std::max(offset, pageStart), end = std::min(offset + size, pageEnd);
+        if (start < end) {
+            if (withPatches)
+                this->read(this->m_baseAddress + start, static_cast<u8*>(buffer) + (start - offset), end - start, false);
+            else
+                this->readRaw(this->m_baseAddress + start, static_cast<u8*>(buffer) + (start - offset), end - start);
+        }
+    }
+
+    const Provider::CachedBlock& Provider::getCachedBlock(u64 address) {
+        this->m_cacheUseCount++;
+
+        CachedBlock *leastRecentlyUsed = &this->m_cachedBlocks.front();
+        for (auto &block : this->m_cachedBlocks) {
+            if (!block.data.empty() && block.address == address) {
+                block.lastUse = this->m_cacheUseCount;
+                return block;
+            }
+
+            if (block.lastUse < leastRecentlyUsed->lastUse)
+                leastRecentlyUsed = &block;
+        }
+
+        auto &block = *leastRecentlyUsed;
+        block.address = address;
+        block.lastUse = this->m_cacheUseCount;
+        block.data.resize(std::min<u64>(CacheBlockSize, this->m_cacheDataSize - (address - this->m_cacheBaseAddress)));
+        this->read(address, block.data.data(), block.data.size());
+
+        return block;
+    }
+
     void Provider::write(u64 offset, const void *buffer, size_t size) {
+        std::unique_lock lock(this->m_dataMutex);
+
         this->writeRaw(offset, buffer, size);
+        this->markDataChanged(offset, size);
     }
 
     void Provider::writeRelative(u64 offset, const void *buffer, size_t size) {
@@ -62,18 +149,26 @@ namespace hex::prv {
     }
 
     void Provider::applyPatches() {
+        std::unique_lock lock(this->m_dataMutex);
+
         for (auto &[patchAddress, patch] : getPatches())
             this->writeRaw(patchAddress, &patch, 1);
+
+        this->markDataChanged();
     }
 
 
     Overlay* Provider::newOverlay() {
+        this->markDataChanged();
+
         return this->m_overlays.emplace_back(new Overlay());
     }
 
     void Provider::deleteOverlay(Overlay *overlay) {
         this->m_overlays.erase(std::find(this->m_overlays.begin(), this->m_overlays.end(), overlay));
         delete overlay;
+
+        this->markDataChanged();
     }
 
     const std::list<Overlay*>& Provider::getOverlays() {
@@ -90,13 +185,23 @@ namespace hex::prv {
     }
 
     void Provider::setCurrentPage(u32 page) {
-        if (page < getPageCount())
+        if (page < getPageCount() && page != this->m_currPage) {
+            std::unique_lock lock(this->m_dataMutex);
+
             this->m_currPage = page;
+            this->markDataChanged();
+        }
     }
 
 
     void Provider::setBaseAddress(u64 address) {
+        if (address == this->m_baseAddress)
+            return;
+
+        std::unique_lock lock(this->m_dataMutex);
+
         this->m_baseAddress = address;
+        this->markDataChanged();
     }
 
     u64 Provider::getBaseAddress() const {
@@ -117,6 +222,8 @@ namespace hex::prv {
     }
 
     void Provider::addPatch(u64 offset, const void *buffer, size_t size) {
+        std::unique_lock lock(this->m_dataMutex);
+
         if (this->m_patchTreeOffset > 0) {
             this->m_patches.erase(this->m_patches.end() - this->m_patchTreeOffset, this->m_patches.end());
             this->m_patchTreeOffset = 0;
@@ -126,16 +233,26 @@ namespace hex::prv {
 
         for (u64 i = 0; i < size; i++)
             getPatches()[offset + i] = reinterpret_cast<const u8*>(buffer)[i];
+
+        this->markDataChanged(offset, size);
     }
 
     void Provider::undo() {
-        if (canUndo())
+        if (canUndo()) {
+            std::unique_lock lock(this->m_dataMutex);
+
             this->m_patchTreeOffset++;
+            this->markDataChanged();
+        }
     }
 
     void Provider::redo() {
-        if (canRedo())
+        if (canRedo()) {
+            std::unique_lock lock(this->m_dataMutex);
+
             this->m_patchTreeOffset--;
+            this->markDataChanged();
+        }
     }
 
     bool Provider::canUndo() const {
@@ -146,4 +263,46 @@ namespace hex::prv {
         return this->m_patchTreeOffset > 0;
     }
 
+    u64 Provider::getDataVersion() const {
+        return this->m_dataVersion;
+    }
+
+    void Provider::markDataChanged() {
+        std::scoped_lock lock(this->m_cacheMutex);
+
+        const auto version = ++this->m_dataVersion;
+
+        // Anything could have changed so older versions can't be compared against anymore
+        this->m_dataChanges.clear();
+        this->m_trackedSinceVersion = version;
+    }
+
+    void Provider::markDataChanged(u64 offset, size_t size) {
+        std::scoped_lock lock(this->m_cacheMutex);
+
+        const auto version = ++this->m_dataVersion;
+
+        this->m_dataChanges.push_back({ version, offset, size });
+        if (this->m_dataChanges.size() > MaxTrackedDataChanges) {
+            this->m_trackedSinceVersion = this->m_dataChanges.front().version;
+            this->m_dataChanges.pop_front();
+        }
+    }
+
+    bool Provider::hasDataChanged(u64 offset, size_t size, u64 sinceVersion) const {
+        std::scoped_lock lock(this->m_cacheMutex);
+
+        if (sinceVersion == this->m_dataVersion)
+            return false;
+        if (sinceVersion < this->m_trackedSinceVersion)
+            return true;
+
+        for (auto change = this->m_dataChanges.rbegin(); change != this->m_dataChanges.rend() && change->version > sinceVersion; change++) {
+            if (change->offset < offset + size && offset < change->offset + change->size)
+                return true;
+        }
+
+        return false;
+    }
+
 }
\ No newline at end of file
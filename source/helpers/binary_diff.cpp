@@ -0,0 +1,553 @@
+#include "helpers/binary_diff.hpp"
+
+#include <hex/providers/provider.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <thread>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+namespace hex {
+
+    namespace {
+
+        /* Minimum number of equal bytes on the current diagonal needed to resynchronize after a change */
+        constexpr size_t DiagonalMatchSize  = 16;
+
+        /* Gaps between two anchors that are smaller than this get refined byte by byte */
+        constexpr size_t RefineWindowSize   = 1024;
+        constexpr size_t RefineMaxEditCount = 256;
+
+        constexpr size_t MinBlockSize       = 32;
+        constexpr size_t MaxIndexEntries    = 1 << 21;
+
+        /* Amount of data hashed or scanned by a single task */
+        constexpr u64 SegmentSize           = 0x40'0000;
+
+        constexpr u64 HashMultiplier        = 0x100000001B3ULL;
+
+        constexpr u32 EmptySlot             = 0xFFFF'FFFF;
+
+        struct Anchor {
+            u64 offsetA, offsetB, size;
+        };
+
+        void appendEdit(EditScript &script, DiffType type, u64 offsetA, u64 sizeA, u64 offsetB, u64 sizeB) {
+            if (sizeA == 0 && sizeB == 0)
+                return;
+
+            if (!script.empty()) {
+                auto &last = script.back();
+                bool lastIsMatch = last.type == DiffType::Match;
+                bool currIsMatch = type == DiffType::Match;
+
+                // Merge neighbouring matches and neighbouring differences into a single edit
+                if (lastIsMatch == currIsMatch) {
+                    last.sizeA += sizeA;
+                    last.sizeB += sizeB;
+
+                    if (!lastIsMatch) {
+                        if (last.sizeA == 0)
+                            last.type = DiffType::Insertion;
+                        else if (last.sizeB == 0)
+                            last.type = DiffType::Deletion;
+                        else
+                            last.type = DiffType::Change;
+                    }
+
+                    return;
+                }
+            }
+
+            if (type != DiffType::Match) {
+                if (sizeA == 0)
+                    type = DiffType::Insertion;
+                else if (sizeB == 0)
+                    type = DiffType::Deletion;
+                else
+                    type = DiffType::Change;
+            }
+
+            script.push_back({ type, offsetA, sizeA, offsetB, sizeB });
+        }
+
+        /* Myers' O(ND) algorithm, bailing out once more than maxEdits insertions and deletions would be required */
+        bool refineGap(EditScript &script, const u8 *dataA, u64 offsetA, size_t sizeA, const u8 *dataB, u64 offsetB, size_t sizeB, size_t maxEdits) {
+            const s64 vOffset = maxEdits + 1;
+            std::vector<s64> v(2 * maxEdits + 3, 0);
+            std::vector<std::vector<s64>> trace;
+
+            std::optional<size_t> editCount;
+            for (s64 d = 0; d <= s64(maxEdits) && !editCount.has_value(); d++) {
+                trace.push_back(v);
+
+                for (s64 k = -d; k <= d; k += 2) {
+                    s64 x;
+                    if (k == -d || (k != d && v[vOffset + k - 1] < v[vOffset + k + 1]))
+                        x = v[vOffset + k + 1];
+                    else
+                        x = v[vOffset + k - 1] + 1;
+
+                    s64 y = x - k;
+                    while (x < s64(sizeA) && y < s64(sizeB) && dataA[x] == dataB[y]) {
+                        x++;
+                        y++;
+                    }
+
+                    v[vOffset + k] = x;
+
+                    if (x >= s64(sizeA) && y >= s64(sizeB)) {
+                        editCount = d;
+                        break;
+                    }
+                }
+            }
+
+            if (!editCount.has_value())
+                return false;
+
+            // Walk the trace backwards to collect the operations, then replay them in order
+            std::vector<DiffType> operations;
+            s64 x = sizeA, y = sizeB;
+            for (s64 d = editCount.value(); d > 0; d--) {
+                const auto &previousV = trace[d];
+                s64 k = x - y;
+
+                s64 previousK;
+                if (k == -d || (k != d && previousV[vOffset + k - 1] < previousV[vOffset + k + 1]))
+                    previousK = k + 1;
+                else
+                    previousK = k - 1;
+
+                s64 previousX = previousV[vOffset + previousK];
+                s64 previousY = previousX - previousK;
+
+                while (x > previousX && y > previousY) {
+                    operations.push_back(DiffType::Match);
+                    x--;
+                    y--;
+                }
+
+                operations.push_back(previousK == k + 1 ? DiffType::Insertion : DiffType::Deletion);
+                x = previousX;
+                y = previousY;
+            }
+
+            for (; x > 0 && y > 0; x--, y--)
+                operations.push_back(DiffType::Match);
+
+            u64 currA = offsetA, currB = offsetB;
+            for (auto it = operations.rbegin(); it != operations.rend(); ++it) {
+                switch (*it) {
+                    case DiffType::Match:
+                        appendEdit(script, DiffType::Match, currA++, 1, currB++, 1);
+                        break;
+                    case DiffType::Insertion:
+                        appendEdit(script, DiffType::Insertion, currA, 0, currB++, 1);
+                        break;
+                    case DiffType::Deletion:
+                        appendEdit(script, DiffType::Deletion, currA++, 1, currB, 0);
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            return true;
+        }
+
+        void emitGap(EditScript &script, ProviderReader &readerA, ProviderReader &readerB, u64 startA, u64 endA, u64 startB, u64 endB) {
+            const u64 sizeA = endA - startA;
+            const u64 sizeB = endB - startB;
+
+            if (sizeA > 0 && sizeB > 0 && sizeA <= RefineWindowSize && sizeB <= RefineWindowSize) {
+                const u8 *dataA = readerA.read(startA, sizeA);
+                const u8 *dataB = readerB.read(startB, sizeB);
+
+                if (refineGap(script, dataA, startA, sizeA, dataB, startB, sizeB, RefineMaxEditCount))
+                    return;
+            }
+
+            appendEdit(script, DiffType::Change, startA, sizeA, startB, sizeB);
+        }
+
+
+        template<typename T>
+        void runParallel(size_t taskCount, T &&task) {
+            std::atomic<size_t> nextTask = 0;
+            auto worker = [&] {
+                for (size_t i = nextTask++; i < taskCount; i = nextTask++)
+                    task(i);
+            };
+
+            const size_t threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, std::max<size_t>(taskCount, 1));
+
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < threadCount; i++)
+                threads.emplace_back(worker);
+
+            worker();
+
+            for (auto &thread : threads)
+                thread.join();
+        }
+
+        struct ScanContext {
+            prv::Provider *providerA, *providerB;
+            u64 sizeA, sizeB;
+
+            const BlockIndex &index;
+
+            const std::atomic<bool> &cancelled;
+            std::atomic<float> &progress;
+            std::atomic<u64> scannedBytes;
+        };
+
+        /* Scans [startB, endB) of B with a rolling hash and anchors every match that keeps both sides in order. */
+        /* The last anchor may extend past the end of the segment                                                */
+        std::vector<Anchor> scanSegment(ScanContext &context, u64 startA, u64 startB, u64 endB) {
+            ProviderReader readerA(context.providerA), readerB(context.providerB);
+            const u64 sizeA = context.sizeA, sizeB = context.sizeB;
+            const size_t blockSize = context.index.getBlockSize();
+
+            std::vector<Anchor> anchors;
+            u64 lastEndA = 0, lastEndB = startB;
+            u64 diagonalStartA = startA, diagonalStartB = startB;
+            u64 rollingHash = 0;
+            bool hashValid = false;
+
+            u64 reportedOffset = startB;
+            auto reportProgress = [&](u64 offset) {
+                if (offset - reportedOffset < 0x10000)
+                    return true;
+
+                context.scannedBytes += std::min(offset, endB) - std::min(reportedOffset, endB);
+                context.progress = float(context.scannedBytes) / sizeB;
+                reportedOffset = offset;
+
+                return !context.cancelled;
+            };
+
+            for (u64 offsetB = startB; offsetB < endB && offsetB + std::min<u64>(DiagonalMatchSize, blockSize) <= sizeB; ) {
+                if (!reportProgress(offsetB))
+                    return { };
+
+                std::optional<u64> matchA;
+
+                // Check the current diagonal first, that's where data realigns after an in-place change
+                const u64 diagonalA = diagonalStartA + (offsetB - diagonalStartB);
+                if (diagonalA + DiagonalMatchSize <= sizeA && offsetB + DiagonalMatchSize <= sizeB && readerA.at(diagonalA) == readerB.at(offsetB)) {
+                    if (findMismatch(readerA.read(diagonalA, DiagonalMatchSize), readerB.read(offsetB, DiagonalMatchSize), DiagonalMatchSize) == DiagonalMatchSize)
+                        matchA = diagonalA;
+                }
+
+                if (offsetB + blockSize <= sizeB) {
+                    if (!hashValid) {
+                        rollingHash = context.index.hash(readerB.read(offsetB, blockSize));
+                        hashValid = true;
+                    }
+
+                    if (!matchA.has_value()) {
+                        if (auto candidateA = context.index.find(rollingHash); candidateA.has_value()) {
+                            if (*candidateA >= lastEndA && findMismatch(readerA.read(*candidateA, blockSize), readerB.read(offsetB, blockSize), blockSize) == blockSize)
+                                matchA = candidateA;
+                        }
+                    }
+                }
+
+                if (!matchA.has_value()) {
+                    if (hashValid && offsetB + blockSize < sizeB)
+                        rollingHash = context.index.roll(rollingHash, readerB.at(offsetB), readerB.at(offsetB + blockSize));
+                    else
+                        hashValid = false;
+
+                    offsetB++;
+                    continue;
+                }
+
+                // Grow the match in both directions as far as the data stays equal
+                u64 matchStartA = *matchA, matchStartB = offsetB;
+                while (matchStartA > lastEndA && matchStartB > lastEndB && readerA.at(matchStartA - 1) == readerB.at(matchStartB - 1)) {
+                    matchStartA--;
+                    matchStartB--;
+                }
+
+                u64 matchEndA = *matchA, matchEndB = offsetB;
+                while (matchEndA < sizeA && matchEndB < sizeB) {
+                    const size_t chunkSize = std::min<u64>({ 0x10000, sizeA - matchEndA, sizeB - matchEndB });
+                    const size_t equalSize = findMismatch(readerA.read(matchEndA, chunkSize), readerB.read(matchEndB, chunkSize), chunkSize);
+
+                    matchEndA += equalSize;
+                    matchEndB += equalSize;
+
+                    if (equalSize < chunkSize)
+                        break;
+
+                    if (!reportProgress(matchEndB))
+                        return { };
+                }
+
+                anchors.push_back({ matchStartA, matchStartB, matchEndA - matchStartA });
+
+                lastEndA = diagonalStartA = matchEndA;
+                lastEndB = diagonalStartB = matchEndB;
+                offsetB = matchEndB;
+                hashValid = false;
+            }
+
+            reportProgress(endB + 0x10000);
+
+            return anchors;
+        }
+
+    }
+
+    ProviderReader::ProviderReader(prv::Provider *provider) : m_provider(provider), m_size(provider->getActualSize()) { }
+
+    void ProviderReader::fill(u64 offset) {
+        this->m_bufferStart = offset;
+        this->m_buffer.resize(std::min<u64>(BufferSize, this->m_size - offset));
+        this->m_provider->readUnpaged(offset, this->m_buffer.data(), this->m_buffer.size());
+    }
+
+
+    BlockIndex::BlockIndex(prv::Provider *provider, const std::atomic<bool> &cancelled) {
+        const u64 size = provider->getActualSize();
+
+        this->m_blockSize = MinBlockSize;
+        while (size / this->m_blockSize > MaxIndexEntries)
+            this->m_blockSize *= 2;
+
+        for (size_t i = 0; i < this->m_blockSize - 1; i++)
+            this->m_multiplierPower *= HashMultiplier;
+
+        // Hashing happens in parallel, insertion in order so the first occurrence of repeated data is the one that gets remembered
+        const u64 blockCount = size / this->m_blockSize;
+        const u64 blocksPerTask = std::max<u64>(1, SegmentSize / this->m_blockSize);
+
+        std::vector<u64> blockHashes(blockCount);
+        runParallel((blockCount + blocksPerTask - 1) / blocksPerTask, [&](size_t task) {
+            ProviderReader reader(provider);
+
+            const u64 endBlock = std::min(blockCount, (task + 1) * blocksPerTask);
+            for (u64 block = task * blocksPerTask; block < endBlock && !cancelled; block++)
+                blockHashes[block] = this->hash(reader.read(block * this->m_blockSize, this->m_blockSize));
+        });
+
+        this->m_slots.resize(std::bit_ceil(std::max<u64>(blockCount * 2, 16)), { 0, EmptySlot });
+        this->m_mask = this->m_slots.size() - 1;
+
+        if (cancelled)
+            return;
+
+        for (u64 block = 0; block < blockCount; block++)
+            this->insert(blockHashes[block], block);
+    }
+
+    void BlockIndex::insert(u64 hash, u32 blockIndex) {
+        for (u64 slot = hash & this->m_mask; ; slot = (slot + 1) & this->m_mask) {
+            auto &entry = this->m_slots[slot];
+            if (entry.blockIndex == EmptySlot) {
+                entry = { u32(hash >> 32), blockIndex };
+                return;
+            } else if (entry.tag == u32(hash >> 32)) {
+                return;
+            }
+        }
+    }
+
+    std::optional<u64> BlockIndex::find(u64 hash) const {
+        for (u64 slot = hash & this->m_mask; ; slot = (slot + 1) & this->m_mask) {
+            const auto &entry = this->m_slots[slot];
+            if (entry.blockIndex == EmptySlot)
+                return { };
+            else if (entry.tag == u32(hash >> 32))
+                return u64(entry.blockIndex) * this->m_blockSize;
+        }
+    }
+
+    u64 BlockIndex::hash(const u8 *data) const {
+        u64 hash = 0;
+        for (size_t i = 0; i < this->m_blockSize; i++)
+            hash = hash * HashMultiplier + data[i];
+
+        return hash;
+    }
+
+    u64 BlockIndex::roll(u64 hash, u8 removedByte, u8 addedByte) const {
+        return (hash - removedByte * this->m_multiplierPower) * HashMultiplier + addedByte;
+    }
+
+
+    size_t findMismatch(const u8 *dataA, const u8 *dataB, size_t size) {
+        size_t i = 0;
+
+        #if defined(__AVX2__)
+            for (; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+                auto equal = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(dataA + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dataB + i)));
+                u32 mask = _mm256_movemask_epi8(equal);
+                if (mask != 0xFFFF'FFFF)
+                    return i + std::countr_one(mask);
+            }
+        #elif defined(__SSE2__)
+            for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+                auto equal = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(dataA + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(dataB + i)));
+                u32 mask = _mm_movemask_epi8(equal);
+                if (mask != 0xFFFF)
+                    return i + std::countr_one(mask);
+            }
+        #endif
+
+        for (; i + sizeof(u64) <= size; i += sizeof(u64)) {
+            u64 wordA, wordB;
+            std::memcpy(&wordA, dataA + i, sizeof(u64));
+            std::memcpy(&wordB, dataB + i, sizeof(u64));
+
+            if (wordA != wordB) {
+                if constexpr (std::endian::native == std::endian::little)
+                    return i + std::countr_zero(wordA ^ wordB) / 8;
+                else
+                    return i + std::countl_zero(wordA ^ wordB) / 8;
+            }
+        }
+
+        for (; i < size; i++) {
+            if (dataA[i] != dataB[i])
+                return i;
+        }
+
+        return size;
+    }
+
+    std::optional<EditScript> generateEditScript(prv::Provider *providerA, prv::Provider *providerB, const std::atomic<bool> &cancelled, std::atomic<float> &progress) {
+        const u64 sizeA = providerA->getActualSize(), sizeB = providerB->getActualSize();
+
+        progress = 0.0F;
+
+        // Index every block of A so moved or shifted data in B can be found again
+        BlockIndex index(providerA, cancelled);
+        if (cancelled)
+            return { };
+
+        // Scan segments of B in parallel. Each segment starts out on the diagonal its position in B suggests,
+        // the hash index takes over if the data got shifted around before it
+        ScanContext context = { providerA, providerB, sizeA, sizeB, index, cancelled, progress, 0 };
+
+        const u64 segmentCount = std::max<u64>(1, (sizeB + SegmentSize - 1) / SegmentSize);
+        std::vector<std::vector<Anchor>> segmentAnchors(segmentCount);
+        runParallel(segmentCount, [&](size_t segment) {
+            const u64 startB = segment * SegmentSize;
+            const u64 endB = std::min(sizeB, startB + SegmentSize);
+            const u64 startA = std::min<u64>(sizeA, u128(startB) * sizeA / std::max<u64>(sizeB, 1));
+
+            segmentAnchors[segment] = scanSegment(context, startA, startB, endB);
+        });
+
+        if (cancelled)
+            return { };
+
+        // Stitch the segments together. Anchors that overlap the ones of a previous segment get trimmed,
+        // any part of a match is still a valid match
+        std::vector<Anchor> anchors;
+        u64 lastEndA = 0, lastEndB = 0;
+        for (const auto &segment : segmentAnchors) {
+            for (auto anchor : segment) {
+                const u64 overlap = std::max(lastEndA > anchor.offsetA ? lastEndA - anchor.offsetA : 0, lastEndB > anchor.offsetB ? lastEndB - anchor.offsetB : 0);
+                if (overlap >= anchor.size)
+                    continue;
+
+                anchor.offsetA += overlap;
+                anchor.offsetB += overlap;
+                anchor.size    -= overlap;
+
+                anchors.push_back(anchor);
+
+                lastEndA = anchor.offsetA + anchor.size;
+                lastEndB = anchor.offsetB + anchor.size;
+            }
+        }
+
+        // Build the edit script from the anchors, refining the gaps between them
+        ProviderReader readerA(providerA), readerB(providerB);
+
+        EditScript script;
+        u64 currA = 0, currB = 0;
+        for (const auto &anchor : anchors) {
+            emitGap(script, readerA, readerB, currA, anchor.offsetA, currB, anchor.offsetB);
+            appendEdit(script, DiffType::Match, anchor.offsetA, anchor.size, anchor.offsetB, anchor.size);
+
+            currA = anchor.offsetA + anchor.size;
+            currB = anchor.offsetB + anchor.size;
+
+            if (cancelled)
+                return { };
+        }
+        emitGap(script, readerA, readerB, currA, sizeA, currB, sizeB);
+
+        progress = 1.0F;
+
+        return script;
+    }
+
+    DifferenceMap generateDifferenceMap(const EditScript &script, size_t blockCount) {
+        DifferenceMap map;
+
+        u64 alignedSize = 0;
+        for (size_t i = 0; i < script.size(); i++) {
+            const auto &edit = script[i];
+
+            switch (edit.type) {
+                case DiffType::Match:
+                    break;
+                case DiffType::Change:
+                    map.changedBytes  += std::min(edit.sizeA, edit.sizeB);
+                    map.insertedBytes += edit.sizeB - std::min(edit.sizeA, edit.sizeB);
+                    map.deletedBytes  += edit.sizeA - std::min(edit.sizeA, edit.sizeB);
+                    break;
+                case DiffType::Insertion:
+                    map.insertedBytes += edit.sizeB;
+                    break;
+                case DiffType::Deletion:
+                    map.deletedBytes  += edit.sizeA;
+                    break;
+            }
+
+            if (edit.type != DiffType::Match)
+                map.differences.push_back(i);
+
+            alignedSize += std::max(edit.sizeA, edit.sizeB);
+        }
+
+        if (alignedSize == 0 || blockCount == 0)
+            return map;
+
+        // Distribute the differing positions of every edit over the blocks it overlaps
+        map.density.resize(blockCount, 0.0F);
+        const double blockSize = double(alignedSize) / blockCount;
+
+        u64 position = 0;
+        for (const auto &edit : script) {
+            const u64 size = std::max(edit.sizeA, edit.sizeB);
+
+            if (edit.type != DiffType::Match) {
+                const double start = position, end = position + size;
+                for (auto block = size_t(start / blockSize); block < blockCount && block * blockSize < end; block++) {
+                    const double overlap = std::min(end, (block + 1) * blockSize) - std::max(start, block * blockSize);
+                    map.density[block] += float(overlap / blockSize);
+                }
+            }
+
+            position += size;
+        }
+
+        for (auto &density : map.density)
+            density = std::min(density, 1.0F);
+
+        return map;
+    }
+
+}
@@ -1,7 +1,11 @@
 #include "helpers/patches.hpp"
+#include "helpers/binary_diff.hpp"
 
 #include <hex/helpers/utils.hpp>
+#include <hex/providers/provider.hpp>
 
+#include <array>
+#include <atomic>
 #include <cstring>
 #include <string_view>
 #include <type_traits>
@@ -212,4 +216,401 @@ namespace hex {
             return { };
     }
 
-}
\ No newline at end of file
+    namespace {
+
+        /* Copies of fewer bytes than this from anywhere but the current source position aren't worth the lookup */
+        constexpr size_t MinCopySize        = 16;
+
+        /* Target data covered by a single VCDIFF window */
+        constexpr u64 VCDIFFWindowSize      = 0x80'0000;
+
+        constexpr auto Crc32Table = [] {
+            std::array<u32, 256> table = { 0 };
+
+            for (u32 i = 0; i < 256; i++) {
+                u32 c = i;
+                for (size_t j = 0; j < 8; j++)
+                    c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+
+                table[i] = c;
+            }
+
+            return table;
+        }();
+
+        u32 updateCrc32(u32 crc, const u8 *data, size_t size) {
+            crc = ~crc;
+            for (size_t i = 0; i < size; i++)
+                crc = Crc32Table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+
+            return ~crc;
+        }
+
+        u32 calculateCrc32(ProviderReader &reader) {
+            u32 crc = 0;
+            for (u64 offset = 0; offset < reader.getSize(); offset += ProviderReader::BufferSize) {
+                const size_t size = std::min<u64>(ProviderReader::BufferSize, reader.getSize() - offset);
+                crc = updateCrc32(crc, reader.read(offset, size), size);
+            }
+
+            return crc;
+        }
+
+        /* BPS patches consist of actions that either copy source data or append literal data to the target */
+        class BPSEncoder {
+        public:
+            BPSEncoder(u64 sourceSize, u64 targetSize) {
+                pushBytesBack(this->m_patch, std::string("BPS1"));
+                this->writeNumber(sourceSize);
+                this->writeNumber(targetSize);
+                this->writeNumber(0);   // No metadata
+            }
+
+            void copy(u64 sourceOffset, u64 size) {
+                if (sourceOffset == this->m_targetOffset) {
+                    this->writeAction(Action::SourceRead, size);
+                } else {
+                    this->writeAction(Action::SourceCopy, size);
+
+                    // Source copies are relative to the end of the previous one
+                    const bool negative = sourceOffset < this->m_sourceOffset;
+                    const u64 distance = negative ? this->m_sourceOffset - sourceOffset : sourceOffset - this->m_sourceOffset;
+                    this->writeNumber((distance << 1) | (negative ? 1 : 0));
+
+                    this->m_sourceOffset = sourceOffset + size;
+                }
+
+                this->m_targetOffset += size;
+            }
+
+            void add(const u8 *data, size_t size) {
+                this->writeAction(Action::TargetRead, size);
+                std::copy(data, data + size, std::back_inserter(this->m_patch));
+
+                this->m_targetOffset += size;
+            }
+
+            std::vector<u8> finish(u32 sourceChecksum, u32 targetChecksum) {
+                pushBytesBack<u32>(this->m_patch, changeEndianess(sourceChecksum, std::endian::little));
+                pushBytesBack<u32>(this->m_patch, changeEndianess(targetChecksum, std::endian::little));
+                pushBytesBack<u32>(this->m_patch, changeEndianess(updateCrc32(0, this->m_patch.data(), this->m_patch.size()), std::endian::little));
+
+                return std::move(this->m_patch);
+            }
+
+        private:
+            enum class Action : u8 {
+                SourceRead = 0,
+                TargetRead = 1,
+                SourceCopy = 2,
+                TargetCopy = 3
+            };
+
+            void writeNumber(u64 value) {
+                while (true) {
+                    u8 byte = value & 0x7F;
+                    value >>= 7;
+
+                    if (value == 0) {
+                        this->m_patch.push_back(0x80 | byte);
+                        break;
+                    }
+
+                    this->m_patch.push_back(byte);
+                    value--;
+                }
+            }
+
+            void writeAction(Action action, u64 size) {
+                this->writeNumber(((size - 1) << 2) | static_cast<u8>(action));
+            }
+
+            std::vector<u8> m_patch;
+            u64 m_targetOffset = 0, m_sourceOffset = 0;
+        };
+
+        /* VCDIFF (RFC 3284) patches split the target into windows that may each copy from the whole source. */
+        /* Instructions use the default code table and absolute addresses                                     */
+        class VCDIFFEncoder {
+        public:
+            explicit VCDIFFEncoder(u64 sourceSize) : m_sourceSize(sourceSize) {
+                this->m_patch = { 0xD6, 0xC3, 0xC4, 0x00, 0x00 };
+            }
+
+            void copy(u64 sourceOffset, u64 size) {
+                while (size > 0) {
+                    const u64 copySize = std::min(size, VCDIFFWindowSize - this->m_windowSize);
+
+                    if (copySize >= 4 && copySize <= 18) {
+                        this->m_instructions.push_back(CopyInstruction + copySize - 3);
+                    } else {
+                        this->m_instructions.push_back(CopyInstruction);
+                        writeInteger(this->m_instructions, copySize);
+                    }
+                    writeInteger(this->m_addresses, sourceOffset);
+
+                    sourceOffset += copySize;
+                    size -= copySize;
+                    this->advanceWindow(copySize);
+                }
+            }
+
+            void add(const u8 *data, size_t size) {
+                while (size > 0) {
+                    const u64 addSize = std::min<u64>(size, VCDIFFWindowSize - this->m_windowSize);
+
+                    if (addSize <= 17) {
+                        this->m_instructions.push_back(AddInstruction + addSize);
+                    } else {
+                        this->m_instructions.push_back(AddInstruction);
+                        writeInteger(this->m_instructions, addSize);
+                    }
+                    std::copy(data, data + addSize, std::back_inserter(this->m_data));
+
+                    data += addSize;
+                    size -= addSize;
+                    this->advanceWindow(addSize);
+                }
+            }
+
+            std::vector<u8> finish() {
+                this->flushWindow();
+
+                return std::move(this->m_patch);
+            }
+
+        private:
+            constexpr static u8 SourceWindow    = 0x01;
+            constexpr static u8 AddInstruction  = 1;
+            constexpr static u8 CopyInstruction = 19;
+
+            static void writeInteger(std::vector<u8> &buffer, u64 value) {
+                std::array<u8, 10> bytes = { 0 };
+                size_t count = 0;
+
+                do {
+                    bytes[count++] = value & 0x7F;
+                    value >>= 7;
+                } while (value != 0);
+
+                // Most significant group first, all but the last byte have their continuation bit set
+                while (count > 1)
+                    buffer.push_back(0x80 | bytes[--count]);
+                buffer.push_back(bytes[0]);
+            }
+
+            void advanceWindow(u64 size) {
+                this->m_windowSize += size;
+
+                if (this->m_windowSize == VCDIFFWindowSize)
+                    this->flushWindow();
+            }
+
+            void flushWindow() {
+                if (this->m_windowSize == 0)
+                    return;
+
+                std::vector<u8> delta;
+                writeInteger(delta, this->m_windowSize);
+                delta.push_back(0x00);  // No secondary compression
+                writeInteger(delta, this->m_data.size());
+                writeInteger(delta, this->m_instructions.size());
+                writeInteger(delta, this->m_addresses.size());
+
+                if (this->m_sourceSize > 0) {
+                    this->m_patch.push_back(SourceWindow);
+                    writeInteger(this->m_patch, this->m_sourceSize);
+                    writeInteger(this->m_patch, 0);
+                } else {
+                    this->m_patch.push_back(0x00);
+                }
+
+                writeInteger(this->m_patch, delta.size() + this->m_data.size() + this->m_instructions.size() + this->m_addresses.size());
+                for (const auto &section : { &delta, &this->m_data, &this->m_instructions, &this->m_addresses })
+                    std::copy(section->begin(), section->end(), std::back_inserter(this->m_patch));
+
+                this->m_data.clear();
+                this->m_instructions.clear();
+                this->m_addresses.clear();
+                this->m_windowSize = 0;
+            }
+
+            u64 m_sourceSize;
+
+            std::vector<u8> m_patch;
+            std::vector<u8> m_data, m_instructions, m_addresses;
+            u64 m_windowSize = 0;
+        };
+
+        /* Describes the patches as source reads of the unpatched data and literal patched bytes */
+        template<typename T>
+        void encodePatches(u64 size, const Patches &patches, T &encoder) {
+            std::vector<u8> bytes;
+            u64 offset = 0;
+            for (auto it = patches.begin(); it != patches.end() && it->first < size; ) {
+                const u64 runStart = it->first;
+
+                bytes.clear();
+                for (u64 address = runStart; it != patches.end() && it->first == address && address < size; it++, address++)
+                    bytes.push_back(it->second);
+
+                if (runStart > offset)
+                    encoder.copy(offset, runStart - offset);
+                encoder.add(bytes.data(), bytes.size());
+
+                offset = runStart + bytes.size();
+            }
+
+            if (offset < size)
+                encoder.copy(offset, size - offset);
+        }
+
+        /* Walks the target once with a rolling hash and looks up every position in a block index of the source. */
+        /* Everything that can't be found gets added literally                                                     */
+        template<typename T>
+        void encodeDelta(prv::Provider *source, prv::Provider *target, T &encoder, const std::atomic<bool> &cancelled) {
+            BlockIndex index(source, cancelled);
+
+            ProviderReader sourceReader(source), targetReader(target);
+            const u64 sourceSize = sourceReader.getSize(), targetSize = targetReader.getSize();
+            const size_t blockSize = index.getBlockSize();
+
+            u64 literalStart = 0;
+            auto flushLiteral = [&](u64 end) {
+                while (literalStart < end) {
+                    const size_t size = std::min<u64>(ProviderReader::BufferSize, end - literalStart);
+                    encoder.add(targetReader.read(literalStart, size), size);
+                    literalStart += size;
+                }
+            };
+
+            u64 lastSourceEnd = 0, lastTargetEnd = 0;
+            u64 rollingHash = 0;
+            bool hashValid = false;
+
+            for (u64 offset = 0; offset + MinCopySize <= targetSize; ) {
+                if (cancelled)
+                    return;
+
+                std::optional<u64> match;
+
+                // Most data continues right where the previous copy ended, try that before asking the index
+                const u64 expectedSource = lastSourceEnd + (offset - lastTargetEnd);
+                if (expectedSource + MinCopySize <= sourceSize && findMismatch(sourceReader.read(expectedSource, MinCopySize), targetReader.read(offset, MinCopySize), MinCopySize) == MinCopySize)
+                    match = expectedSource;
+
+                if (offset + blockSize <= targetSize) {
+                    if (!hashValid) {
+                        rollingHash = index.hash(targetReader.read(offset, blockSize));
+                        hashValid = true;
+                    }
+
+                    if (!match.has_value()) {
+                        if (auto candidate = index.find(rollingHash); candidate.has_value()) {
+                            if (findMismatch(sourceReader.read(*candidate, blockSize), targetReader.read(offset, blockSize), blockSize) == blockSize)
+                                match = candidate;
+                        }
+                    }
+                }
+
+                if (!match.has_value()) {
+                    if (hashValid && offset + blockSize < targetSize)
+                        rollingHash = index.roll(rollingHash, targetReader.at(offset), targetReader.at(offset + blockSize));
+                    else
+                        hashValid = false;
+
+                    offset++;
+                    continue;
+                }
+
+                // Take back as many of the pending literal bytes as possible and extend the copy forward
+                u64 copySource = *match, copyTarget = offset;
+                while (copySource > 0 && copyTarget > literalStart && sourceReader.at(copySource - 1) == targetReader.at(copyTarget - 1)) {
+                    copySource--;
+                    copyTarget--;
+                }
+
+                u64 copyEnd = offset, sourceEnd = *match;
+                while (sourceEnd < sourceSize && copyEnd < targetSize) {
+                    const size_t chunkSize = std::min<u64>({ 0x10000, sourceSize - sourceEnd, targetSize - copyEnd });
+                    const size_t equalSize = findMismatch(sourceReader.read(sourceEnd, chunkSize), targetReader.read(copyEnd, chunkSize), chunkSize);
+
+                    sourceEnd += equalSize;
+                    copyEnd += equalSize;
+
+                    if (equalSize < chunkSize)
+                        break;
+                }
+
+                flushLiteral(copyTarget);
+                encoder.copy(copySource, copyEnd - copyTarget);
+
+                literalStart = lastTargetEnd = offset = copyEnd;
+                lastSourceEnd = sourceEnd;
+                hashValid = false;
+            }
+
+            flushLiteral(targetSize);
+        }
+
+    }
+
+    std::vector<u8> generateBPSPatch(prv::Provider *provider, const Patches &patches, const std::atomic<bool> &cancelled) {
+        const u64 size = provider->getActualSize();
+        BPSEncoder encoder(size, size);
+
+        encodePatches(size, patches, encoder);
+
+        // Both checksums come out of a single pass, the target one is calculated after patching the unpatched data
+        u32 sourceChecksum = 0, targetChecksum = 0;
+        std::vector<u8> buffer(ProviderReader::BufferSize);
+        auto patch = patches.begin();
+        for (u64 offset = 0; offset < size; offset += buffer.size()) {
+            if (cancelled)
+                return { };
+
+            const size_t readSize = std::min<u64>(buffer.size(), size - offset);
+            provider->readUnpaged(offset, buffer.data(), readSize, false);
+            sourceChecksum = updateCrc32(sourceChecksum, buffer.data(), readSize);
+
+            for (; patch != patches.end() && patch->first < offset + readSize; patch++)
+                buffer[patch->first - offset] = patch->second;
+            targetChecksum = updateCrc32(targetChecksum, buffer.data(), readSize);
+        }
+
+        return encoder.finish(sourceChecksum, targetChecksum);
+    }
+
+    std::vector<u8> generateBPSPatch(prv::Provider *source, prv::Provider *target, const std::atomic<bool> &cancelled) {
+        BPSEncoder encoder(source->getActualSize(), target->getActualSize());
+
+        encodeDelta(source, target, encoder, cancelled);
+        if (cancelled)
+            return { };
+
+        ProviderReader sourceReader(source), targetReader(target);
+        return encoder.finish(calculateCrc32(sourceReader), calculateCrc32(targetReader));
+    }
+
+    std::vector<u8> generateVCDIFFPatch(prv::Provider *provider, const Patches &patches, const std::atomic<bool> &cancelled) {
+        const u64 size = provider->getActualSize();
+        VCDIFFEncoder encoder(size);
+
+        encodePatches(size, patches, encoder);
+        if (cancelled)
+            return { };
+
+        return encoder.finish();
+    }
+
+    std::vector<u8> generateVCDIFFPatch(prv::Provider *source, prv::Provider *target, const std::atomic<bool> &cancelled) {
+        VCDIFFEncoder encoder(source->getActualSize());
+
+        encodeDelta(source, target, encoder, cancelled);
+        if (cancelled)
+            return { };
+
+        return encoder.finish();
+    }
+
+}
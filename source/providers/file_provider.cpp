@@ -50,9 +50,10 @@ namespace hex::prv {
 
         std::memcpy(buffer, reinterpret_cast<u8*>(this->m_mappedFile) + PageSize * this->m_currPage + offset - this->getBaseAddress(), size);
 
-        for (u64 i = 0; i < size; i++)
-            if (getPatches().contains(offset + i))
-                reinterpret_cast<u8*>(buffer)[i] = getPatches()[offset + PageSize * this->m_currPage + i];
+        // Only look at the patches that lie within the read region instead of looking up every single byte
+        auto &patches = getPatches();
+        for (auto patch = patches.lower_bound(offset); patch != patches.end() && patch->first < offset + size; patch++)
+            reinterpret_cast<u8*>(buffer)[patch->first - offset] = patch->second;
 
         if (overlays)
             this->applyOverlays(offset, buffer, size);
@@ -65,6 +66,24 @@ namespace hex::prv {
         addPatch(offset, buffer, size);
     }
 
+    void FileProvider::readUnpaged(u64 offset, void *buffer, size_t size, bool withPatches) {
+        std::shared_lock lock(this->m_dataMutex);
+
+        if (offset > this->m_fileSize || size > this->m_fileSize - offset || buffer == nullptr || size == 0)
+            return;
+
+        std::memcpy(buffer, reinterpret_cast<u8*>(this->m_mappedFile) + offset, size);
+
+        if (!withPatches)
+            return;
+
+        // Patches are keyed by their address, which counts from the base address independent of the page they're on
+        const u64 address = this->m_baseAddress + offset;
+        auto &patches = getPatches();
+        for (auto patch = patches.lower_bound(address); patch != patches.end() && patch->first < address + size; patch++)
+            reinterpret_cast<u8*>(buffer)[patch->first - address] = patch->second;
+    }
+
     void FileProvider::readRaw(u64 offset, void *buffer, size_t size) {
         offset -= this->getBaseAddress();
 
@@ -106,6 +125,8 @@ namespace hex::prv {
     }
 
     void FileProvider::resize(ssize_t newSize) {
+        std::unique_lock lock(this->m_dataMutex);
+
         this->close();
 
     #if defined(OS_WINDOWS)
@@ -162,6 +183,7 @@ namespace hex::prv {
 
     void FileProvider::open() {
         this->m_fileStatsValid = stat(this->m_path.data(), &this->m_fileStats) == 0;
+        this->markDataChanged();
 
         this->m_readable = true;
         this->m_writable = true;
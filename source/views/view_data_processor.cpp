@@ -124,6 +124,9 @@ namespace hex {
 
                 endNode->process();
             }
+
+            // The overlays the end nodes wrote to changed what the provider reads
+            ImHexApi::Provider::get()->markDataChanged();
         } catch (dp::Node::NodeError &e) {
             this->m_currNodeError = e;
 
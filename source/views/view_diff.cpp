@@ -1,15 +1,26 @@
 #include "views/view_diff.hpp"
 
+#include "helpers/patches.hpp"
+
 #include <hex/api/imhex_api.hpp>
 #include <hex/providers/provider.hpp>
 
+#include <hex/helpers/file.hpp>
 #include <hex/helpers/fmt.hpp>
+#include <hex/helpers/utils.hpp>
 
 #include <hex/api/content_registry.hpp>
 #include <nlohmann/json.hpp>
 
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+
 namespace hex {
 
+    constexpr static size_t MinimapBlockCount = 512;
+    constexpr static float MinimapWidth = 20.0F;
+
     ViewDiff::ViewDiff() : View("hex.view.diff.name") {
 
         EventManager::subscribe<EventSettingsChanged>(this, [this]{
@@ -31,11 +42,47 @@ namespace hex {
                 this->m_upperCaseHex = static_cast<int>(upperCaseHex);
             }
         });
-        
+
+        EventManager::subscribe<EventDataChanged>(this, [this]{
+            this->m_shouldRediff = true;
+        });
+
+        EventManager::subscribe<EventProviderDeleted>(this, [this](prv::Provider *provider) {
+            // Workers read from the providers directly, they have to be gone before any provider is
+            this->stopWorkers();
+
+            auto &providers = ImHexApi::Provider::getProviders();
+            const int index = std::find(providers.begin(), providers.end(), provider) - providers.begin();
+
+            // Keep the selection pointing at the same providers once the deleted one got removed from the list
+            for (auto selected : { &this->m_providerA, &this->m_providerB }) {
+                if (*selected == index)
+                    *selected = -1;
+                else if (*selected > index)
+                    (*selected)--;
+            }
+
+            this->m_shouldRediff = true;
+        });
+
     }
 
     ViewDiff::~ViewDiff() {
         EventManager::unsubscribe<EventSettingsChanged>(this);
+        EventManager::unsubscribe<EventDataChanged>(this);
+        EventManager::unsubscribe<EventProviderDeleted>(this);
+
+        this->stopWorkers();
+    }
+
+    void ViewDiff::stopWorkers() {
+        this->m_diffCancelled = true;
+        if (this->m_diffThread.joinable())
+            this->m_diffThread.join();
+
+        this->m_exportCancelled = true;
+        if (this->m_exportThread.joinable())
+            this->m_exportThread.join();
     }
 
     static void drawProviderSelector(int &provider) {
@@ -65,40 +112,88 @@ namespace hex {
     enum class DiffResult { Same, Changed, Added, Removed };
     struct LineInfo {
         std::vector<u8> bytes;
-        s64 validBytes = 0;
+        std::vector<DiffResult> results;
+        std::vector<bool> present;
+        std::optional<u64> startOffset;
+        u64 endOffset = 0;
     };
 
-    static DiffResult diffBytes(u8 index, const LineInfo &a, const LineInfo &b) {
-        /* Very simple binary diff. Only detects additions and changes */
-        if (a.validBytes > index) {
-            if (b.validBytes <= index)
+    static DiffResult getDiffResult(const DiffEdit &edit, u8 side, u64 index) {
+        switch (edit.type) {
+            default:
+            case DiffType::Match:
+                return DiffResult::Same;
+            case DiffType::Change:
+                if (index < std::min(edit.sizeA, edit.sizeB))
+                    return DiffResult::Changed;
+                else
+                    return side == 0 ? DiffResult::Removed : DiffResult::Added;
+            case DiffType::Insertion:
                 return DiffResult::Added;
-            else if (a.bytes[index] != b.bytes[index])
-                return DiffResult::Changed;
+            case DiffType::Deletion:
+                return DiffResult::Removed;
         }
-
-        return DiffResult::Same;
     }
 
     void ViewDiff::drawDiffLine(const std::array<int, 2> &providerIds, u64 row) const {
+        auto &providers = ImHexApi::Provider::getProviders();
 
         std::array<LineInfo, 2> lineInfo;
+        for (auto &info : lineInfo) {
+            info.bytes.resize(this->m_columnCount);
+            info.results.resize(this->m_columnCount, DiffResult::Same);
+            info.present.resize(this->m_columnCount, false);
+        }
 
-        u8 addressDigitCount = 0;
-        for (u8 i = 0; i < 2; i++) {
-            int id = providerIds[i];
-            if (id < 0) continue;
+        const u64 rowStart = row * this->m_columnCount;
+        const u64 rowEnd = std::min<u64>(rowStart + this->m_columnCount, this->m_alignedSize);
+
+        // Map every aligned column of this row back to the bytes of both providers
+        size_t editIndex = std::upper_bound(this->m_alignedOffsets.begin(), this->m_alignedOffsets.end(), rowStart) - this->m_alignedOffsets.begin() - 1;
+        for (u64 position = rowStart; position < rowEnd; position++) {
+            while (editIndex + 1 < this->m_alignedOffsets.size() && this->m_alignedOffsets[editIndex + 1] <= position)
+                editIndex++;
 
-            auto &provider = ImHexApi::Provider::getProviders()[id];
+            const auto &edit = this->m_editScript[editIndex];
+            const u64 index = position - this->m_alignedOffsets[editIndex];
+            const u64 column = position - rowStart;
 
-            // Read one line of each provider
-            lineInfo[i].bytes.resize(this->m_columnCount);
-            provider->read(row * this->m_columnCount, lineInfo[i].bytes.data(), lineInfo[i].bytes.size());
-            lineInfo[i].validBytes = std::min<s64>(this->m_columnCount, provider->getSize() - row * this->m_columnCount);
+            const std::array<u64, 2> offsets = { edit.offsetA, edit.offsetB };
+            const std::array<u64, 2> sizes = { edit.sizeA, edit.sizeB };
+            for (u8 i = 0; i < 2; i++) {
+                if (index >= sizes[i])
+                    continue;
+
+                auto &info = lineInfo[i];
+                if (!info.startOffset.has_value())
+                    info.startOffset = offsets[i] + index;
+                info.endOffset = offsets[i] + index + 1;
+
+                info.present[column] = true;
+                info.results[column] = getDiffResult(edit, i, index);
+            }
+        }
+
+        u8 addressDigitCount = 0;
+        for (u8 i = 0; i < 2; i++) {
+            auto &provider = providers[providerIds[i]];
+            auto &info = lineInfo[i];
+
+            // Bytes of one provider are always contiguous within a row, gaps don't consume any addresses
+            if (info.startOffset.has_value()) {
+                std::vector<u8> bytes(info.endOffset - info.startOffset.value());
+                provider->readUnpaged(info.startOffset.value(), bytes.data(), bytes.size());
+
+                size_t byteIndex = 0;
+                for (size_t column = 0; column < info.present.size(); column++) {
+                    if (info.present[column])
+                        info.bytes[column] = bytes[byteIndex++];
+                }
+            }
 
             // Calculate address width
             u8 addressDigits = 0;
-            for (size_t n = provider->getSize() - 1; n > 0; n >>= 4)
+            for (size_t n = provider->getActualSize() - 1; n > 0; n >>= 4)
                 addressDigits++;
 
             addressDigitCount = std::max(addressDigits, addressDigitCount);
@@ -111,7 +206,15 @@ namespace hex {
 
         auto startY = ImGui::GetCursorPosY();
 
-        ImGui::TextUnformatted(hex::format(this->m_upperCaseHex ? "{:0{}X}:" : "{:0{}x}:", row * this->m_columnCount, addressDigitCount).c_str());
+        std::array<std::string, 2> addresses;
+        for (u8 i = 0; i < 2; i++) {
+            if (lineInfo[i].startOffset.has_value())
+                addresses[i] = hex::format(this->m_upperCaseHex ? "{:0{}X}" : "{:0{}x}", lineInfo[i].startOffset.value(), addressDigitCount);
+            else
+                addresses[i] = std::string(addressDigitCount, '-');
+        }
+
+        ImGui::TextUnformatted(hex::format("{} {}:", addresses[0], addresses[1]).c_str());
         ImGui::SetCursorPosY(startY);
         ImGui::TableNextColumn();
 
@@ -119,17 +222,25 @@ namespace hex {
         const ImColor colorDisabled = this->m_greyedOutZeros ? ImGui::GetColorU32(ImGuiCol_TextDisabled) : static_cast<u32>(colorText);
 
 
-        for (s8 curr = 0; curr < 2; curr++) {
-            auto other = !curr;
-
+        for (u8 curr = 0; curr < 2; curr++) {
             std::optional<ImVec2> lastHighlightEnd;
 
-            for (s64 col = 0; col < lineInfo[curr].validBytes; col++) {
+            for (u64 col = 0; col < rowEnd - rowStart; col++) {
                 auto pos = ImGui::GetCursorScreenPos();
 
+                if (!lineInfo[curr].present[col]) {
+                    // Byte only exists in the other provider, leave a gap to keep both sides aligned
+                    ImGui::TextUnformatted("  ");
+                    ImGui::SetCursorPosY(startY);
+                    lastHighlightEnd.reset();
+
+                    ImGui::SameLine(0.0F, col % 8 == 7 ? glyphWidth * 2.5F : glyphWidth * 0.25F);
+                    continue;
+                }
+
                 // Diff bytes
                 std::optional<u32> highlightColor;
-                switch (diffBytes(col, lineInfo[curr], lineInfo[other])) {
+                switch (lineInfo[curr].results[col]) {
                     default:
                     case DiffResult::Same:
                         /* No highlight */
@@ -165,6 +276,137 @@ namespace hex {
 
     }
 
+    void ViewDiff::startDiff() {
+        if (this->m_diffThread.joinable())
+            this->m_diffThread.join();
+
+        auto &providers = ImHexApi::Provider::getProviders();
+        auto providerA = providers[this->m_providerA];
+        auto providerB = providers[this->m_providerB];
+
+        this->m_shouldRediff = false;
+        this->m_diffCancelled = false;
+        this->m_diffRunning = true;
+
+        this->m_diffThread = std::thread([this, providerA, providerB, providerIds = this->m_diffedProviders] {
+            auto editScript = generateEditScript(providerA, providerB, this->m_diffCancelled, this->m_diffProgress);
+
+            if (editScript.has_value()) {
+                std::scoped_lock lock(this->m_diffResultMutex);
+
+                // Drop results of providers that got deselected in the meantime
+                if (providerIds == this->m_diffedProviders)
+                    this->m_diffResult = std::move(editScript.value());
+            }
+
+            this->m_diffRunning = false;
+        });
+    }
+
+    void ViewDiff::exportPatch(bool vcdiff) {
+        auto &providers = ImHexApi::Provider::getProviders();
+        auto source = providers[this->m_providerA];
+        auto target = providers[this->m_providerB];
+
+        hex::openFileBrowser("hex.view.hexeditor.menu.file.export.title"_lang, DialogMode::Save, { }, [this, source, target, vcdiff](auto path) {
+            if (this->m_exportThread.joinable())
+                this->m_exportThread.join();
+
+            this->m_exportRunning = true;
+            this->m_exportCancelled = false;
+            this->m_exportThread = std::thread([this, source, target, vcdiff, path] {
+                auto patch = vcdiff ? generateVCDIFFPatch(source, target, this->m_exportCancelled) : generateBPSPatch(source, target, this->m_exportCancelled);
+
+                if (!this->m_exportCancelled) {
+                    File file(path, File::Mode::Create);
+                    if (!file.isValid() || !file.write(patch) || !file.flush())
+                        this->m_exportFailed = true;
+                }
+
+                this->m_exportRunning = false;
+            });
+        });
+    }
+
+    void ViewDiff::setEditScript(EditScript &&editScript) {
+        this->m_editScript = std::move(editScript);
+
+        // Every edit takes up as many aligned positions as its longer side
+        this->m_alignedOffsets.clear();
+        this->m_alignedSize = 0;
+        for (const auto &edit : this->m_editScript) {
+            this->m_alignedOffsets.push_back(this->m_alignedSize);
+            this->m_alignedSize += std::max(edit.sizeA, edit.sizeB);
+        }
+
+        this->m_differenceMap = generateDifferenceMap(this->m_editScript, MinimapBlockCount);
+        this->m_currDifference.reset();
+    }
+
+    void ViewDiff::jumpToDifference(bool forward) {
+        const auto &differences = this->m_differenceMap.differences;
+        if (differences.empty())
+            return;
+
+        auto getRow = [this](size_t difference) {
+            return this->m_alignedOffsets[this->m_differenceMap.differences[difference]] / this->m_columnCount;
+        };
+
+        if (this->m_currDifference.has_value()) {
+            if (forward)
+                this->m_currDifference = (this->m_currDifference.value() + 1) % differences.size();
+            else
+                this->m_currDifference = (this->m_currDifference.value() + differences.size() - 1) % differences.size();
+        } else {
+            // Nothing selected yet, continue from the part of the diff that's currently visible
+            size_t next = 0;
+            while (next < differences.size() && getRow(next) < this->m_visibleRowStart)
+                next++;
+
+            if (forward)
+                this->m_currDifference = next % differences.size();
+            else
+                this->m_currDifference = (next + differences.size() - 1) % differences.size();
+        }
+
+        this->m_scrollToRow = getRow(this->m_currDifference.value());
+    }
+
+    void ViewDiff::drawMinimap(const ImVec2 &size) {
+        ImGui::InvisibleButton("##minimap", size);
+
+        const auto min = ImGui::GetItemRectMin();
+        const auto max = ImGui::GetItemRectMax();
+        const u64 rowCount = (this->m_alignedSize + this->m_columnCount - 1) / this->m_columnCount;
+
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        drawList->AddRectFilled(min, max, ImGui::GetColorU32(ImGuiCol_FrameBg));
+
+        // Color every block by how much of it differs so dense areas of changes stand out
+        const auto &density = this->m_differenceMap.density;
+        const float blockHeight = size.y / std::max<size_t>(density.size(), 1);
+        const u32 color = ImGui::GetCustomColorU32(ImGuiCustomCol_ToolbarRed) & 0x00FFFFFF;
+        for (size_t block = 0; block < density.size(); block++) {
+            if (density[block] <= 0.0F)
+                continue;
+
+            const u32 alpha = 0x40 + u32(density[block] * 0xBF);
+            const float blockStart = min.y + blockHeight * block;
+            drawList->AddRectFilled(ImVec2(min.x, blockStart), ImVec2(max.x, std::max(blockStart + blockHeight, blockStart + 1)), color | (alpha << 24));
+        }
+
+        if (rowCount == 0)
+            return;
+
+        // Outline the part that's currently visible in the table
+        drawList->AddRect(ImVec2(min.x, min.y + size.y * this->m_visibleRowStart / rowCount), ImVec2(max.x, min.y + size.y * this->m_visibleRowEnd / rowCount), ImGui::GetColorU32(ImGuiCol_Text));
+
+        if (ImGui::IsItemActive()) {
+            const float position = std::clamp((ImGui::GetMousePos().y - min.y) / size.y, 0.0F, 1.0F);
+            this->m_scrollToRow = std::min<u64>(position * rowCount, rowCount - 1);
+        }
+    }
+
     void ViewDiff::drawContent() {
         if (ImGui::Begin(View::toWindowName("hex.view.diff.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
 
@@ -182,10 +424,88 @@ namespace hex {
             ImGui::PushID(2);
             drawProviderSelector(this->m_providerB);
             ImGui::PopID();
+
+            if (std::array{ this->m_providerA, this->m_providerB } != this->m_diffedProviders) {
+                std::scoped_lock lock(this->m_diffResultMutex);
+
+                this->m_diffedProviders = { this->m_providerA, this->m_providerB };
+                this->m_diffResult.reset();
+                this->setEditScript({ });
+                this->m_shouldRediff = true;
+            }
+
+            if (this->m_shouldRediff) {
+                if (this->m_diffRunning)
+                    this->m_diffCancelled = true;
+                else if (this->m_providerA >= 0 && this->m_providerB >= 0)
+                    this->startDiff();
+            }
+
+            {
+                std::scoped_lock lock(this->m_diffResultMutex);
+                if (this->m_diffResult.has_value()) {
+                    this->setEditScript(std::move(this->m_diffResult.value()));
+                    this->m_diffResult.reset();
+                }
+            }
+
+            ImGui::SameLine();
+            ImGui::Disabled([this] {
+                if (ImGui::Button("hex.view.diff.export"_lang))
+                    ImGui::OpenPopup("##export");
+            }, this->m_providerA < 0 || this->m_providerB < 0 || this->m_exportRunning);
+
+            if (ImGui::BeginPopup("##export")) {
+                if (ImGui::Selectable("hex.view.hexeditor.menu.file.export.bps"_lang))
+                    this->exportPatch(false);
+                if (ImGui::Selectable("hex.view.hexeditor.menu.file.export.vcdiff"_lang))
+                    this->exportPatch(true);
+
+                ImGui::EndPopup();
+            }
+
+            if (this->m_diffRunning) {
+                ImGui::SameLine();
+                ImGui::TextSpinner(hex::format("hex.view.diff.diffing"_lang, this->m_diffProgress * 100).c_str());
+            }
+
+            if (this->m_exportRunning) {
+                ImGui::SameLine();
+                ImGui::TextSpinner("hex.view.diff.exporting"_lang);
+            }
+
+            if (!this->m_editScript.empty()) {
+                const auto &differenceMap = this->m_differenceMap;
+
+                ImGui::Disabled([this] {
+                    if (ImGui::ArrowButton("prevDifference", ImGuiDir_Up))
+                        this->jumpToDifference(false);
+                    ImGui::SameLine();
+                    if (ImGui::ArrowButton("nextDifference", ImGuiDir_Down))
+                        this->jumpToDifference(true);
+                }, differenceMap.differences.empty());
+
+                ImGui::SameLine();
+                if (differenceMap.differences.empty())
+                    ImGui::TextUnformatted("hex.view.diff.no_differences"_lang);
+                else if (this->m_currDifference.has_value())
+                    ImGui::TextUnformatted(hex::format("hex.view.diff.difference"_lang, this->m_currDifference.value() + 1, differenceMap.differences.size()).c_str());
+                else
+                    ImGui::TextUnformatted(hex::format("hex.view.diff.difference"_lang, "-", differenceMap.differences.size()).c_str());
+
+                ImGui::SameLine();
+                ImGui::Spacing();
+                ImGui::SameLine();
+                ImGui::TextUnformatted(hex::format("hex.view.diff.summary"_lang, differenceMap.changedBytes, differenceMap.insertedBytes, differenceMap.deletedBytes).c_str());
+            }
+
             ImGui::Separator();
 
+            auto tableSize = ImGui::GetContentRegionAvail();
+            tableSize.x -= MinimapWidth * SharedData::globalScale + ImGui::GetStyle().ItemSpacing.x;
+
             ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(20, 1));
-            if (ImGui::BeginTable("diff", 3, ImGuiTableFlags_ScrollY | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingFixedFit)) {
+            if (ImGui::BeginTable("diff", 3, ImGuiTableFlags_ScrollY | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingFixedFit, tableSize)) {
                 ImGui::TableSetupScrollFreeze(0, 1);
 
                 ImGui::TableNextColumn();
@@ -205,10 +525,9 @@ namespace hex {
                 }
 
 
-                if (this->m_providerA >= 0 && this->m_providerB >= 0) {
-                    auto &providers = ImHexApi::Provider::getProviders();
+                if (this->m_providerA >= 0 && this->m_providerB >= 0 && !this->m_editScript.empty()) {
                     ImGuiListClipper clipper;
-                    clipper.Begin(std::max(providers[this->m_providerA]->getSize() / this->m_columnCount, providers[this->m_providerB]->getSize() / this->m_columnCount));
+                    clipper.Begin((this->m_alignedSize + this->m_columnCount - 1) / this->m_columnCount);
 
                     // Draw diff lines
                     while (clipper.Step()) {
@@ -217,18 +536,52 @@ namespace hex {
                             ImGui::TableNextColumn();
                             drawDiffLine({this->m_providerA, this->m_providerB}, row);
                         }
+
+                        this->m_visibleRowStart = clipper.DisplayStart;
+                        this->m_visibleRowEnd = clipper.DisplayEnd;
+                    }
+
+                    // Center the requested row in the table
+                    if (this->m_scrollToRow.has_value()) {
+                        const float rowHeight = ImGui::GetTextLineHeight() + ImGui::GetStyle().CellPadding.y * 2;
+                        ImGui::SetScrollY(std::max(0.0F, this->m_scrollToRow.value() * rowHeight - ImGui::GetWindowHeight() / 2));
+                        this->m_scrollToRow.reset();
                     }
                 }
                 ImGui::EndTable();
             }
             ImGui::PopStyleVar();
 
+            if (!this->m_editScript.empty()) {
+                ImGui::SameLine();
+                this->drawMinimap(ImVec2(MinimapWidth * SharedData::globalScale, tableSize.y));
+            }
+
         }
         ImGui::End();
     }
 
+    void ViewDiff::drawAlwaysVisible() {
+        // The export thread can't open popups itself
+        if (this->m_exportFailed.exchange(false))
+            View::showErrorPopup("hex.view.hexeditor.error.export_patch"_lang);
+    }
+
     void ViewDiff::drawMenu() {
 
     }
 
+    bool ViewDiff::handleShortcut(bool keys[512], bool ctrl, bool shift, bool alt) {
+        ON_SCOPE_EXIT { ImGui::End(); };
+        if (ImGui::Begin(View::toWindowName("hex.view.diff.name").c_str())) {
+
+            if (ImGui::IsWindowFocused(ImGuiFocusedFlags_ChildWindows) && keys[GLFW_KEY_F7]) {
+                this->jumpToDifference(!shift);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <hex/providers/provider.hpp>
 #include <hex/helpers/crypto.hpp>
 
+#include <optional>
+#include <string>
 #include <vector>
 
 
@@ -220,6 +222,109 @@ namespace hex {
                                 ImGui::InputText("##nolabel", buffer, ImGuiInputTextFlags_ReadOnly);
                             }
                                 break;
+                            case 8: // XXH3-64
+                            {
+                                static u64 result = 0;
+
+                                if (this->m_shouldInvalidate)
+                                    result = crypt::xxh3_64(provider, this->m_hashRegion[0], this->m_hashRegion[1] - this->m_hashRegion[0] + 1);
+
+                                char buffer[sizeof(result) * 2 + 1];
+                                snprintf(buffer, sizeof(buffer), "%016llX", static_cast<unsigned long long>(result));
+
+                                ImGui::NewLine();
+                                ImGui::TextUnformatted("hex.view.hashes.result"_lang);
+                                ImGui::Separator();
+                                ImGui::InputText("##nolabel", buffer, ImGuiInputTextFlags_ReadOnly);
+                            }
+                                break;
+                            case 9: // XXH3-128
+                            {
+                                static std::array<u8, 16> result = { 0 };
+
+                                if (this->m_shouldInvalidate)
+                                    result = crypt::xxh3_128(provider, this->m_hashRegion[0], this->m_hashRegion[1] - this->m_hashRegion[0] + 1);
+
+                                char buffer[sizeof(result) * 2 + 1];
+                                formatBigHexInt(result, buffer, sizeof(buffer));
+
+                                ImGui::NewLine();
+                                ImGui::TextUnformatted("hex.view.hashes.result"_lang);
+                                ImGui::Separator();
+                                ImGui::InputText("##nolabel", buffer, ImGuiInputTextFlags_ReadOnly);
+                            }
+                                break;
+                            case 10: // BLAKE3
+                            {
+                                static std::array<u8, 32> result = { 0 };
+
+                                if (this->m_shouldInvalidate)
+                                    result = crypt::blake3(provider, this->m_hashRegion[0], this->m_hashRegion[1] - this->m_hashRegion[0] + 1);
+
+                                char buffer[sizeof(result) * 2 + 1];
+                                formatBigHexInt(result, buffer, sizeof(buffer));
+
+                                ImGui::NewLine();
+                                ImGui::TextUnformatted("hex.view.hashes.result"_lang);
+                                ImGui::Separator();
+                                ImGui::InputText("##nolabel", buffer, ImGuiInputTextFlags_ReadOnly);
+                            }
+                                break;
+                            case 11: // ssdeep
+                            {
+                                static std::string result, compareResult;
+                                static std::optional<u8> similarity;
+
+                                auto &providers = ImHexApi::Provider::getProviders();
+                                if (this->m_compareProvider >= static_cast<int>(providers.size()))
+                                    this->m_compareProvider = -1;
+
+                                std::string preview;
+                                if (this->m_compareProvider >= 0)
+                                    preview = providers[this->m_compareProvider]->getName();
+
+                                if (ImGui::BeginCombo("hex.view.hashes.compare"_lang, preview.c_str())) {
+                                    for (size_t i = 0; i < providers.size(); i++) {
+                                        if (ImGui::Selectable(providers[i]->getName().c_str(), int(i) == this->m_compareProvider)) {
+                                            this->m_compareProvider = i;
+                                            this->m_shouldInvalidate = true;
+                                        }
+                                    }
+
+                                    ImGui::EndCombo();
+                                }
+
+                                if (this->m_shouldInvalidate) {
+                                    result = crypt::ssdeep(provider, this->m_hashRegion[0], this->m_hashRegion[1] - this->m_hashRegion[0] + 1);
+
+                                    if (this->m_compareProvider >= 0) {
+                                        auto compareProvider = providers[this->m_compareProvider];
+                                        compareResult = crypt::ssdeep(compareProvider);
+                                        similarity = crypt::ssdeepCompare(result, compareResult);
+                                    } else {
+                                        compareResult.clear();
+                                        similarity.reset();
+                                    }
+                                }
+
+                                ImGui::NewLine();
+                                ImGui::TextUnformatted("hex.view.hashes.result"_lang);
+                                ImGui::Separator();
+                                ImGui::InputText("##nolabel", result.data(), result.size() + 1, ImGuiInputTextFlags_ReadOnly);
+
+                                if (this->m_compareProvider >= 0) {
+                                    ImGui::InputText("##compare", compareResult.data(), compareResult.size() + 1, ImGuiInputTextFlags_ReadOnly);
+
+                                    ImGui::NewLine();
+                                    ImGui::TextUnformatted("hex.view.hashes.similarity"_lang);
+                                    ImGui::Separator();
+                                    if (similarity.has_value())
+                                        ImGui::Text("%d%%", similarity.value());
+                                    else
+                                        ImGui::TextUnformatted("-");
+                                }
+                            }
+                                break;
                         }
 
                     }
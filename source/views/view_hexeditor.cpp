@@ -19,6 +19,7 @@
 #include <cstdio>
 
 #include <filesystem>
+#include <queue>
 
 #if defined(OS_WINDOWS)
     #include <windows.h>
@@ -71,14 +72,14 @@ namespace hex {
                     prevColor = (color & 0x00FFFFFF) | alpha;
             }
 
-            if (_this->m_highlightedBytes.contains(off)) {
-                auto color = (_this->m_highlightedBytes[off] & 0x00FFFFFF) | alpha;
-                currColor = currColor.has_value() ? ImAlphaBlendColors(color, currColor.value()) : color;
-            }
-            if (_this->m_highlightedBytes.contains(off - 1)) {
-                auto color = (_this->m_highlightedBytes[off - 1] & 0x00FFFFFF) | alpha;
+            if (auto highlightColor = _this->getHighlightColor(off - 1); highlightColor.has_value()) {
+                auto color = (highlightColor.value() & 0x00FFFFFF) | alpha;
                 prevColor = prevColor.has_value() ? ImAlphaBlendColors(color, prevColor.value()) : color;
             }
+            if (auto highlightColor = _this->getHighlightColor(off); highlightColor.has_value()) {
+                auto color = (highlightColor.value() & 0x00FFFFFF) | alpha;
+                currColor = currColor.has_value() ? ImAlphaBlendColors(color, currColor.value()) : color;
+            }
 
             if (next && prevColor != currColor) {
                 return false;
@@ -171,11 +172,7 @@ namespace hex {
         });
 
         EventManager::subscribe<EventPatternChanged>(this, [this]() {
-            this->m_highlightedBytes.clear();
-
-            for (const auto &pattern : SharedData::patternData) {
-                this->m_highlightedBytes.merge(pattern->getHighlightedAddresses());
-            }
+            this->updateHighlightedRanges();
         });
 
         EventManager::subscribe<RequestOpenWindow>(this, [this](std::string name) {
@@ -259,6 +256,12 @@ namespace hex {
 
             region = Region { address, size };
         });
+
+        EventManager::subscribe<EventProviderDeleted>(this, [this](prv::Provider *provider) {
+            // The export thread reads from the provider directly
+            if (provider == this->m_patchExportProvider)
+                this->stopPatchExport();
+        });
     }
 
     ViewHexEditor::~ViewHexEditor() {
@@ -269,6 +272,9 @@ namespace hex {
         EventManager::unsubscribe<EventPatternChanged>(this);
         EventManager::unsubscribe<RequestOpenWindow>(this);
         EventManager::unsubscribe<EventSettingsChanged>(this);
+        EventManager::unsubscribe<EventProviderDeleted>(this);
+
+        this->stopPatchExport();
     }
 
     void ViewHexEditor::drawContent() {
@@ -330,6 +336,10 @@ namespace hex {
     void ViewHexEditor::drawAlwaysVisible() {
         auto provider = ImHexApi::Provider::get();
 
+        // The export thread can't open popups itself
+        if (this->m_patchExportFailed.exchange(false))
+            View::showErrorPopup("hex.view.hexeditor.error.export_patch"_lang);
+
         if (ImGui::BeginPopupModal("hex.view.hexeditor.exit_application.title"_lang, nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
             ImGui::NewLine();
             ImGui::TextUnformatted("hex.view.hexeditor.exit_application.desc"_lang);
@@ -586,6 +596,10 @@ namespace hex {
                         this->saveToFile(path, this->m_dataToSave);
                     });
                 }
+                if (ImGui::MenuItem("hex.view.hexeditor.menu.file.export.bps"_lang, nullptr, false, !this->m_patchExportRunning))
+                    this->exportPatch(false);
+                if (ImGui::MenuItem("hex.view.hexeditor.menu.file.export.vcdiff"_lang, nullptr, false, !this->m_patchExportRunning))
+                    this->exportPatch(true);
 
                 ImGui::EndMenu();
             }
@@ -723,6 +737,45 @@ namespace hex {
         EventManager::post<EventPatternChanged>();
     }
 
+    void ViewHexEditor::exportPatch(bool vcdiff) {
+        auto provider = ImHexApi::Provider::get();
+
+        // Patches are keyed by address, the encoders want them relative to the start of the data
+        const u64 baseAddress = provider->getBaseAddress() - prv::Provider::PageSize * provider->getCurrentPage();
+        Patches patches;
+        for (const auto &[address, value] : provider->getPatches()) {
+            if (address >= baseAddress)
+                patches[address - baseAddress] = value;
+        }
+
+        hex::openFileBrowser("hex.view.hexeditor.menu.file.export.title"_lang, DialogMode::Save, { }, [this, provider, patches = std::move(patches), vcdiff](auto path) {
+            this->stopPatchExport();
+
+            this->m_patchExportProvider = provider;
+            this->m_patchExportRunning = true;
+            this->m_patchExportCancelled = false;
+            this->m_patchExportThread = std::thread([this, provider, patches, vcdiff, path] {
+                auto patch = vcdiff ? generateVCDIFFPatch(provider, patches, this->m_patchExportCancelled) : generateBPSPatch(provider, patches, this->m_patchExportCancelled);
+
+                if (!this->m_patchExportCancelled) {
+                    File file(path, File::Mode::Create);
+                    if (!file.isValid() || !file.write(patch) || !file.flush())
+                        this->m_patchExportFailed = true;
+                }
+
+                this->m_patchExportRunning = false;
+            });
+        });
+    }
+
+    void ViewHexEditor::stopPatchExport() {
+        this->m_patchExportCancelled = true;
+        if (this->m_patchExportThread.joinable())
+            this->m_patchExportThread.join();
+
+        this->m_patchExportProvider = nullptr;
+    }
+
     bool ViewHexEditor::saveToFile(const std::string &path, const std::vector<u8>& data) {
         File(path, File::Mode::Create).write(data);
 
@@ -1090,6 +1143,99 @@ R"(
         return results;
     }
 
+    void ViewHexEditor::updateHighlightedRanges() {
+        struct PrioritizedRange {
+            pl::HighlightedRange range;
+            u64 priority;
+        };
+
+        // Patterns are listed in priority order, earlier patterns and earlier ranges within a pattern win where they overlap
+        std::vector<PrioritizedRange> ranges;
+        for (const auto &pattern : SharedData::patternData) {
+            for (const auto &range : pattern->getHighlightedRanges()) {
+                if (range.start < range.end)
+                    ranges.push_back({ range, ranges.size() });
+            }
+        }
+
+        std::sort(ranges.begin(), ranges.end(), [](const auto &left, const auto &right) {
+            return left.range.start < right.range.start;
+        });
+
+        this->m_highlightedRanges.clear();
+        this->m_lastHighlightedRange = 0;
+
+        // Sweep over all ranges keeping the ones covering the current address in a heap ordered by priority
+        auto hasLowerPriority = [&ranges](size_t left, size_t right) { return ranges[left].priority > ranges[right].priority; };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(hasLowerPriority)> activeRanges(hasLowerPriority);
+
+        size_t nextRange = 0;
+        u64 address = 0;
+        while (nextRange < ranges.size() || !activeRanges.empty()) {
+            if (activeRanges.empty())
+                address = ranges[nextRange].range.start;
+
+            while (nextRange < ranges.size() && ranges[nextRange].range.start <= address) {
+                activeRanges.push(nextRange);
+                nextRange++;
+            }
+
+            while (!activeRanges.empty() && ranges[activeRanges.top()].range.end <= address)
+                activeRanges.pop();
+
+            if (activeRanges.empty())
+                continue;
+
+            const auto &top = ranges[activeRanges.top()].range;
+            u64 end = top.end;
+            if (nextRange < ranges.size())
+                end = std::min(end, ranges[nextRange].range.start);
+
+            if (!this->m_highlightedRanges.empty() && this->m_highlightedRanges.back().end == address && this->m_highlightedRanges.back().color == top.color)
+                this->m_highlightedRanges.back().end = end;
+            else
+                this->m_highlightedRanges.push_back({ address, end, top.color });
+
+            address = end;
+        }
+    }
+
+    std::optional<u32> ViewHexEditor::getHighlightColor(u64 address) {
+        auto &ranges = this->m_highlightedRanges;
+        if (ranges.empty())
+            return { };
+
+        // Bytes are queried row by row so the range of the previous lookup or the one after it is usually the right one
+        auto &last = this->m_lastHighlightedRange;
+        if (last >= ranges.size())
+            last = 0;
+
+        if (address >= ranges[last].start) {
+            if (address < ranges[last].end)
+                return ranges[last].color;
+            if (last + 1 < ranges.size() && address < ranges[last + 1].start)
+                return { };
+            if (last + 1 < ranges.size() && address < ranges[last + 1].end) {
+                last++;
+                return ranges[last].color;
+            }
+        }
+
+        auto range = std::upper_bound(ranges.begin(), ranges.end(), address, [](u64 address, const auto &range) {
+            return address < range.start;
+        });
+
+        if (range == ranges.begin())
+            return { };
+
+        range--;
+        if (address >= range->end)
+            return { };
+
+        last = std::distance(ranges.begin(), range);
+        return range->color;
+    }
+
 
     void ViewHexEditor::drawSearchPopup() {
         static auto InputCallback = [](ImGuiInputTextCallbackData* data) -> int {
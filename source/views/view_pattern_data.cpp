@@ -1,22 +1,66 @@
 #include "views/view_pattern_data.hpp"
 
+#include <hex/api/imhex_api.hpp>
 #include <hex/providers/provider.hpp>
 #include <hex/pattern_language/pattern_data.hpp>
+#include <hex/pattern_language/pattern_exporter.hpp>
 
 namespace hex {
 
+    namespace {
+
+        bool isArray(pl::PatternData *pattern) {
+            return dynamic_cast<pl::PatternDataStaticArray*>(pattern) != nullptr || dynamic_cast<pl::PatternDataDynamicArray*>(pattern) != nullptr;
+        }
+
+        bool containsOffset(pl::PatternData *pattern, u64 offset) {
+            return offset >= pattern->getOffset() && offset < pattern->getOffset() + pattern->getSize();
+        }
+
+        /* Rows are identified by their path in the pattern tree so their expansion state survives evaluating the pattern again */
+        u64 getChildId(u64 parentId, const std::string &name) {
+            hashCombine(parentId, std::hash<std::string>{}(name));
+            return parentId;
+        }
+
+        u64 getChildId(u64 parentId, u64 index) {
+            hashCombine(parentId, index);
+            return parentId;
+        }
+
+    }
+
     ViewPatternData::ViewPatternData() : View("hex.view.pattern_data.name") {
 
         EventManager::subscribe<EventPatternChanged>(this, [this]() {
             this->m_sortedPatternData.clear();
+            this->m_sortState.reset();
+            this->m_rows.clear();
+            this->m_rowCount = 0;
+            this->m_rowsDirty = true;
+        });
+
+        EventManager::subscribe<EventRegionSelected>(this, [this](Region region) {
+            if (region.address != (size_t)-1)
+                this->m_jumpOffset = region.address;
+        });
+
+        EventManager::subscribe<EventProviderDeleted>(this, [this](prv::Provider *provider) {
+            // The export thread reads from the provider directly
+            if (provider == this->m_exportProvider)
+                this->stopExport();
         });
     }
 
     ViewPatternData::~ViewPatternData() {
         EventManager::unsubscribe<EventPatternChanged>(this);
+        EventManager::unsubscribe<EventRegionSelected>(this);
+        EventManager::unsubscribe<EventProviderDeleted>(this);
+
+        this->stopExport();
     }
 
-    static bool beginPatternDataTable(prv::Provider* &provider, const std::vector<pl::PatternData*> &patterns, std::vector<pl::PatternData*> &sortedPatterns) {
+    bool ViewPatternData::beginPatternDataTable(prv::Provider* &provider, const std::vector<pl::PatternData*> &patterns) {
         if (ImGui::BeginTable("##patterndatatable", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_Sortable | ImGuiTableFlags_Reorderable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
             ImGui::TableSetupScrollFreeze(0, 1);
             ImGui::TableSetupColumn("hex.view.pattern_data.name"_lang, 0, -1, ImGui::GetID("name"));
@@ -28,37 +72,262 @@ namespace hex {
 
             auto sortSpecs = ImGui::TableGetSortSpecs();
 
-            if (sortSpecs->SpecsDirty || sortedPatterns.empty()) {
-                sortedPatterns = patterns;
-
-                std::sort(sortedPatterns.begin(), sortedPatterns.end(), [&sortSpecs, &provider](pl::PatternData* left, pl::PatternData* right) -> bool {
-                    return pl::PatternData::sortPatternDataTable(sortSpecs, provider, left, right);
-                });
+            // Sorting is only done again once the sort order or the data it depends on changed
+            if (this->m_sortState.update(sortSpecs, provider, 0, std::numeric_limits<u64>::max())) {
+                this->m_sortedPatternData = patterns;
+                pl::PatternData::sortPatterns(sortSpecs, provider, this->m_sortedPatternData);
 
-                for (auto &pattern : sortedPatterns)
+                for (auto &pattern : this->m_sortedPatternData)
                     pattern->sort(sortSpecs, provider);
 
-                sortSpecs->SpecsDirty = false;
+                this->m_rowsDirty = true;
             }
 
+            sortSpecs->SpecsDirty = false;
+
             return true;
         }
 
         return false;
     }
 
+    void ViewPatternData::buildRows() {
+        this->m_rows.clear();
+        this->m_childRows.clear();
+        this->m_rowCount = 0;
+
+        std::vector<u64> topLevelRows;
+        for (auto &pattern : this->m_sortedPatternData)
+            this->addRows(pattern, getChildId(0, pattern->getVariableName()), 0, topLevelRows);
+
+        this->m_topLevelRows = this->storeChildren(nullptr, topLevelRows);
+        this->m_rowsDirty = false;
+    }
+
+    void ViewPatternData::addRows(pl::PatternData *pattern, u64 id, u32 depth, std::vector<u64> &siblings) {
+        if (!pattern->hasEntry())
+            return;
+
+        auto index = this->m_rows.size();
+        this->m_rows.push_back({ pattern, id, depth, 0, 0, this->m_rowCount, 0 });
+        this->m_rowCount++;
+        siblings.push_back(index);
+
+        if (pattern->getChildCount() > 0 && this->m_expandedPatterns.contains(id)) {
+            std::vector<u64> children;
+            this->addChildRows(pattern, id, depth + 1, children);
+            this->m_rows[index].children = this->storeChildren(pattern, children);
+        }
+
+        this->m_rows[index].subtreeEnd = this->m_rows.size();
+    }
+
+    ViewPatternData::Children ViewPatternData::storeChildren(pl::PatternData *parent, const std::vector<u64> &children) {
+        // Array entries are looked up by their index instead, struct members and top-level patterns can be in any order
+        bool sorted = true;
+        if (parent == nullptr || !isArray(parent)) {
+            for (u64 i = 1; i < children.size() && sorted; i++) {
+                auto previous = this->m_rows[children[i - 1]].pattern, next = this->m_rows[children[i]].pattern;
+                sorted = previous->getOffset() + previous->getSize() <= next->getOffset();
+            }
+        }
+
+        Children result = { this->m_childRows.size(), children.size(), sorted };
+        this->m_childRows.insert(this->m_childRows.end(), children.begin(), children.end());
+
+        return result;
+    }
+
+    void ViewPatternData::addChildRows(pl::PatternData *pattern, u64 id, u32 depth, std::vector<u64> &children) {
+        const auto childCount = pattern->getChildCount();
+
+        if (!isArray(pattern)) {
+            for (u64 i = 0; i < childCount; i++) {
+                if (auto child = pattern->getChild(i); child != nullptr)
+                    this->addRows(child, getChildId(id, child->getVariableName()), depth, children);
+            }
+
+            return;
+        }
+
+        // Only expanded entries get rows of their own, all others are kept as runs so huge arrays only take up a handful of rows
+        u64 nextEntry = 0;
+        for (auto expanded = this->m_expandedEntries.lower_bound({ id, 0 }); expanded != this->m_expandedEntries.end() && expanded->first == id && expanded->second < childCount; expanded++) {
+            const auto index = expanded->second;
+            const auto entryId = getChildId(id, index);
+            if (!this->m_expandedPatterns.contains(entryId))
+                continue;
+
+            auto entry = pattern->getChild(index);
+            if (entry == nullptr || !entry->hasEntry())
+                continue;
+
+            this->addEntryRows(pattern, id, depth, nextEntry, index - nextEntry, children);
+            this->addRows(entry, entryId, depth, children);
+            this->m_rows[children.back()].firstEntry = index;
+            nextEntry = index + 1;
+        }
+
+        this->addEntryRows(pattern, id, depth, nextEntry, childCount - nextEntry, children);
+    }
+
+    void ViewPatternData::addEntryRows(pl::PatternData *array, u64 id, u32 depth, u64 firstEntry, u64 entryCount, std::vector<u64> &siblings) {
+        if (entryCount == 0)
+            return;
+
+        siblings.push_back(this->m_rows.size());
+        this->m_rows.push_back({ array, id, depth, firstEntry, entryCount, this->m_rowCount, this->m_rows.size() + 1 });
+        this->m_rowCount += entryCount;
+    }
+
+    void ViewPatternData::drawRow(prv::Provider *provider, const Row &row, u64 rowOffset) {
+        const bool isEntry = row.entryCount != 0;
+        const u64 entryIndex = row.firstEntry + rowOffset;
+        const u64 id = isEntry ? getChildId(row.id, entryIndex) : row.id;
+        const bool expanded = !isEntry && this->m_expandedPatterns.contains(id);
+
+        const float indent = row.depth * ImGui::GetStyle().IndentSpacing;
+        if (indent > 0)
+            ImGui::Indent(indent);
+
+        // The tree node of the row is the only thing that stores state so whatever ends up in here is whether it's open now
+        auto windowStorage = ImGui::GetStateStorage();
+        this->m_rowStorage.Clear();
+        ImGui::SetStateStorage(&this->m_rowStorage);
+        ImGui::PushID(static_cast<int>(id));
+        ImGui::SetNextItemOpen(expanded);
+
+        if (isEntry)
+            row.pattern->drawChild(provider, entryIndex);
+        else
+            row.pattern->draw(provider);
+
+        ImGui::PopID();
+        ImGui::SetStateStorage(windowStorage);
+
+        if (indent > 0)
+            ImGui::Unindent(indent);
+
+        bool open = expanded;
+        for (const auto &state : this->m_rowStorage.Data)
+            open = state.val_i != 0;
+
+        if (open != expanded) {
+            if (open) {
+                this->m_expandedPatterns.insert(id);
+                if (isEntry)
+                    this->m_expandedEntries.insert({ row.id, entryIndex });
+            } else {
+                this->m_expandedPatterns.erase(id);
+            }
+
+            this->m_rowsDirty = true;
+        }
+    }
+
+    std::optional<u64> ViewPatternData::findRow(u64 offset) const {
+        std::optional<u64> result;
+
+        // Walks down the tree, only the children of the innermost row containing the offset are looked at
+        pl::PatternData *parent = nullptr;
+        const Children *children = &this->m_topLevelRows;
+        while (children->count > 0) {
+            const auto childRows = this->m_childRows.begin() + children->first;
+            const auto childRowsEnd = childRows + children->count;
+            const Row *row;
+
+            if (parent != nullptr && isArray(parent)) {
+                // The array knows which entry contains the offset and its rows are ordered by entry index
+                auto index = parent->findChild(offset);
+                if (!index.has_value())
+                    break;
+
+                auto child = std::upper_bound(childRows, childRowsEnd, *index, [this](u64 index, u64 row) { return index < this->m_rows[row].firstEntry; });
+                if (child == childRows)
+                    break;
+
+                row = &this->m_rows[*(child - 1)];
+                if (row->entryCount != 0) {
+                    if (*index < row->firstEntry + row->entryCount)
+                        return row->firstRow + (*index - row->firstEntry);
+                    else
+                        break;
+                }
+
+                if (row->firstEntry != *index)
+                    break;
+            } else if (children->sorted) {
+                auto child = std::upper_bound(childRows, childRowsEnd, offset, [this](u64 offset, u64 row) { return offset < this->m_rows[row].pattern->getOffset(); });
+                if (child == childRows)
+                    break;
+
+                row = &this->m_rows[*(child - 1)];
+            } else {
+                auto child = std::find_if(childRows, childRowsEnd, [this, offset](u64 row) { return containsOffset(this->m_rows[row].pattern, offset); });
+                if (child == childRowsEnd)
+                    break;
+
+                row = &this->m_rows[*child];
+            }
+
+            if (!containsOffset(row->pattern, offset))
+                break;
+
+            result = row->firstRow;
+            parent = row->pattern;
+            children = &row->children;
+        }
+
+        return result;
+    }
+
     void ViewPatternData::drawContent() {
         if (ImGui::Begin(View::toWindowName("hex.view.pattern_data.name").c_str(), &this->getWindowOpenState(), ImGuiWindowFlags_NoCollapse)) {
             auto provider = ImHexApi::Provider::get();
             if (ImHexApi::Provider::isValid() && provider->isReadable()) {
 
-                if (beginPatternDataTable(provider, SharedData::patternData, this->m_sortedPatternData)) {
+                if (this->beginPatternDataTable(provider, SharedData::patternData)) {
                     ImGui::TableHeadersRow();
-                    if (this->m_sortedPatternData.size() > 0) {
 
-                        for (auto &patternData : this->m_sortedPatternData)
-                            patternData->draw(provider);
+                    if (this->m_rowsDirty)
+                        this->buildRows();
+
+                    const float rowHeight = ImGui::GetTextLineHeight() + ImGui::GetStyle().CellPadding.y * 2;
 
+                    // ImGui counts rows with an int, anything past that can't be scrolled to
+                    const auto clippedRowCount = static_cast<int>(std::min<u64>(this->m_rowCount, std::numeric_limits<int>::max()));
+
+                    if (this->m_jumpOffset.has_value()) {
+                        // Only scroll if the row isn't visible already
+                        if (auto row = this->findRow(*this->m_jumpOffset); row.has_value() && *row < u64(clippedRowCount)) {
+                            const float rowStart = *row * rowHeight;
+                            const float visibleHeight = ImGui::GetWindowHeight() - rowHeight;
+
+                            if (rowStart < ImGui::GetScrollY() || rowStart + rowHeight > ImGui::GetScrollY() + visibleHeight)
+                                ImGui::SetScrollY(std::max(0.0F, rowStart - (visibleHeight - rowHeight) / 2));
+                        }
+
+                        this->m_jumpOffset.reset();
+                    }
+
+                    if (!this->m_rows.empty()) {
+                        ImGuiListClipper clipper;
+                        clipper.Begin(clippedRowCount, rowHeight);
+
+                        while (clipper.Step()) {
+                            auto row = std::upper_bound(this->m_rows.begin(), this->m_rows.end(), u64(clipper.DisplayStart), [](u64 rowIndex, const Row &row) {
+                                return rowIndex < row.firstRow;
+                            }) - 1;
+
+                            for (u64 i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                                while (i >= row->firstRow + row->getRowCount())
+                                    row++;
+
+                                this->drawRow(provider, *row, i - row->firstRow);
+                            }
+                        }
+
+                        clipper.End();
                     }
 
                     ImGui::EndTable();
@@ -69,8 +338,59 @@ namespace hex {
         ImGui::End();
     }
 
+    void ViewPatternData::drawAlwaysVisible() {
+        // The export thread can't open popups itself
+        if (this->m_exportFailed.exchange(false))
+            View::showErrorPopup("hex.view.pattern_data.error.export"_lang);
+    }
+
     void ViewPatternData::drawMenu() {
+        if (ImGui::BeginMenu("hex.menu.file"_lang)) {
+            if (ImGui::BeginMenu("hex.view.pattern_data.menu.file.export"_lang, ImHexApi::Provider::isValid() && !SharedData::patternData.empty() && !this->m_exportRunning)) {
+                if (ImGui::MenuItem("hex.view.pattern_data.menu.file.export.json"_lang))
+                    this->exportPatternData(pl::PatternExporter::Format::JSON, { { "JSON File", "json" } });
+                if (ImGui::MenuItem("hex.view.pattern_data.menu.file.export.csv"_lang))
+                    this->exportPatternData(pl::PatternExporter::Format::CSV, { { "CSV File", "csv" } });
+                if (ImGui::MenuItem("hex.view.pattern_data.menu.file.export.binary"_lang))
+                    this->exportPatternData(pl::PatternExporter::Format::Binary, { });
+
+                ImGui::EndMenu();
+            }
+
+            ImGui::EndMenu();
+        }
+    }
+
+    void ViewPatternData::exportPatternData(pl::PatternExporter::Format format, const std::vector<nfdfilteritem_t> &validExtensions) {
+        hex::openFileBrowser("hex.view.pattern_data.menu.file.export.title"_lang, DialogMode::Save, validExtensions, [this, format](auto path) {
+            this->stopExport();
+
+            auto provider = ImHexApi::Provider::get();
+            std::vector<pl::PatternData*> patterns;
+            for (auto &pattern : SharedData::patternData)
+                patterns.push_back(pattern->clone());
+
+            this->m_exportProvider = provider;
+            this->m_exportRunning = true;
+            this->m_exportCancelled = false;
+            this->m_exportThread = std::thread([this, exporter = pl::PatternExporter(provider, format), patterns = std::move(patterns), path]() mutable {
+                if (!exporter.exportToFile(patterns, path, this->m_exportCancelled) && !this->m_exportCancelled)
+                    this->m_exportFailed = true;
+
+                for (auto &pattern : patterns)
+                    delete pattern;
+
+                this->m_exportRunning = false;
+            });
+        });
+    }
+
+    void ViewPatternData::stopExport() {
+        this->m_exportCancelled = true;
+        if (this->m_exportThread.joinable())
+            this->m_exportThread.join();
 
+        this->m_exportProvider = nullptr;
     }
 
-}
\ No newline at end of file
+}
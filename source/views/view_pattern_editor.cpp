@@ -1,6 +1,7 @@
 #include "views/view_pattern_editor.hpp"
 
 #include "helpers/project_file_handler.hpp"
+#include <hex/api/imhex_api.hpp>
 #include <hex/pattern_language/preprocessor.hpp>
 #include <hex/pattern_language/pattern_data.hpp>
 #include <hex/helpers/paths.hpp>
@@ -14,6 +15,8 @@
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+
 namespace hex {
 
     using namespace hex::literals;
@@ -148,6 +151,22 @@ namespace hex {
             }
         });
 
+        EventManager::subscribe<EventProviderDeleted>(this, [this](prv::Provider *provider) {
+            std::unique_lock lock(this->m_providerResultsMutex);
+
+            auto result = std::find_if(this->m_providerResults.begin(), this->m_providerResults.end(), [provider](const auto &entry) { return entry.provider == provider; });
+            if (result == this->m_providerResults.end())
+                return;
+
+            // Workers only pick up results that are still there, one that's evaluating the provider right now has to finish first
+            while (result->runtime != nullptr) {
+                result->runtime->abort();
+                this->m_providerResultsChanged.wait_for(lock, std::chrono::milliseconds(10));
+            }
+
+            this->m_providerResults.erase(result);
+        });
+
         /* Settings */
         {
 
@@ -170,13 +189,29 @@ namespace hex {
     }
 
     ViewPatternEditor::~ViewPatternEditor() {
-        delete this->m_patternLanguageRuntime;
-
         EventManager::unsubscribe<EventProjectFileStore>(this);
         EventManager::unsubscribe<EventProjectFileLoad>(this);
         EventManager::unsubscribe<RequestAppendPatternLanguageCode>(this);
         EventManager::unsubscribe<EventFileLoaded>(this);
         EventManager::unsubscribe<RequestChangeTheme>(this);
+        EventManager::unsubscribe<EventProviderDeleted>(this);
+
+        {
+            std::unique_lock lock(this->m_providerResultsMutex);
+
+            this->m_abortRunOnAllProviders = true;
+            while (std::any_of(this->m_providerResults.begin(), this->m_providerResults.end(), [](const auto &result) { return result.runtime != nullptr; })) {
+                this->abortProviderRuns();
+                this->m_providerResultsChanged.wait_for(lock, std::chrono::milliseconds(10));
+            }
+        }
+
+        if (this->m_runOnAllProvidersThread.joinable())
+            this->m_runOnAllProvidersThread.join();
+
+        // Lazily decoded patterns decode their entries through the runtime, they have to go first
+        this->clearPatternData();
+        delete this->m_patternLanguageRuntime;
     }
 
     void ViewPatternEditor::drawMenu() {
@@ -231,32 +266,51 @@ namespace hex {
                 ImGui::EndChild();
                 ImGui::PopStyleColor(1);
 
-                ImGui::Disabled([this] {
+                if (this->m_evaluatorRunning) {
+                    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(ImColor(0xC0, 0x20, 0x20)));
+                    ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 1);
+
+                    if (ImGui::Button("hex.view.pattern.abort"_lang))
+                        this->m_patternLanguageRuntime->abort();
+
+                    ImGui::PopStyleVar();
+                    ImGui::PopStyleColor();
+                } else {
                     ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(ImColor(0x20, 0x85, 0x20)));
                     ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 1);
 
-                    if (ImGui::ArrowButton("evaluate", ImGuiDir_Right))
-                        this->parsePattern(this->m_textEditor.GetText().data());
+                    // A base address set by the pattern gets applied to the provider afterwards, which would move the data below runs on all providers
+                    ImGui::Disabled([this] {
+                        if (ImGui::ArrowButton("evaluate", ImGuiDir_Right))
+                            this->parsePattern(this->m_textEditor.GetText().data());
+                    }, this->m_runningOnAllProviders);
 
                     ImGui::PopStyleVar();
                     ImGui::PopStyleColor();
-                }, this->m_evaluatorRunning);
+                }
 
                 ImGui::SameLine();
                 if (this->m_evaluatorRunning)
-                    ImGui::TextSpinner("hex.view.pattern.evaluating"_lang);
-                else
+                    ImGui::TextSpinner(hex::format("{} {:.0f}%", static_cast<const char *>("hex.view.pattern.evaluating"_lang), this->m_patternLanguageRuntime->getProgress() * 100).c_str());
+                else {
                     if (ImGui::Checkbox("hex.view.pattern.auto"_lang, &this->m_runAutomatically)) {
                         if (this->m_runAutomatically)
                             this->m_hasUnevaluatedChanges = true;
                     }
 
+                    ImGui::SameLine();
+                    ImGui::Disabled([this] {
+                        if (ImGui::Button("hex.view.pattern.all_providers.run"_lang))
+                            this->runOnAllProviders(this->m_textEditor.GetText());
+                    }, this->m_runningOnAllProviders);
+                }
+
                 if (this->m_textEditor.IsTextChanged()) {
                     if (this->m_runAutomatically)
                         this->m_hasUnevaluatedChanges = true;
                 }
 
-                if (this->m_hasUnevaluatedChanges && !this->m_evaluatorRunning) {
+                if (this->m_hasUnevaluatedChanges && !this->m_evaluatorRunning && !this->m_runningOnAllProviders) {
                     this->m_hasUnevaluatedChanges = false;
                     ProjectFile::markDirty();
 
@@ -270,6 +324,8 @@ namespace hex {
     }
 
     void ViewPatternEditor::drawAlwaysVisible() {
+        this->drawProviderResults();
+
         if (ImGui::BeginPopupModal("hex.view.pattern.accept_pattern"_lang, nullptr, ImGuiWindowFlags_AlwaysAutoResize)) {
             ImGui::TextWrapped("%s", static_cast<const char *>("hex.view.pattern.accept_pattern.desc"_lang));
 
@@ -347,7 +403,18 @@ namespace hex {
         EventManager::post<EventPatternChanged>();
 
         std::thread([this, buffer = std::string(buffer)] {
-            auto result = this->m_patternLanguageRuntime->executeString(ImHexApi::Provider::get(), buffer);
+            auto provider = ImHexApi::Provider::get();
+            auto result = this->m_patternLanguageRuntime->executeString(provider, buffer);
+
+            // Patterns are placed relative to the base address they asked for, the open file takes it over so the two line up
+            if (auto baseAddress = this->m_patternLanguageRuntime->getBaseAddress(); baseAddress.has_value()) {
+                View::doLater([providerId = provider->getID(), baseAddress = *baseAddress] {
+                    for (auto &openProvider : ImHexApi::Provider::getProviders()) {
+                        if (openProvider->getID() == providerId)
+                            openProvider->setBaseAddress(baseAddress);
+                    }
+                });
+            }
 
             auto error = this->m_patternLanguageRuntime->getError();
             if (error.has_value()) {
@@ -368,4 +435,186 @@ namespace hex {
 
     }
 
+    void ViewPatternEditor::runOnAllProviders(const std::string &code) {
+        if (this->m_runOnAllProvidersThread.joinable())
+            this->m_runOnAllProvidersThread.join();
+
+        const auto &providers = ImHexApi::Provider::getProviders();
+
+        {
+            std::scoped_lock lock(this->m_providerResultsMutex);
+
+            this->m_providerResults.clear();
+            for (auto &provider : providers)
+                this->m_providerResults.push_back({ provider, provider->getID(), provider->getName() });
+        }
+
+        this->m_runningOnAllProviders = true;
+        this->m_abortRunOnAllProviders = false;
+        this->m_providerResultsOpen = true;
+
+        this->m_runOnAllProvidersThread = std::thread([this, code, providerCount = providers.size()] {
+            auto worker = [&, this] {
+                // Every thread gets its own runtime so evaluations never share any state with each other
+                pl::PatternLanguage runtime;
+
+                while (true) {
+                    prv::Provider *provider;
+                    u64 providerId;
+
+                    // Providers that get closed are removed from the results, anything that's still in there is safe to use until it's marked as done
+                    {
+                        std::scoped_lock lock(this->m_providerResultsMutex);
+                        if (this->m_abortRunOnAllProviders)
+                            break;
+
+                        auto next = std::find_if(this->m_providerResults.begin(), this->m_providerResults.end(), [](const auto &result) { return !result.done && result.runtime == nullptr; });
+                        if (next == this->m_providerResults.end())
+                            break;
+
+                        next->runtime = &runtime;
+                        provider = next->provider;
+                        providerId = next->providerId;
+                    }
+
+                    ProviderResult result = { provider, providerId, provider->getName(), nullptr, true };
+
+                    auto patterns = runtime.executeString(provider, code);
+
+                    const auto &log = runtime.getConsoleLog();
+                    if (auto warning = std::find_if(log.begin(), log.end(), [](const auto &entry) { return entry.first == pl::LogConsole::Level::Warning; }); warning != log.end())
+                        result.warning = warning->second;
+
+                    if (patterns.has_value()) {
+                        result.success = true;
+
+                        for (auto &pattern : *patterns) {
+                            if (!pattern->isHidden())
+                                result.patternCount++;
+
+                            delete pattern;
+                        }
+                    } else {
+                        result.error = runtime.getError();
+
+                        // Errors that didn't come with a line number only end up in the console
+                        if (!result.error.has_value() || result.error->second.empty()) {
+                            auto lastError = std::find_if(log.rbegin(), log.rend(), [](const auto &entry) { return entry.first == pl::LogConsole::Level::Error; });
+                            result.error = { 0, lastError != log.rend() ? lastError->second : "" };
+                        }
+                    }
+
+                    std::scoped_lock lock(this->m_providerResultsMutex);
+                    if (auto entry = std::find_if(this->m_providerResults.begin(), this->m_providerResults.end(), [providerId](const auto &stored) { return stored.providerId == providerId; }); entry != this->m_providerResults.end())
+                        *entry = std::move(result);
+
+                    this->m_providerResultsChanged.notify_all();
+                }
+            };
+
+            const size_t threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, std::max<size_t>(providerCount, 1));
+
+            std::vector<std::thread> threads;
+            for (size_t i = 1; i < threadCount; i++)
+                threads.emplace_back(worker);
+
+            worker();
+
+            for (auto &thread : threads)
+                thread.join();
+
+            this->m_runningOnAllProviders = false;
+        });
+    }
+
+    /* Runs that were just starting when they got aborted reset the abort again, so this is repeated until they're all done */
+    void ViewPatternEditor::abortProviderRuns() {
+        for (auto &result : this->m_providerResults) {
+            if (result.runtime != nullptr)
+                result.runtime->abort();
+        }
+    }
+
+    void ViewPatternEditor::drawProviderResults() {
+        if (this->m_abortRunOnAllProviders && this->m_runningOnAllProviders) {
+            std::scoped_lock lock(this->m_providerResultsMutex);
+            this->abortProviderRuns();
+        }
+
+        if (!this->m_providerResultsOpen)
+            return;
+
+        if (ImGui::Begin(View::toWindowName("hex.view.pattern.all_providers.name").c_str(), &this->m_providerResultsOpen, ImGuiWindowFlags_NoCollapse)) {
+            std::scoped_lock lock(this->m_providerResultsMutex);
+
+            if (this->m_runningOnAllProviders) {
+                ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(ImColor(0xC0, 0x20, 0x20)));
+                ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 1);
+
+                if (ImGui::Button("hex.view.pattern.abort"_lang)) {
+                    this->m_abortRunOnAllProviders = true;
+                    this->abortProviderRuns();
+                }
+
+                ImGui::PopStyleVar();
+                ImGui::PopStyleColor();
+
+                const auto doneCount = std::count_if(this->m_providerResults.begin(), this->m_providerResults.end(), [](const auto &result) { return result.done; });
+
+                ImGui::SameLine();
+                ImGui::TextSpinner(hex::format("{} {} / {}", static_cast<const char *>("hex.view.pattern.evaluating"_lang), doneCount, this->m_providerResults.size()).c_str());
+            }
+
+            if (ImGui::BeginTable("##provider_results", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+                ImGui::TableSetupScrollFreeze(0, 1);
+                ImGui::TableSetupColumn("hex.view.pattern.all_providers.file"_lang);
+                ImGui::TableSetupColumn("hex.view.pattern.all_providers.result"_lang);
+                ImGui::TableSetupColumn("hex.view.pattern.all_providers.patterns"_lang);
+                ImGui::TableSetupColumn("hex.view.pattern.all_providers.message"_lang);
+                ImGui::TableHeadersRow();
+
+                const auto &providers = ImHexApi::Provider::getProviders();
+
+                for (u64 i = 0; i < this->m_providerResults.size(); i++) {
+                    const auto &result = this->m_providerResults[i];
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+
+                    // Selecting a result switches to its file, as long as it's still open
+                    ImGui::PushID(i);
+                    if (ImGui::Selectable(result.name.c_str(), false, ImGuiSelectableFlags_SpanAllColumns)) {
+                        if (auto provider = std::find(providers.begin(), providers.end(), result.provider); provider != providers.end())
+                            SharedData::currentProvider = std::distance(providers.begin(), provider);
+                    }
+                    ImGui::PopID();
+
+                    ImGui::TableNextColumn();
+                    if (!result.done)
+                        ImGui::TextUnformatted("hex.view.pattern.all_providers.pending"_lang);
+                    else if (result.success)
+                        ImGui::TextColored(ImColor(0xFF20C020), "%s", static_cast<const char *>("hex.view.pattern.all_providers.success"_lang));
+                    else
+                        ImGui::TextColored(ImColor(0xFF2020C0), "%s", static_cast<const char *>("hex.view.pattern.all_providers.error"_lang));
+
+                    ImGui::TableNextColumn();
+                    if (result.success)
+                        ImGui::TextUnformatted(hex::format("{}", result.patternCount).c_str());
+
+                    ImGui::TableNextColumn();
+                    if (result.error.has_value()) {
+                        if (result.error->first != 0)
+                            ImGui::Text("%u: %s", result.error->first, result.error->second.c_str());
+                        else
+                            ImGui::TextUnformatted(result.error->second.c_str());
+                    } else if (result.warning.has_value())
+                        ImGui::TextUnformatted(result.warning->c_str());
+                }
+
+                ImGui::EndTable();
+            }
+        }
+        ImGui::End();
+    }
+
 }
\ No newline at end of file
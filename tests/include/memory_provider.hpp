@@ -0,0 +1,57 @@
+#pragma once
+
+#include <hex/providers/provider.hpp>
+
+#include <cstring>
+#include <vector>
+
+namespace hex::test {
+    using namespace hex::prv;
+
+    /* Keeps all of its data in memory so reading generated inputs costs nothing but a copy */
+    class MemoryProvider : public prv::Provider {
+    public:
+        explicit MemoryProvider(std::vector<u8> data) : Provider(), m_data(std::move(data)) { }
+        ~MemoryProvider() override = default;
+
+        [[nodiscard]] bool isAvailable() const override { return true; }
+        [[nodiscard]] bool isReadable() const override { return true; }
+        [[nodiscard]] bool isWritable() const override { return true; }
+        [[nodiscard]] bool isResizable() const override { return false; }
+        [[nodiscard]] bool isSavable() const override { return false; }
+
+        [[nodiscard]] std::string getName() const override {
+            return "";
+        }
+
+        [[nodiscard]] std::vector<std::pair<std::string, std::string>> getDataInformation() const override {
+            return { };
+        }
+
+        void readRaw(u64 offset, void *buffer, size_t size) override {
+            offset -= this->getBaseAddress();
+
+            if (offset > this->m_data.size() || size > this->m_data.size() - offset || buffer == nullptr || size == 0)
+                return;
+
+            std::memcpy(buffer, this->m_data.data() + offset, size);
+        }
+
+        void writeRaw(u64 offset, const void *buffer, size_t size) override {
+            offset -= this->getBaseAddress();
+
+            if (offset > this->m_data.size() || size > this->m_data.size() - offset || buffer == nullptr || size == 0)
+                return;
+
+            std::memcpy(this->m_data.data() + offset, buffer, size);
+        }
+
+        size_t getActualSize() const override {
+            return this->m_data.size();
+        }
+
+    private:
+        std::vector<u8> m_data;
+    };
+
+}
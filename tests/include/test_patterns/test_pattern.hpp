@@ -45,6 +45,12 @@ namespace hex::test {
             this->m_patterns.push_back(pattern);
         }
 
+        /* Additional checks on the patterns produced by the source code, after they've been compared against the expected ones */
+        [[nodiscard]]
+        virtual bool checkPatterns(prv::Provider *provider, const std::vector<PatternData*> &patterns) const {
+            return true;
+        }
+
         [[nodiscard]]
         auto failing() {
             this->m_mode = Mode::Failing;
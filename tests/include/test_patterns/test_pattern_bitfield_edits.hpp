@@ -0,0 +1,81 @@
+#pragma once
+
+#include "test_pattern.hpp"
+#include "memory_provider.hpp"
+
+namespace hex::test {
+
+    class TestPatternBitfieldEdits : public TestPattern {
+    public:
+        TestPatternBitfieldEdits() : TestPattern("BitfieldEdits")  {
+            auto testBitfields = create<PatternDataStaticArray>("TestBitfield", "testBitfields", 0x12, 2 * (4 * 4) / 8);
+            testBitfields->setEndian(std::endian::big);
+
+            auto testBitfield = create<PatternDataBitfield>("TestBitfield", "", 0x12, (4 * 4) / 8);
+            testBitfield->setEndian(std::endian::big);
+            testBitfield->setFields({
+                    create<PatternDataBitfieldField>("", "a", 0x12, 0, 4),
+                    create<PatternDataBitfieldField>("", "b", 0x12, 4, 4),
+                    create<PatternDataBitfieldField>("", "c", 0x12, 8, 4),
+                    create<PatternDataBitfieldField>("", "d", 0x12, 12, 4)
+            });
+
+            testBitfields->setEntries(testBitfield, 2);
+
+            addPattern(testBitfields);
+        }
+        ~TestPatternBitfieldEdits() override = default;
+
+        [[nodiscard]]
+        std::string getSourceCode() const override {
+            return R"(
+                bitfield TestBitfield {
+                    a : 4;
+                    b : 4;
+                    c : 4;
+                    d : 4;
+                };
+
+                be TestBitfield testBitfields[2] @ 0x12;
+            )";
+        }
+
+        [[nodiscard]]
+        bool checkPatterns(prv::Provider *provider, const std::vector<PatternData*> &patterns) const override {
+            // The test data is shared between all tests so the edits are done on a copy of it
+            std::vector<u8> data(provider->getActualSize());
+            provider->read(0x00, data.data(), data.size());
+            MemoryProvider editedProvider(std::move(data));
+
+            // Entries after the first one are moved copies of the first one, their fields still have its offset
+            auto testBitfields = static_cast<PatternDataStaticArray*>(patterns.front());
+            for (u64 entry = 0; entry < testBitfields->getEntryCount(); entry++) {
+                const u64 offset = testBitfields->getOffset() + entry * sizeof(u16);
+
+                auto &fields = static_cast<PatternDataBitfield*>(testBitfields->getChild(entry))->getFields();
+                auto getValue = [&](u32 field) {
+                    return static_cast<PatternDataBitfieldField*>(fields[field])->getValueString(&editedProvider);
+                };
+
+                // Cache the current values first
+                for (u32 field = 0; field < fields.size(); field++)
+                    (void)getValue(field);
+
+                // Edits on the last and on the first byte of the bitfield both have to show up in the values of its fields
+                const u8 lastByte = 0x75;
+                editedProvider.write(offset + 1, &lastByte, sizeof(lastByte));
+                if (getValue(2) != "5 (0x5)" || getValue(3) != "7 (0x7)")
+                    return false;
+
+                const u8 firstByte = 0x0B;
+                editedProvider.write(offset, &firstByte, sizeof(firstByte));
+                if (getValue(0) != "11 (0xB)" || getValue(1) != "0 (0x0)")
+                    return false;
+            }
+
+            return true;
+        }
+
+    };
+
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "test_pattern.hpp"
+
+#include <map>
+
+namespace hex::test {
+
+    class TestPatternDynamicArrayHighlights : public TestPattern {
+    public:
+        TestPatternDynamicArrayHighlights() : TestPattern("DynamicArrayHighlights")  {
+
+        }
+        ~TestPatternDynamicArrayHighlights() override = default;
+
+        [[nodiscard]]
+        std::string getSourceCode() const override {
+            return R"(
+                struct Record {
+                    u8 length;
+                    u8 data[length & 0x03];
+                };
+
+                struct Block {
+                    u8 tag;
+                    Record records[tag & 0x03];
+                };
+
+                Record records[4] @ 0x24;
+                Block blocks[4] @ 0x30;
+            )";
+        }
+
+        [[nodiscard]]
+        bool checkPatterns(prv::Provider *provider, const std::vector<PatternData*> &patterns) const override {
+            // Highlighted bytes and their colors. Where ranges overlap the earlier one wins
+            auto getColors = [](const std::vector<HighlightedRange> &ranges) {
+                std::map<u64, u32> colors;
+                for (const auto &range : ranges) {
+                    for (u64 address = range.start; address < range.end; address++)
+                        colors.emplace(address, range.color);
+                }
+
+                return colors;
+            };
+
+            for (auto &pattern : patterns) {
+                auto array = dynamic_cast<PatternDataDynamicArray*>(pattern);
+                if (array == nullptr || !array->isLazy() || array->getEntryCount() != 4)
+                    return false;
+
+                // The ranges kept while evaluating the array have to be the ones its entries highlight once they're decoded
+                std::vector<HighlightedRange> entryRanges;
+                for (u64 i = 0; i < array->getEntryCount(); i++) {
+                    auto entry = array->getEntry(i);
+                    if (entry == nullptr)
+                        return false;
+
+                    auto ranges = entry->getHighlightedRanges();
+                    entryRanges.insert(entryRanges.end(), ranges.begin(), ranges.end());
+                }
+
+                auto colors = getColors(array->getHighlightedRanges());
+                if (colors.empty() || colors != getColors(entryRanges))
+                    return false;
+            }
+
+            return true;
+        }
+
+    };
+
+}
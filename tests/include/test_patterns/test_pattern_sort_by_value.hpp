@@ -0,0 +1,51 @@
+#pragma once
+
+#include "test_pattern.hpp"
+
+namespace hex::test {
+
+    class TestPatternSortByValue : public TestPattern {
+    public:
+        TestPatternSortByValue() : TestPattern("SortByValue") {
+            auto first = create<PatternDataUnsigned>("u16", "first", 0x12, sizeof(u16));
+            first->setEndian(std::endian::little);
+            auto second = create<PatternDataUnsigned>("u16", "second", 0x1C, sizeof(u16));
+            second->setEndian(std::endian::little);
+            auto third = create<PatternDataUnsigned>("u16", "third", 0x16, sizeof(u16));
+            third->setEndian(std::endian::little);
+            auto fourth = create<PatternDataUnsigned>("u32", "fourth", 0x10, sizeof(u32));
+            fourth->setEndian(std::endian::big);
+
+            addPattern(first);
+            addPattern(second);
+            addPattern(third);
+            addPattern(fourth);
+        }
+        ~TestPatternSortByValue() override = default;
+
+        [[nodiscard]]
+        std::string getSourceCode() const override {
+            return R"(
+                le u16 first @ 0x12;
+                le u16 second @ 0x1C;
+                le u16 third @ 0x16;
+                be u32 fourth @ 0x10;
+            )";
+        }
+
+        [[nodiscard]]
+        bool checkPatterns(prv::Provider *provider, const std::vector<PatternData*> &patterns) const override {
+            // The bytes of the little endian values sort the other way around than the values themselves
+            auto sortedPatterns = patterns;
+            PatternData::sortPatternsByValue(provider, sortedPatterns, false);
+
+            std::vector<std::string> names;
+            for (auto &pattern : sortedPatterns)
+                names.push_back(pattern->getVariableName());
+
+            return names == std::vector<std::string>{ "third", "first", "second", "fourth" };
+        }
+
+    };
+
+}
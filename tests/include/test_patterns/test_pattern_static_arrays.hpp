@@ -0,0 +1,39 @@
+#pragma once
+
+#include "test_pattern.hpp"
+
+namespace hex::test {
+
+    class TestPatternStaticArrays : public TestPattern {
+    public:
+        TestPatternStaticArrays() : TestPattern("StaticArrays")  {
+            auto array = create<PatternDataStaticArray>("Entry", "entries", 0x10, 4 * (sizeof(u16) + sizeof(u8) + 1));
+
+            auto entry = create<PatternDataStruct>("Entry", "", 0x10, sizeof(u16) + sizeof(u8) + 1);
+            auto id = create<PatternDataUnsigned>("u16", "id", 0x10, sizeof(u16));
+            auto flags = create<PatternDataUnsigned>("u8", "flags", 0x10 + sizeof(u16), sizeof(u8));
+            auto padding = create<PatternDataPadding>("padding", "", 0x10 + sizeof(u16) + sizeof(u8), 1);
+            entry->setMembers({ id, flags, padding });
+
+            array->setEntries(entry, 4);
+
+            addPattern(array);
+        }
+        ~TestPatternStaticArrays() override = default;
+
+        [[nodiscard]]
+        std::string getSourceCode() const override {
+            return R"(
+                struct Entry {
+                    u16 id;
+                    u8 flags;
+                    padding[1];
+                };
+
+                Entry entries[4] @ 0x10;
+            )";
+        }
+
+    };
+
+}
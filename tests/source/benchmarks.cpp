@@ -0,0 +1,588 @@
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <map>
+#include <new>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+
+#include <hex/helpers/utils.hpp>
+#include <hex/helpers/logger.hpp>
+#include <hex/helpers/fmt.hpp>
+#include <hex/helpers/file.hpp>
+#include <hex/pattern_language/preprocessor.hpp>
+#include <hex/pattern_language/lexer.hpp>
+#include <hex/pattern_language/parser.hpp>
+#include <hex/pattern_language/pattern_language.hpp>
+#include <hex/pattern_language/pattern_data.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include "memory_provider.hpp"
+
+// Set by the build to the baseline committed next to the benchmarks
+#if !defined(IMHEX_BENCHMARK_BASELINE_PATH)
+    #define IMHEX_BENCHMARK_BASELINE_PATH ""
+#endif
+
+using namespace hex::pl;
+using namespace hex::test;
+
+namespace {
+
+    /* Every allocation made through operator new is counted. The size is stored in front of it so memory in use can be tracked as well */
+    struct alignas(alignof(std::max_align_t)) AllocationHeader {
+        size_t size;
+    };
+
+    std::atomic<u64> allocationCount = 0;
+    std::atomic<u64> allocatedBytes = 0;
+    std::atomic<u64> peakAllocatedBytes = 0;
+
+}
+
+void* operator new(size_t size) {
+    auto header = static_cast<AllocationHeader*>(std::malloc(sizeof(AllocationHeader) + size));
+    if (header == nullptr)
+        throw std::bad_alloc();
+
+    header->size = size;
+
+    allocationCount++;
+    const auto currentBytes = allocatedBytes += size;
+    auto peakBytes = peakAllocatedBytes.load();
+    while (currentBytes > peakBytes && !peakAllocatedBytes.compare_exchange_weak(peakBytes, currentBytes));
+
+    return header + 1;
+}
+
+void operator delete(void *pointer) noexcept {
+    if (pointer == nullptr)
+        return;
+
+    auto header = static_cast<AllocationHeader*>(pointer) - 1;
+    allocatedBytes -= header->size;
+
+    std::free(header);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+namespace {
+
+    constexpr static size_t DefaultDataSize = 256;
+    constexpr static double DefaultThreshold = 25;
+
+    struct Measurement {
+        double time;
+        u64 allocations;
+        u64 peakMemory;
+    };
+
+    using Results = std::vector<std::pair<std::string, Measurement>>;
+
+    /* Takes the time of the fastest run since slower ones are mostly noise from the rest of the system. Allocations are averaged over all runs */
+    /* and peak memory is how much more memory was in use at most than before the first run. Whatever reset does between runs isn't measured */
+    template<typename F>
+    Measurement measure(u32 runs, F function, const std::function<void()> &reset = nullptr) {
+        const auto allocationsBefore = allocationCount.load();
+        const auto bytesBefore = allocatedBytes.load();
+        peakAllocatedBytes = bytesBefore;
+
+        u64 resetAllocations = 0;
+        double fastestTime = std::numeric_limits<double>::max();
+        for (u32 i = 0; i < runs; i++) {
+            if (i != 0 && reset) {
+                const auto allocations = allocationCount.load();
+                reset();
+                resetAllocations += allocationCount - allocations;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            function();
+            auto end = std::chrono::steady_clock::now();
+
+            fastestTime = std::min(fastestTime, std::chrono::duration<double>(end - start).count());
+        }
+
+        return {
+            fastestTime,
+            (allocationCount - allocationsBefore - resetAllocations) / runs,
+            peakAllocatedBytes - bytesBefore
+        };
+    }
+
+    /* Size of the generated inputs in MiB. Defaults to 256 and can be changed through IMHEX_BENCHMARK_DATA_SIZE */
+    size_t getDataSize() {
+        if (auto value = std::getenv("IMHEX_BENCHMARK_DATA_SIZE"); value != nullptr && std::strtoull(value, nullptr, 0) != 0)
+            return std::strtoull(value, nullptr, 0) * 1024 * 1024;
+        else
+            return DefaultDataSize * 1024 * 1024;
+    }
+
+    /* Random but reproducible data */
+    std::vector<u8> generateData(size_t size, u64 seed) {
+        std::vector<u8> data(size);
+
+        u64 state = seed;
+        for (size_t i = 0; i < size; i += sizeof(u64)) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+
+            std::memcpy(data.data() + i, &state, std::min(sizeof(u64), size - i));
+        }
+
+        return data;
+    }
+
+    void printResults(const Results &results) {
+        for (const auto &[phase, measurement] : results)
+            hex::log::info("{:<12} {:>10.2f} ms {:>12} allocations {:>12} peak", phase, measurement.time * 1000, measurement.allocations, hex::toByteString(measurement.peakMemory));
+    }
+
+    /* Compares the results against the baseline file and fails if any of them got worse by more than the thresholds in it. That's the */
+    /* one committed next to the tests unless IMHEX_BENCHMARK_BASELINE points to another one, an empty path skips the comparison.      */
+    /* IMHEX_BENCHMARK_THRESHOLD overrides all thresholds with one percentage. IMHEX_BENCHMARK_RECORD names a file the results get     */
+    /* added to so they can be used as baseline later                                                                                  */
+    bool checkResults(const std::string &benchmark, const Results &results) {
+        auto readJSON = [](const std::string &path) {
+            if (!std::filesystem::is_regular_file(path))
+                return nlohmann::json::object();
+
+            auto json = nlohmann::json::parse(hex::File(path, hex::File::Mode::Read).readString(), nullptr, false);
+            return json.is_object() ? json : nlohmann::json::object();
+        };
+
+        // Results only compare to ones taken on inputs of the same size
+        const u64 dataSize = getDataSize();
+
+        bool success = true;
+
+        std::string baselinePath = IMHEX_BENCHMARK_BASELINE_PATH;
+        if (auto value = std::getenv("IMHEX_BENCHMARK_BASELINE"); value != nullptr)
+            baselinePath = value;
+
+        if (!baselinePath.empty()) {
+            auto baseline = readJSON(baselinePath);
+            const auto &expectedResults = baseline.value("benchmarks", nlohmann::json::object());
+            const auto &thresholds = baseline.value("thresholds", nlohmann::json::object());
+
+            auto getFactor = [&](const std::string &measurement) {
+                double threshold = thresholds.value(measurement, DefaultThreshold);
+                if (auto value = std::getenv("IMHEX_BENCHMARK_THRESHOLD"); value != nullptr)
+                    threshold = std::strtod(value, nullptr);
+
+                return 1 + threshold / 100;
+            };
+
+            const auto timeFactor = getFactor("time"), allocationFactor = getFactor("allocations"), peakMemoryFactor = getFactor("peak_memory");
+
+            if (!expectedResults.contains(benchmark))
+                hex::log::warn("No baseline for {} found in {}", benchmark, baselinePath);
+            else if (expectedResults[benchmark].value("data_size", u64(0)) != dataSize)
+                hex::log::warn("Baseline for {} was taken with {} of data, not comparing against it", benchmark, hex::toByteString(expectedResults[benchmark].value("data_size", u64(0))));
+            else {
+                const auto &expectedPhases = expectedResults[benchmark].value("phases", nlohmann::json::object());
+
+                for (const auto &[phase, measurement] : results) {
+                    if (!expectedPhases.contains(phase))
+                        continue;
+
+                    const auto &expected = expectedPhases[phase];
+                    const auto time = expected.value("time", 0.0);
+                    const auto allocations = expected.value("allocations", u64(0));
+                    const auto peakMemory = expected.value("peak_memory", u64(0));
+
+                    // Very short phases and small amounts of memory vary too much between runs to be compared on their own
+                    if (measurement.time > time * timeFactor && measurement.time - time > 0.001) {
+                        hex::log::error("{}: time regressed from {:.2f} ms to {:.2f} ms", phase, time * 1000, measurement.time * 1000);
+                        success = false;
+                    }
+
+                    if (measurement.allocations > allocations * allocationFactor) {
+                        hex::log::error("{}: allocations regressed from {} to {}", phase, allocations, measurement.allocations);
+                        success = false;
+                    }
+
+                    if (measurement.peakMemory > peakMemory * peakMemoryFactor && measurement.peakMemory - peakMemory > 0x1'0000) {
+                        hex::log::error("{}: peak memory regressed from {} to {}", phase, hex::toByteString(peakMemory), hex::toByteString(measurement.peakMemory));
+                        success = false;
+                    }
+                }
+            }
+        }
+
+        if (auto recordPath = std::getenv("IMHEX_BENCHMARK_RECORD"); recordPath != nullptr) {
+            auto record = readJSON(recordPath);
+
+            auto &recordedResult = record["benchmarks"][benchmark];
+            recordedResult = { { "data_size", dataSize } };
+            for (const auto &[phase, measurement] : results)
+                recordedResult["phases"][phase] = { { "time", measurement.time }, { "allocations", measurement.allocations }, { "peak_memory", measurement.peakMemory } };
+
+            hex::File(recordPath, hex::File::Mode::Create).write(record.dump(4));
+        }
+
+        return success;
+    }
+
+    /* Large generated pattern with a bit of everything the lexer has to handle. Every line is different so no line can be reused */
+    std::string generatePattern(u32 typeCount) {
+        std::string code;
+
+        for (u32 i = 0; i < typeCount; i++) {
+            code += hex::format("struct Type{0} {{\n", i);
+            code += hex::format("    u32 magic{0} [[color(\"FF00{0:02X}\")]];\n", i & 0xFF);
+            code += hex::format("    be u16 values{0}[0x{0:X} & 0x0F];\n", i);
+            code += hex::format("    if (magic{0} == 'A' || magic{0} >= {0}) char name{0}[4]; else padding[{0} % 8];\n", i & 0xFF);
+            code += hex::format("    float scale{0}; if (scale{0} > {0}.5) u8 flag{0};\n", i);
+            code += "};\n";
+            code += hex::format("Type{0} type{0} @ 0x{1:X};\n", i, i * 0x10);
+        }
+
+        return code;
+    }
+
+    bool compareTokens(const std::vector<Token> &left, const std::vector<Token> &right) {
+        if (left.size() != right.size())
+            return false;
+
+        for (size_t i = 0; i < left.size(); i++) {
+            if (left[i].type != right[i].type || left[i].lineNumber != right[i].lineNumber || left[i].value != right[i].value)
+                return false;
+        }
+
+        return true;
+    }
+
+    /* Lexes and parses the code and returns how long that took on average */
+    std::optional<Results> measureFrontend(const std::string &source, u32 runs) {
+        // Pragmas are only handled by the runtime, here they just need to be removed from the code
+        Preprocessor preprocessor;
+        for (const auto &pragma : { "eval_depth", "array_limit" })
+            preprocessor.addPragmaHandler(pragma, [](const std::string&) { return true; });
+
+        auto preprocessedCode = preprocessor.preprocess(source);
+        if (!preprocessedCode.has_value()) {
+            hex::log::fatal("Preprocessing pattern failed: {}", preprocessor.getError().second);
+            return std::nullopt;
+        }
+
+        const auto &code = *preprocessedCode;
+
+        Lexer lexer;
+        auto tokens = lexer.lex(code);
+        if (!tokens.has_value()) {
+            hex::log::fatal("Lexing pattern failed: {}", lexer.getError().second);
+            return std::nullopt;
+        }
+
+        Parser parser;
+        if (auto ast = parser.parse(*tokens); ast.has_value()) {
+            for (auto &node : *ast)
+                delete node;
+        } else {
+            hex::log::fatal("Parsing pattern failed: {}", parser.getError().second);
+            return std::nullopt;
+        }
+
+        // Every run gets a new lexer so lines lexed in an earlier run can't be reused
+        auto lexTime = measure(runs, [&] {
+            Lexer lexer;
+            (void)lexer.lex(code);
+        });
+
+        auto parseTime = measure(runs, [&] {
+            Parser parser;
+            for (auto &node : parser.parse(*tokens).value())
+                delete node;
+        });
+
+        return Results{ { "lex", lexTime }, { "parse", parseTime } };
+    }
+
+    /* Evaluates the pattern on the data and builds the highlighted ranges of everything it produced */
+    int benchmarkPattern(const std::string &name, const std::string &code, std::vector<u8> data, const std::function<bool(const std::vector<PatternData*>&)> &check) {
+        constexpr static u32 FrontendRuns = 100;
+        constexpr static u32 EvaluateRuns = 3;
+
+        auto results = measureFrontend(code, FrontendRuns);
+        if (!results.has_value())
+            return EXIT_FAILURE;
+
+        const auto dataSize = data.size();
+        MemoryProvider provider(std::move(data));
+        PatternLanguage runtime;
+
+        std::optional<std::vector<PatternData*>> patterns;
+        auto deletePatterns = [&] {
+            for (auto &pattern : patterns.value_or(std::vector<PatternData*>{ }))
+                delete pattern;
+
+            patterns.reset();
+        };
+
+        results->emplace_back("evaluate", measure(EvaluateRuns, [&] {
+            patterns = runtime.executeString(&provider, code);
+        }, deletePatterns));
+
+        if (!patterns.has_value()) {
+            if (auto error = runtime.getError(); error.has_value())
+                hex::log::fatal("Evaluating pattern failed: {} : {}", error->first, error->second);
+            else
+                hex::log::fatal("Evaluating pattern failed");
+
+            return EXIT_FAILURE;
+        }
+
+        ON_SCOPE_EXIT { deletePatterns(); };
+
+        u64 rangeCount = 0;
+        results->emplace_back("highlight", measure(EvaluateRuns, [&] {
+            rangeCount = 0;
+            for (auto &pattern : *patterns)
+                rangeCount += pattern->getHighlightedRanges().size();
+        }));
+
+        if (!check(*patterns)) {
+            hex::log::fatal("Pattern produced unexpected results");
+            return EXIT_FAILURE;
+        }
+
+        hex::log::info("Evaluated {} of data into {} highlighted ranges", hex::toByteString(dataSize), rangeCount);
+        printResults(*results);
+
+        return checkResults(name, *results) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    template<typename T>
+    T* getPattern(const std::vector<PatternData*> &patterns, const std::string &name) {
+        for (auto &pattern : patterns) {
+            if (pattern->getVariableName() == name)
+                return dynamic_cast<T*>(pattern);
+        }
+
+        return nullptr;
+    }
+
+    int lexerThroughput(const std::string &name) {
+        constexpr static u32 Runs = 10;
+
+        auto code = generatePattern(10'000);
+        const double megabytes = code.size() / double(1024 * 1024);
+
+        // Every run gets a new lexer so nothing carries over from the previous one
+        auto coldTime = measure(Runs, [&] {
+            Lexer lexer;
+            (void)lexer.lex(code);
+        });
+
+        // Lexing the same code again reuses every line from the last run
+        Lexer lexer;
+        auto coldTokens = lexer.lex(code).value_or(std::vector<Token>{ });
+
+        std::vector<Token> cachedTokens;
+        auto cachedTime = measure(Runs, [&] {
+            cachedTokens = lexer.lex(code).value_or(std::vector<Token>{ });
+        });
+
+        if (coldTokens.empty()) {
+            hex::log::fatal("Lexing generated pattern failed: {}", lexer.getError().second);
+            return EXIT_FAILURE;
+        }
+
+        if (!compareTokens(coldTokens, cachedTokens)) {
+            hex::log::fatal("Tokens of cached lines differ from freshly lexed ones");
+            return EXIT_FAILURE;
+        }
+
+        hex::log::info("Lexed {:.2f} MiB into {} tokens", megabytes, coldTokens.size());
+        hex::log::info("Uncached: {:.2f} ms, {:.2f} MiB/s", coldTime.time * 1000, megabytes / coldTime.time);
+        hex::log::info("Cached:   {:.2f} ms, {:.2f} MiB/s", cachedTime.time * 1000, megabytes / cachedTime.time);
+
+        return checkResults(name, { { "uncached", coldTime }, { "cached", cachedTime } }) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    int parserThroughput(const std::string &name) {
+        constexpr static u32 Runs = 5;
+
+        auto code = generatePattern(10'000);
+
+        auto results = measureFrontend(code, Runs);
+        if (!results.has_value())
+            return EXIT_FAILURE;
+
+        hex::log::info("Parsed {:.2f} MiB of code", code.size() / double(1024 * 1024));
+        printResults(*results);
+
+        return checkResults(name, *results) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    int staticArrayThroughput(const std::string &name) {
+        const auto dataSize = getDataSize();
+
+        // Structs get a highlighted range per member and entry so they only cover part of the data
+        const u64 entryCount = dataSize / 64 / 12;
+        const u64 wordCount = dataSize / 4;
+
+        auto code = hex::format(
+            "struct Entry {{ u32 id; u16 flags; u8 kind; u8 level; float value; }};\n"
+            "Entry entries[{}] @ 0x00;\n"
+            "u32 words[{}] @ 0x00;\n"
+            "be u16 halves[{}] @ 0x00;\n",
+            entryCount, wordCount, wordCount * 2);
+
+        return benchmarkPattern(name, code, generateData(dataSize, 1), [&](const auto &patterns) {
+            auto entries = getPattern<PatternDataStaticArray>(patterns, "entries");
+            auto words = getPattern<PatternDataStaticArray>(patterns, "words");
+            auto halves = getPattern<PatternDataStaticArray>(patterns, "halves");
+
+            return entries != nullptr && entries->getEntryCount() == entryCount && entries->getSize() == entryCount * 12 &&
+                   words != nullptr && words->getEntryCount() == wordCount && words->getSize() == dataSize &&
+                   halves != nullptr && halves->getSize() == dataSize;
+        });
+    }
+
+    int dynamicArrayThroughput(const std::string &name) {
+        const auto dataSize = getDataSize();
+        const auto regionSize = dataSize / 16;
+
+        // Lay out records whose size depends on their first byte so the array has to be walked entry by entry
+        auto data = generateData(dataSize, 2);
+        u64 recordCount = 0, offset = 0;
+        while (true) {
+            const u64 length = data[offset] & 0x1F;
+            if (offset + 1 + length > regionSize)
+                break;
+
+            offset += 1 + length;
+            recordCount++;
+        }
+
+        auto code = hex::format(
+            "#pragma array_limit {}\n"
+            "struct Record {{ u8 length; u8 data[length & 0x1F]; }};\n"
+            "Record records[{}] @ 0x00;\n",
+            recordCount + 1, recordCount);
+
+        return benchmarkPattern(name, code, std::move(data), [&](const auto &patterns) {
+            auto records = getPattern<PatternDataDynamicArray>(patterns, "records");
+
+            return records != nullptr && records->getEntryCount() == recordCount && records->getSize() == offset;
+        });
+    }
+
+    int nestedStructThroughput(const std::string &name) {
+        constexpr static u32 Depth = 48;
+
+        const auto dataSize = getDataSize();
+        const auto regionSize = dataSize / 256;
+
+        // Every level wraps the one below it. The innermost one has an optional member so none of them have a static layout
+        std::string code = hex::format("#pragma eval_depth {}\n", Depth * 2);
+        code += "struct Level0 { u8 tag; if (tag & 1) u8 extra; };\n";
+        for (u32 i = 1; i <= Depth; i++)
+            code += hex::format("struct Level{0} {{ u8 tag; Level{1} child; u16 tail; }};\n", i, i - 1);
+
+        auto data = generateData(dataSize, 3);
+        u64 itemCount = 0, offset = 0;
+        while (true) {
+            const u64 itemSize = Depth * 3 + 1 + (data[offset + Depth] & 1);
+            if (offset + itemSize > regionSize)
+                break;
+
+            offset += itemSize;
+            itemCount++;
+        }
+
+        code += hex::format("Level{} items[{}] @ 0x00;\n", Depth, itemCount);
+
+        return benchmarkPattern(name, code, std::move(data), [&](const auto &patterns) {
+            auto items = getPattern<PatternDataDynamicArray>(patterns, "items");
+
+            return items != nullptr && items->getEntryCount() == itemCount && items->getSize() == offset;
+        });
+    }
+
+    int bitfieldThroughput(const std::string &name) {
+        const auto dataSize = getDataSize();
+        const auto regionSize = dataSize / 32;
+
+        auto code = hex::format(
+            "#pragma array_limit {0}\n"
+            "bitfield Flags {{ length : 4; kind : 3; last : 1; extra : 8; }};\n"
+            "struct Packet {{ Flags flags; u8 payload[flags.length]; }};\n"
+            "Packet packets[while($ < {0})] @ 0x00;\n",
+            regionSize);
+
+        return benchmarkPattern(name, code, generateData(dataSize, 4), [&](const auto &patterns) {
+            auto packets = getPattern<PatternDataDynamicArray>(patterns, "packets");
+
+            // The last packet may end past the region
+            return packets != nullptr && packets->getEntryCount() > 0 && packets->getSize() >= regionSize && packets->getSize() < regionSize + 2 + 16;
+        });
+    }
+
+    int conditionalThroughput(const std::string &name) {
+        const auto dataSize = getDataSize();
+        const auto regionSize = dataSize / 16;
+
+        auto code = hex::format(
+            "#pragma array_limit {0}\n"
+            "struct Chunk {{\n"
+            "    u8 type;\n"
+            "    if (type & 0x80) {{ u16 value; }}\n"
+            "    else if (type & 0x40) {{ u32 values[type & 0x07]; }}\n"
+            "    else {{ u8 data[type & 0x1F]; }}\n"
+            "}};\n"
+            "Chunk chunks[while($ < {0})] @ 0x00;\n",
+            regionSize);
+
+        return benchmarkPattern(name, code, generateData(dataSize, 5), [&](const auto &patterns) {
+            auto chunks = getPattern<PatternDataDynamicArray>(patterns, "chunks");
+
+            return chunks != nullptr && chunks->getEntryCount() > 0 && chunks->getSize() >= regionSize && chunks->getSize() < regionSize + 1 + 7 * 4;
+        });
+    }
+
+}
+
+int main(int argc, char **argv) {
+    const std::map<std::string, std::function<int(const std::string&)>> benchmarks = {
+        { "LexerThroughput",            lexerThroughput             },
+        { "ParserThroughput",           parserThroughput            },
+        { "StaticArrayThroughput",      staticArrayThroughput       },
+        { "DynamicArrayThroughput",     dynamicArrayThroughput      },
+        { "NestedStructThroughput",     nestedStructThroughput      },
+        { "BitfieldThroughput",         bitfieldThroughput          },
+        { "ConditionalThroughput",      conditionalThroughput       }
+    };
+
+    // Check if a benchmark to run has been provided
+    if (argc != 2) {
+        hex::log::fatal("Invalid number of arguments specified! {}", argc);
+        return EXIT_FAILURE;
+    }
+
+    // Check if that benchmark exists
+    auto benchmark = benchmarks.find(argv[1]);
+    if (benchmark == benchmarks.end()) {
+        hex::log::fatal("No benchmark with name {} found!", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    auto result = benchmark->second(benchmark->first);
+
+    if (result == EXIT_SUCCESS)
+        hex::log::info("Success!");
+    else
+        hex::log::info("Failed!");
+
+    return result;
+}
@@ -102,6 +102,12 @@ int test(int argc, char **argv) {
         }
     }
 
+    // Check anything else the test wants to know about the produced patterns
+    if (!currTest->checkPatterns(provider, *patterns)) {
+        hex::log::fatal("Patterns didn't pass the checks of the test");
+        return EXIT_FAILURE;
+    }
+
     return EXIT_SUCCESS;
 }
 
@@ -9,10 +9,14 @@
 #include "test_patterns/test_pattern_succeeding_assert.hpp"
 #include "test_patterns/test_pattern_failing_assert.hpp"
 #include "test_patterns/test_pattern_bitfields.hpp"
+#include "test_patterns/test_pattern_bitfield_edits.hpp"
 #include "test_patterns/test_pattern_math.hpp"
 #include "test_patterns/test_pattern_rvalues.hpp"
 #include "test_patterns/test_pattern_namespaces.hpp"
 #include "test_patterns/test_pattern_extra_semicolon.hpp"
+#include "test_patterns/test_pattern_static_arrays.hpp"
+#include "test_patterns/test_pattern_sort_by_value.hpp"
+#include "test_patterns/test_pattern_dynamic_array_highlights.hpp"
 
 std::array Tests = {
         TEST(Placement),
@@ -24,8 +28,12 @@ std::array Tests = {
         TEST(SucceedingAssert),
         TEST(FailingAssert),
         TEST(Bitfields),
+        TEST(BitfieldEdits),
         TEST(Math),
         TEST(RValues),
         TEST(Namespaces),
-        TEST(ExtraSemicolon)
+        TEST(ExtraSemicolon),
+        TEST(StaticArrays),
+        TEST(SortByValue),
+        TEST(DynamicArrayHighlights)
 };
\ No newline at end of file